@@ -33,6 +33,9 @@ enum class RelationTag {
     BRIE,         // use brie data-structure
     BTREE,        // use btree data-structure
     EQREL,        // use union data-structure
+    HASHSET,      // use hash-set data-structure
+    COLUMNAR,     // use column-store data-structure
+    COMPRESSED,   // use compressed btree data-structure
 };
 
 /** Space of qualifiers that a relation can have */
@@ -48,11 +51,14 @@ enum class RelationQualifier {
 
 /** Space of internal representations that a relation can have */
 enum class RelationRepresentation {
-    DEFAULT,  // use default data-structure
-    BRIE,     // use brie data-structure
-    BTREE,    // use btree data-structure
-    EQREL,    // use union data-structure
-    INFO,     // info relation for provenance
+    DEFAULT,     // use default data-structure
+    BRIE,        // use brie data-structure
+    BTREE,       // use btree data-structure
+    EQREL,       // use union data-structure
+    HASHSET,     // use hash-set data-structure
+    COLUMNAR,    // use column-store data-structure
+    COMPRESSED,  // use compressed btree data-structure
+    INFO,        // info relation for provenance
 };
 
 /**
@@ -62,7 +68,10 @@ inline bool isRelationRepresentationTag(const RelationTag& tag) {
     switch (tag) {
         case RelationTag::BRIE:
         case RelationTag::BTREE:
-        case RelationTag::EQREL: return true;
+        case RelationTag::EQREL:
+        case RelationTag::HASHSET:
+        case RelationTag::COLUMNAR:
+        case RelationTag::COMPRESSED: return true;
         default: return false;
     }
 }
@@ -107,6 +116,9 @@ inline RelationRepresentation getRelationRepresentationFromTag(const RelationTag
         case RelationTag::BRIE: return RelationRepresentation::BRIE;
         case RelationTag::BTREE: return RelationRepresentation::BTREE;
         case RelationTag::EQREL: return RelationRepresentation::EQREL;
+        case RelationTag::HASHSET: return RelationRepresentation::HASHSET;
+        case RelationTag::COLUMNAR: return RelationRepresentation::COLUMNAR;
+        case RelationTag::COMPRESSED: return RelationRepresentation::COMPRESSED;
         default: fatal("invalid relation tag");
     }
 
@@ -125,6 +137,9 @@ inline std::ostream& operator<<(std::ostream& os, RelationTag qualifier) {
         case RelationTag::BRIE: return os << "brie";
         case RelationTag::BTREE: return os << "btree";
         case RelationTag::EQREL: return os << "eqrel";
+        case RelationTag::HASHSET: return os << "hashset";
+        case RelationTag::COLUMNAR: return os << "columnar";
+        case RelationTag::COMPRESSED: return os << "compressed";
     }
 
     UNREACHABLE_BAD_CASE_ANALYSIS
@@ -149,6 +164,9 @@ inline std::ostream& operator<<(std::ostream& os, RelationRepresentation represe
         case RelationRepresentation::BTREE: return os << "btree";
         case RelationRepresentation::BRIE: return os << "brie";
         case RelationRepresentation::EQREL: return os << "eqrel";
+        case RelationRepresentation::HASHSET: return os << "hashset";
+        case RelationRepresentation::COLUMNAR: return os << "columnar";
+        case RelationRepresentation::COMPRESSED: return os << "compressed";
         case RelationRepresentation::INFO: return os << "info";
         case RelationRepresentation::DEFAULT: return os;
     }
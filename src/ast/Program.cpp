@@ -10,6 +10,7 @@
 #include "ast/utility/NodeMapper.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/StreamUtil.h"
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -83,6 +84,12 @@ bool Program::removeClause(const Clause* clause) {
     return false;
 }
 
+void Program::removeClauses(const std::set<const Clause*>& clausesToRemove) {
+    clauses.erase(std::remove_if(clauses.begin(), clauses.end(),
+                          [&](const Own<Clause>& clause) { return contains(clausesToRemove, clause.get()); }),
+            clauses.end());
+}
+
 bool Program::removeDirective(const Directive* directive) {
     // FIXME: Refactor to std::remove/erase
     for (auto it = directives.begin(); it != directives.end(); it++) {
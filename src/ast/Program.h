@@ -27,6 +27,7 @@
 #include "ast/Relation.h"
 #include "ast/Type.h"
 #include <iosfwd>
+#include <set>
 #include <vector>
 
 namespace souffle {
@@ -84,6 +85,9 @@ public:
     /** Remove a clause */
     bool removeClause(const Clause* clause);
 
+    /** Remove the given clauses */
+    void removeClauses(const std::set<const Clause*>& clausesToRemove);
+
     /** Remove a directive */
     bool removeDirective(const Directive* directive);
 
@@ -0,0 +1,155 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file EmbedFacts.cpp
+ *
+ ***********************************************************************/
+
+#include "ast/transform/EmbedFacts.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "ast/Argument.h"
+#include "ast/Atom.h"
+#include "ast/Attribute.h"
+#include "ast/Clause.h"
+#include "ast/Constant.h"
+#include "ast/Directive.h"
+#include "ast/NumericConstant.h"
+#include "ast/Program.h"
+#include "ast/QualifiedName.h"
+#include "ast/Relation.h"
+#include "ast/StringConstant.h"
+#include "ast/TranslationUnit.h"
+#include "ast/analysis/TypeEnvironment.h"
+#include "ast/analysis/TypeSystem.h"
+#include "ast/utility/Utils.h"
+#include "souffle/TypeAttribute.h"
+#include "souffle/io/ReadStreamFacts.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/StringUtil.h"
+#include <map>
+#include <set>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace souffle::ast::transform {
+
+bool EmbedFactsTransformer::transform(TranslationUnit& translationUnit) {
+    // provenance explains facts by their clauses
+    if (Global::config().has("provenance")) {
+        return false;
+    }
+
+    Program& program = translationUnit.getProgram();
+    const auto& typeEnv =
+            translationUnit.getAnalysis<analysis::TypeEnvironmentAnalysis>()->getTypeEnvironment();
+
+    // attributes of the relations whose facts may be embedded
+    std::map<QualifiedName, std::vector<Attribute*>> attributes;
+    for (auto* rel : program.getRelations()) {
+        if (rel->hasQualifier(RelationQualifier::INLINE) || !rel->getFunctionalDependencies().empty() ||
+                rel->getRepresentation() == RelationRepresentation::INFO) {
+            continue;
+        }
+        attributes[rel->getQualifiedName()] = rel->getAttributes();
+    }
+
+    // check that a constant is read as the value it denotes for the given attribute
+    auto isEmbeddable = [&](const Argument* arg, const Attribute* attribute) {
+        if (!typeEnv.isType(attribute->getTypeName())) {
+            return false;
+        }
+        const analysis::Type& type = typeEnv.getType(attribute->getTypeName());
+
+        if (const auto* str = as<StringConstant>(arg)) {
+            // directive values do not keep escapes and quotes verbatim
+            return isOfKind(type, TypeAttribute::Symbol) &&
+                   str->getConstant().find_first_of("\\\"\t\r\n") == std::string::npos;
+        }
+
+        const auto* num = as<NumericConstant>(arg);
+        if (num == nullptr) {
+            return false;
+        }
+        const auto& fixedType = num->getFixedType();
+        auto hasType = [&](NumericConstant::Type ty) { return !fixedType.has_value() || *fixedType == ty; };
+        const std::string& value = num->getConstant();
+        std::size_t charactersRead = 0;
+        try {
+            if (isOfKind(type, TypeAttribute::Signed) && hasType(NumericConstant::Type::Int)) {
+                RamSignedFromString(value, &charactersRead, 0);
+            } else if (isOfKind(type, TypeAttribute::Unsigned) && hasType(NumericConstant::Type::Uint)) {
+                RamUnsignedFromString(value, &charactersRead, 0);
+            } else if (isOfKind(type, TypeAttribute::Float) && hasType(NumericConstant::Type::Float)) {
+                RamFloatFromString(value, &charactersRead);
+            } else {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+        return charactersRead == value.size();
+    };
+
+    // collect the facts of each relation that can be embedded
+    std::map<QualifiedName, std::vector<const Clause*>> facts;
+    for (const Clause* clause : program.getClauses()) {
+        if (typeid(*clause) != typeid(Clause) || !isFact(*clause)) {
+            continue;
+        }
+        const Atom* head = clause->getHead();
+        auto rel = attributes.find(head->getQualifiedName());
+        if (rel == attributes.end()) {
+            continue;
+        }
+        const auto args = head->getArguments();
+        if (args.size() != rel->second.size()) {
+            continue;
+        }
+        bool embeddable = true;
+        for (std::size_t i = 0; i < args.size() && embeddable; i++) {
+            embeddable = isEmbeddable(args[i], rel->second[i]);
+        }
+        if (embeddable) {
+            facts[rel->first].push_back(clause);
+        }
+    }
+
+    // replace the facts of relations with many facts by a table that is loaded in bulk
+    std::set<const Clause*> embeddedFacts;
+    for (const auto& [name, clauses] : facts) {
+        if (clauses.size() < MIN_FACTS) {
+            continue;
+        }
+        FactTable table(attributes[name].size());
+        for (const Clause* clause : clauses) {
+            std::vector<std::string> row;
+            for (const Argument* arg : clause->getHead()->getArguments()) {
+                row.push_back(as<Constant>(arg)->getConstant());
+            }
+            table.addRow(row);
+            embeddedFacts.insert(clause);
+        }
+
+        auto directive = mk<Directive>(DirectiveType::input, name, clauses.front()->getSrcLoc());
+        directive->addParameter("IO", "facts");
+        directive->addParameter("facts", table.encode());
+        program.addDirective(std::move(directive));
+    }
+
+    if (embeddedFacts.empty()) {
+        return false;
+    }
+    program.removeClauses(embeddedFacts);
+    return true;
+}
+
+}  // namespace souffle::ast::transform
@@ -0,0 +1,52 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file EmbedFacts.h
+ *
+ * Defines AST transformation to embed the facts of a relation in bulk.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ast/TranslationUnit.h"
+#include "ast/transform/Transformer.h"
+#include <cstddef>
+#include <string>
+
+namespace souffle::ast::transform {
+
+/**
+ * Transformation pass to replace the facts of relations with many facts by
+ * a table of facts that is loaded with an input directive.
+ *
+ * The facts of such relations bypass the remaining transformations and the
+ * translation to RAM. Only facts of constants whose types are certain to
+ * match the attributes of their relation are embedded, so that the other
+ * facts are checked by the semantic checker as before.
+ */
+class EmbedFactsTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "EmbedFactsTransformer";
+    }
+
+    /** Minimal number of facts of a relation for them to be embedded */
+    static constexpr std::size_t MIN_FACTS = 1000;
+
+private:
+    EmbedFactsTransformer* cloneImpl() const override {
+        return new EmbedFactsTransformer();
+    }
+
+    bool transform(TranslationUnit& translationUnit) override;
+};
+
+}  // namespace souffle::ast::transform
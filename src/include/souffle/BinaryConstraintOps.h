@@ -343,6 +343,44 @@ inline BinaryConstraintOp negatedConstraintOp(const BinaryConstraintOp op) {
     UNREACHABLE_BAD_CASE_ANALYSIS
 }
 
+/**
+ * Swapped Constraint Operator
+ * The operator obtained when exchanging the operands of an ordering, i.e.
+ * a op b holds iff b op' a holds. Symmetric operators remain unchanged.
+ */
+inline BinaryConstraintOp swappedConstraintOp(const BinaryConstraintOp op) {
+    switch (op) {
+        case BinaryConstraintOp::LT: return BinaryConstraintOp::GT;
+        case BinaryConstraintOp::ULT: return BinaryConstraintOp::UGT;
+        case BinaryConstraintOp::FLT: return BinaryConstraintOp::FGT;
+        case BinaryConstraintOp::SLT: return BinaryConstraintOp::SGT;
+
+        case BinaryConstraintOp::LE: return BinaryConstraintOp::GE;
+        case BinaryConstraintOp::ULE: return BinaryConstraintOp::UGE;
+        case BinaryConstraintOp::FLE: return BinaryConstraintOp::FGE;
+        case BinaryConstraintOp::SLE: return BinaryConstraintOp::SGE;
+
+        case BinaryConstraintOp::GE: return BinaryConstraintOp::LE;
+        case BinaryConstraintOp::UGE: return BinaryConstraintOp::ULE;
+        case BinaryConstraintOp::FGE: return BinaryConstraintOp::FLE;
+        case BinaryConstraintOp::SGE: return BinaryConstraintOp::SLE;
+
+        case BinaryConstraintOp::GT: return BinaryConstraintOp::LT;
+        case BinaryConstraintOp::UGT: return BinaryConstraintOp::ULT;
+        case BinaryConstraintOp::FGT: return BinaryConstraintOp::FLT;
+        case BinaryConstraintOp::SGT: return BinaryConstraintOp::SLT;
+
+        case BinaryConstraintOp::EQ:
+        case BinaryConstraintOp::FEQ:
+        case BinaryConstraintOp::NE:
+        case BinaryConstraintOp::FNE: return op;
+
+        default: fatal("operator %s has no swapped form", op);
+    }
+
+    UNREACHABLE_BAD_CASE_ANALYSIS
+}
+
 /**
  * Converts operator to its symbolic representation
  */
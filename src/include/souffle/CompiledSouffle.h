@@ -21,16 +21,22 @@
 #include "souffle/SignalHandler.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/datastructure/BloomFilter.h"
 #include "souffle/datastructure/Brie.h"
+#include "souffle/datastructure/ColumnStore.h"
+#include "souffle/datastructure/CompressedBTree.h"
 #include "souffle/datastructure/EquivalenceRelation.h"
+#include "souffle/datastructure/HashSet.h"
 #include "souffle/datastructure/Table.h"
 #include "souffle/io/IOSystem.h"
 #include "souffle/io/WriteStream.h"
+#include "souffle/io/WriterPool.h"
 #include "souffle/utility/CacheUtil.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/EvaluatorUtil.h"
 #include "souffle/utility/FileUtil.h"
 #include "souffle/utility/FunctionalUtil.h"
+#include "souffle/utility/MemoryUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StreamUtil.h"
@@ -40,10 +46,12 @@
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
 #endif
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
@@ -346,4 +354,41 @@ private:
     Lock insert_lock;
 };
 
+/**
+ * Collects the tuples inserted into a relation by one thread of a parallel loop, and adds
+ * them as a sorted batch once it is full or the thread finishes its share of the loop.
+ */
+template <class RelType>
+class InsertBuffer {
+public:
+    static constexpr std::size_t capacity = 4096;
+
+    InsertBuffer(RelType& rel, typename RelType::context& ctxt) : rel(rel), ctxt(ctxt) {
+        tuples.reserve(capacity);
+    }
+    InsertBuffer(const InsertBuffer&) = delete;
+    InsertBuffer& operator=(const InsertBuffer&) = delete;
+
+    ~InsertBuffer() {
+        flush();
+    }
+
+    void insert(const typename RelType::t_tuple& tuple) {
+        tuples.push_back(tuple);
+        if (tuples.size() == capacity) {
+            flush();
+        }
+    }
+
+    void flush() {
+        rel.insertBatch(tuples, ctxt);
+        tuples.clear();
+    }
+
+private:
+    RelType& rel;
+    typename RelType::context& ctxt;
+    std::vector<typename RelType::t_tuple> tuples;
+};
+
 }  // namespace souffle
@@ -1811,6 +1811,38 @@ public:
         }
     }
 
+    /**
+     * Prefetches the nodes on the search paths of the given keys, which are those
+     * visited by find and lower_bound. The keys descend the tree in lockstep, so the
+     * loads of the nodes of one level overlap instead of waiting for each other.
+     * Trees that are too shallow to miss the cache on most searches are skipped.
+     * The tree must not be modified at the same time.
+     */
+    void prefetch(const Key* keys, std::size_t count) const {
+        constexpr std::size_t maxGroupSize = 32;
+        constexpr size_type minDepth = 5;
+        if (empty() || root->getDepth() < minDepth) {
+            return;
+        }
+
+        node* cur[maxGroupSize];
+        for (std::size_t first = 0; first < count; first += maxGroupSize) {
+            const std::size_t groupSize = std::min(count - first, maxGroupSize);
+            std::fill_n(cur, groupSize, root);
+
+            // all leaves are at the same depth
+            while (cur[0]->inner) {
+                for (std::size_t i = 0; i < groupSize; ++i) {
+                    auto a = &(cur[i]->keys[0]);
+                    auto b = &(cur[i]->keys[cur[i]->numElements]);
+                    auto pos = search.lower_bound(keys[first + i], a, b, comp);
+                    cur[i] = cur[i]->getChild(pos - a);
+                    prefetchMemory(cur[i], sizeof(node));
+                }
+            }
+        }
+    }
+
     /**
      * Obtains a lower boundary for the given key -- hence an iterator referencing
      * the smallest value that is not less the given key. If there is no such element,
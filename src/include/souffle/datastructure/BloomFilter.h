@@ -0,0 +1,116 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilter.h
+ *
+ * A Bloom filter over the keys of a relation, i.e. the values of some of
+ * its columns, which rules out most searches for keys the relation does
+ * not contain before they descend into an index.
+ *
+ * The filter is blocked: all bits of a key are placed in a single 64-bit
+ * word, such that a test costs at most one cache miss. It is built once
+ * the relation is complete and is not updated by later insertions.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/HashSet.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace souffle {
+
+class BloomFilter {
+public:
+    /** The number of bits reserved per key, which yields less than one percent of false positives */
+    static constexpr std::size_t bitsPerKey = 16;
+
+    /**
+     * Clear the filter and size it for the given number of keys. A filter
+     * that has never been reset may contain any key.
+     */
+    void reset(std::size_t numKeys) {
+        std::size_t numWords = 1;
+        while (numWords * 64 < numKeys * bitsPerKey) {
+            numWords <<= 1;
+        }
+        words.assign(numWords, 0);
+        mask = numWords - 1;
+    }
+
+    /** Add a key by its hash */
+    void insert(uint64_t hash) {
+        words[hash & mask] |= getBits(hash);
+    }
+
+    /** Test whether a key of the given hash may have been added */
+    bool mayContain(uint64_t hash) const {
+        if (words.empty()) {
+            return true;
+        }
+        const uint64_t bits = getBits(hash);
+        return (words[hash & mask] & bits) == bits;
+    }
+
+    /** Return the size of the filter in bytes */
+    std::size_t getMemoryUsage() const {
+        return words.size() * sizeof(uint64_t);
+    }
+
+    /** Start the hash of a key of the given size */
+    static uint64_t begin(std::size_t size) {
+        return size;
+    }
+
+    /** Add the next value of a key to its hash */
+    static uint64_t combine(uint64_t seed, RamDomain value) {
+        // from http://www.boost.org/doc/libs/1_35_0/doc/html/boost/hash_combine_id241013.html
+        return seed ^ (static_cast<uint64_t>(static_cast<RamUnsigned>(value)) + 0x9e3779b97f4a7c15ULL +
+                              (seed << 6) + (seed >> 2));
+    }
+
+    /** Finish the hash of a key */
+    static uint64_t finish(uint64_t seed) {
+        return detail::mix_hash(seed);
+    }
+
+    /** Return the hash of a key */
+    static uint64_t hash(const RamDomain* key, std::size_t size) {
+        uint64_t seed = begin(size);
+        for (std::size_t i = 0; i < size; i++) {
+            seed = combine(seed, key[i]);
+        }
+        return finish(seed);
+    }
+
+    template <std::size_t N>
+    static uint64_t hash(const std::array<RamDomain, N>& key) {
+        return hash(key.data(), N);
+    }
+
+private:
+    /** Select four bits of a word by the high bits of a hash, which do not select the word */
+    static uint64_t getBits(uint64_t hash) {
+        return (1ULL << ((hash >> 40) & 63)) | (1ULL << ((hash >> 46) & 63)) |
+               (1ULL << ((hash >> 52) & 63)) | (1ULL << ((hash >> 58) & 63));
+    }
+
+    /** The words of the filter, whose number is a power of two */
+    std::vector<uint64_t> words;
+
+    /** The mask selecting a word by the low bits of a hash */
+    uint64_t mask = 0;
+};
+
+}  // namespace souffle
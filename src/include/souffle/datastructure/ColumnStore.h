@@ -0,0 +1,705 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ColumnStore.h
+ *
+ * A column-oriented relational store for relations that are mostly
+ * scanned and filtered rather than searched.
+ *
+ * Tuples are appended to fixed-size chunks in which every attribute is
+ * stored in its own contiguous array. Each chunk maintains a zone map, i.e.
+ * the minimum and maximum value of each attribute, such that scans filtering
+ * attributes against constants are able to skip entire chunks. Within the
+ * remaining chunks, filters are evaluated one column at a time producing a
+ * selection of matching rows before any tuple is materialised.
+ *
+ * Duplicates are eliminated by a sharded hash table over the row numbers,
+ * which also serves membership tests and exact-match lookups.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/HashSet.h"
+#include "souffle/datastructure/PiggyList.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A comparison of a single attribute against a constant, i.e.
+ * t[column] op value, to be evaluated by a filtered scan of a column store.
+ */
+struct ColumnPredicate {
+    std::size_t column;
+    BinaryConstraintOp op;
+    RamDomain value;
+};
+
+/**
+ * Determines whether a column store is able to evaluate the given comparison
+ * operator as part of a filtered scan.
+ */
+inline bool isColumnPredicateOp(BinaryConstraintOp op) {
+    switch (op) {
+        case BinaryConstraintOp::EQ:
+        case BinaryConstraintOp::FEQ:
+        case BinaryConstraintOp::NE:
+        case BinaryConstraintOp::FNE:
+        case BinaryConstraintOp::LT:
+        case BinaryConstraintOp::ULT:
+        case BinaryConstraintOp::FLT:
+        case BinaryConstraintOp::LE:
+        case BinaryConstraintOp::ULE:
+        case BinaryConstraintOp::FLE:
+        case BinaryConstraintOp::GT:
+        case BinaryConstraintOp::UGT:
+        case BinaryConstraintOp::FGT:
+        case BinaryConstraintOp::GE:
+        case BinaryConstraintOp::UGE:
+        case BinaryConstraintOp::FGE: return true;
+        default: return false;
+    }
+}
+
+/**
+ * A column store for tuples of the given arity.
+ *
+ * In order to serve as an index within the interpreter and the synthesised
+ * code, the store provides the same exact-match lower_bound / upper_bound
+ * operations as the hash set. Tuples are enumerated in insertion order.
+ *
+ * @tparam Arity the number of attributes of the stored tuples
+ * @tparam chunkBits the logarithm of the number of rows per chunk
+ * @tparam shardBits the logarithm of the number of hash table shards
+ */
+template <std::size_t Arity, unsigned chunkBits = 10, unsigned shardBits = 6>
+class ColumnStore {
+    static_assert(Arity > 0, "column stores require at least one attribute");
+
+public:
+    using element_type = Tuple<RamDomain, Arity>;
+    using value_type = element_type;
+    using predicates = std::vector<ColumnPredicate>;
+
+    // the number of rows per chunk
+    static constexpr std::size_t chunkSize = std::size_t(1) << chunkBits;
+
+private:
+    // the number of independently locked shards
+    static constexpr std::size_t numShards = std::size_t(1) << shardBits;
+
+    // the number of slots allocated for a shard on its first insertion
+    static constexpr std::size_t initialShardCapacity = 16;
+
+    /**
+     * A chunk of rows, stored column by column, along with its zone map.
+     */
+    struct Chunk {
+        std::array<std::array<RamDomain, chunkSize>, Arity> columns;
+        std::array<RamDomain, Arity> min;
+        std::array<RamDomain, Arity> max;
+    };
+
+    /**
+     * A slot of the open-addressing table. The row is offset by one such
+     * that zero marks an empty slot.
+     */
+    struct Slot {
+        std::size_t hash = 0;
+        std::size_t row = 0;
+    };
+
+    /**
+     * An independently locked part of the hash table.
+     */
+    struct alignas(64) Shard {
+        mutable ReadWriteLock lock;
+        std::vector<Slot> slots;
+        std::size_t count = 0;
+    };
+
+public:
+    /**
+     * Column stores do not exploit access patterns; the hints are merely
+     * provided to match the interface of the other data structures.
+     */
+    struct operation_hints {
+        void clear() {}
+    };
+
+    /**
+     * An iterator over all rows of a column store, materialising each row
+     * into a tuple when it is visited.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, element_type> {
+        const ColumnStore* store = nullptr;
+        std::size_t row = 0;
+        element_type value{};
+
+    public:
+        iterator() = default;
+
+        iterator(const ColumnStore* store, std::size_t row) : store(store), row(row) {
+            load();
+        }
+
+        const element_type& operator*() const {
+            return value;
+        }
+
+        const element_type* operator->() const {
+            return &value;
+        }
+
+        iterator& operator++() {
+            ++row;
+            load();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res = *this;
+            ++(*this);
+            return res;
+        }
+
+        bool operator==(const iterator& other) const {
+            return row == other.row && store == other.store;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        void load() {
+            if (row < store->size()) {
+                store->materialise(row, value);
+            }
+        }
+    };
+
+    /**
+     * An iterator over the rows of a range of chunks satisfying a list of
+     * predicates. Chunks are processed one at a time: the zone map is
+     * consulted to skip the chunk entirely if possible, otherwise the
+     * predicates are evaluated column by column to obtain the selection of
+     * qualifying rows of the chunk.
+     */
+    class filter_iterator : public std::iterator<std::forward_iterator_tag, element_type> {
+        const ColumnStore* store = nullptr;
+        const predicates* preds = nullptr;
+        std::size_t chunk = 0;
+        std::size_t lastChunk = 0;
+        std::vector<uint32_t> selection;
+        std::size_t pos = 0;
+        element_type value{};
+
+    public:
+        filter_iterator() = default;
+
+        /** The end iterator of the given chunk range */
+        filter_iterator(const ColumnStore* store, std::size_t lastChunk)
+                : store(store), chunk(lastChunk), lastChunk(lastChunk) {}
+
+        /** The begin iterator of the given chunk range */
+        filter_iterator(const ColumnStore* store, const predicates* preds, std::size_t firstChunk,
+                std::size_t lastChunk)
+                : store(store), preds(preds), chunk(firstChunk), lastChunk(lastChunk) {
+            seek();
+        }
+
+        const element_type& operator*() const {
+            return value;
+        }
+
+        const element_type* operator->() const {
+            return &value;
+        }
+
+        filter_iterator& operator++() {
+            if (++pos < selection.size()) {
+                store->materialise(chunk, selection[pos], value);
+            } else {
+                ++chunk;
+                seek();
+            }
+            return *this;
+        }
+
+        bool operator==(const filter_iterator& other) const {
+            return chunk == other.chunk && pos == other.pos && store == other.store;
+        }
+
+        bool operator!=(const filter_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        /** Advances to the first qualifying row of the current or a subsequent chunk */
+        void seek() {
+            pos = 0;
+            for (; chunk < lastChunk; ++chunk) {
+                store->select(chunk, *preds, selection);
+                if (!selection.empty()) {
+                    store->materialise(chunk, selection[0], value);
+                    return;
+                }
+            }
+            selection.clear();
+        }
+    };
+
+    using const_iterator = iterator;
+
+    ColumnStore() : chunks(0) {}
+
+    ColumnStore(const ColumnStore&) = delete;
+    ColumnStore& operator=(const ColumnStore&) = delete;
+
+    /**
+     * Inserts the given tuple, returning true if it has not been present before.
+     */
+    bool insert(const element_type& tuple) {
+        const std::size_t h = hasher(tuple);
+        Shard& shard = getShard(h);
+        shard.lock.start_write();
+
+        // keep the load factor below 1/2
+        if (2 * (shard.count + 1) > shard.slots.size()) {
+            grow(shard);
+        }
+
+        const std::size_t mask = shard.slots.size() - 1;
+        for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+            Slot& slot = shard.slots[i];
+            if (slot.row == 0) {
+                slot.hash = h;
+                slot.row = append(tuple) + 1;
+                shard.count++;
+                shard.lock.end_write();
+                return true;
+            }
+            if (slot.hash == h && equal(slot.row - 1, tuple)) {
+                shard.lock.end_write();
+                return false;
+            }
+        }
+    }
+
+    bool insert(const element_type& tuple, operation_hints&) {
+        return insert(tuple);
+    }
+
+    /**
+     * Inserts all elements of the given range.
+     */
+    template <typename Iter>
+    void insert(const Iter& a, const Iter& b) {
+        for (auto it = a; it != b; ++it) {
+            insert(*it);
+        }
+    }
+
+    /**
+     * Inserts all tuples of the given column store.
+     */
+    void insertAll(const ColumnStore& other) {
+        insert(other.begin(), other.end());
+    }
+
+    bool contains(const element_type& tuple) const {
+        return locate(tuple) != 0;
+    }
+
+    bool contains(const element_type& tuple, operation_hints&) const {
+        return contains(tuple);
+    }
+
+    iterator find(const element_type& tuple) const {
+        const std::size_t row = locate(tuple);
+        return (row == 0) ? end() : iterator(this, row - 1);
+    }
+
+    iterator find(const element_type& tuple, operation_hints&) const {
+        return find(tuple);
+    }
+
+    /**
+     * Obtains an iterator to the given tuple or end() if it is not present.
+     */
+    iterator lower_bound(const element_type& tuple) const {
+        return find(tuple);
+    }
+
+    iterator lower_bound(const element_type& tuple, operation_hints&) const {
+        return lower_bound(tuple);
+    }
+
+    /**
+     * Obtains an iterator past the given tuple or end() if it is not present.
+     */
+    iterator upper_bound(const element_type& tuple) const {
+        const std::size_t row = locate(tuple);
+        return (row == 0) ? end() : iterator(this, row);
+    }
+
+    iterator upper_bound(const element_type& tuple, operation_hints&) const {
+        return upper_bound(tuple);
+    }
+
+    iterator begin() const {
+        return iterator(this, 0);
+    }
+
+    iterator end() const {
+        return iterator(this, size());
+    }
+
+    std::size_t size() const {
+        return numRows.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * Obtains the number of (partially) filled chunks.
+     */
+    std::size_t getNumChunks() const {
+        return (size() + chunkSize - 1) >> chunkBits;
+    }
+
+    /**
+     * Obtains the rows of the chunks [firstChunk, lastChunk) satisfying all
+     * of the given predicates. The predicates must outlive the range.
+     */
+    range<filter_iterator> filter(
+            const predicates& preds, std::size_t firstChunk, std::size_t lastChunk) const {
+        return {filter_iterator(this, &preds, firstChunk, lastChunk), filter_iterator(this, lastChunk)};
+    }
+
+    /**
+     * Obtains all rows satisfying all of the given predicates.
+     */
+    range<filter_iterator> filter(const predicates& preds) const {
+        return filter(preds, 0, getNumChunks());
+    }
+
+    /**
+     * Splits the rows satisfying the given predicates into (at most) the
+     * given number of ranges of whole chunks to be processed in parallel.
+     */
+    std::vector<range<filter_iterator>> partition(const predicates& preds, std::size_t num) const {
+        std::vector<range<filter_iterator>> res;
+        const std::size_t total = getNumChunks();
+        if (total == 0) {
+            return res;
+        }
+        num = std::max<std::size_t>(1, std::min(num, total));
+        const std::size_t step = (total + num - 1) / num;
+        for (std::size_t i = 0; i < total; i += step) {
+            res.push_back(filter(preds, i, std::min(i + step, total)));
+        }
+        return res;
+    }
+
+    /**
+     * Removes all tuples. Must not be invoked concurrently with any other operation.
+     */
+    void clear() {
+        for (auto& shard : shards) {
+            shard.slots.clear();
+            shard.count = 0;
+        }
+        chunks.clear();
+        numRows = 0;
+    }
+
+    /**
+     * Splits the tuples of this store into (at most) the given number of
+     * consecutive ranges to be processed in parallel.
+     */
+    std::vector<range<iterator>> partition(std::size_t num) const {
+        std::vector<range<iterator>> res;
+        const std::size_t total = size();
+        if (total == 0) {
+            return res;
+        }
+        num = std::max<std::size_t>(1, std::min(num, total));
+        const std::size_t step = (total + num - 1) / num;
+        for (std::size_t i = 0; i < total; i += step) {
+            res.push_back(make_range(iterator(this, i), iterator(this, std::min(i + step, total))));
+        }
+        return res;
+    }
+
+    std::vector<range<iterator>> getChunks(std::size_t num) const {
+        return partition(num);
+    }
+
+    /**
+     * Prints a summary of the occupancy of this store.
+     */
+    void printStats(std::ostream& out = std::cout) const {
+        std::size_t capacity = 0;
+        for (const auto& shard : shards) {
+            capacity += shard.slots.size();
+        }
+        out << "---------------------------------\n";
+        out << "  Rows: " << size() << "\n";
+        out << "  Chunks: " << getNumChunks() << " x " << chunkSize << " rows\n";
+        out << "  Column memory: " << getNumChunks() * sizeof(Chunk) << " bytes\n";
+        out << "  Hash slots: " << capacity << "\n";
+        out << "---------------------------------\n";
+    }
+
+private:
+    // the chunks of rows, providing stable addresses
+    PiggyList<Chunk> chunks;
+
+    // the number of fully written rows
+    std::atomic<std::size_t> numRows{0};
+
+    // serialises appending rows to the chunks
+    SpinLock appendLock;
+
+    // the shards of the hash table
+    std::array<Shard, numShards> shards;
+
+    detail::hash_function<element_type> hasher;
+
+    Shard& getShard(std::size_t h) {
+        return shards[(h >> (8 * sizeof(std::size_t) - shardBits)) & (numShards - 1)];
+    }
+
+    const Shard& getShard(std::size_t h) const {
+        return shards[(h >> (8 * sizeof(std::size_t) - shardBits)) & (numShards - 1)];
+    }
+
+    /**
+     * Appends a row, updating the zone map of its chunk, and returns its number.
+     */
+    std::size_t append(const element_type& tuple) {
+        appendLock.lock();
+        const std::size_t row = numRows.load(std::memory_order_relaxed);
+        const std::size_t offset = row & (chunkSize - 1);
+        if (offset == 0) {
+            chunks.createNode();
+        }
+        Chunk& chunk = chunks.get(row >> chunkBits);
+        for (std::size_t i = 0; i < Arity; i++) {
+            const RamDomain value = tuple[i];
+            chunk.columns[i][offset] = value;
+            if (offset == 0) {
+                chunk.min[i] = chunk.max[i] = value;
+            } else {
+                chunk.min[i] = std::min(chunk.min[i], value);
+                chunk.max[i] = std::max(chunk.max[i], value);
+            }
+        }
+        numRows.store(row + 1, std::memory_order_release);
+        appendLock.unlock();
+        return row;
+    }
+
+    /**
+     * Determines whether the given row equals the given tuple.
+     */
+    bool equal(std::size_t row, const element_type& tuple) const {
+        const Chunk& chunk = chunks.get(row >> chunkBits);
+        const std::size_t offset = row & (chunkSize - 1);
+        for (std::size_t i = 0; i < Arity; i++) {
+            if (chunk.columns[i][offset] != tuple[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void materialise(std::size_t row, element_type& tuple) const {
+        materialise(row >> chunkBits, row & (chunkSize - 1), tuple);
+    }
+
+    void materialise(std::size_t chunkId, std::size_t offset, element_type& tuple) const {
+        const Chunk& chunk = chunks.get(chunkId);
+        for (std::size_t i = 0; i < Arity; i++) {
+            tuple[i] = chunk.columns[i][offset];
+        }
+    }
+
+    /**
+     * Obtains the row of the given tuple, offset by one, or zero if the tuple
+     * is not present.
+     */
+    std::size_t locate(const element_type& tuple) const {
+        const std::size_t h = hasher(tuple);
+        const Shard& shard = getShard(h);
+        shard.lock.start_read();
+
+        std::size_t res = 0;
+        if (!shard.slots.empty()) {
+            const std::size_t mask = shard.slots.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                const Slot& slot = shard.slots[i];
+                if (slot.row == 0) {
+                    break;
+                }
+                if (slot.hash == h && equal(slot.row - 1, tuple)) {
+                    res = slot.row;
+                    break;
+                }
+            }
+        }
+
+        shard.lock.end_read();
+        return res;
+    }
+
+    /**
+     * Determines by means of the zone map whether any row of the given chunk
+     * may satisfy the given predicate. Zone maps are kept for the signed
+     * order only, hence other comparisons never rule out a chunk.
+     */
+    static bool mayMatch(const Chunk& chunk, const ColumnPredicate& pred) {
+        const RamDomain min = chunk.min[pred.column];
+        const RamDomain max = chunk.max[pred.column];
+        switch (pred.op) {
+            case BinaryConstraintOp::EQ: return min <= pred.value && pred.value <= max;
+            case BinaryConstraintOp::LT: return min < pred.value;
+            case BinaryConstraintOp::LE: return min <= pred.value;
+            case BinaryConstraintOp::GT: return max > pred.value;
+            case BinaryConstraintOp::GE: return max >= pred.value;
+            default: return true;
+        }
+    }
+
+    /**
+     * Narrows the selection to the rows whose value in the given column
+     * satisfies the given test. If the selection is not yet initialised,
+     * i.e. this is the first predicate, the first n rows are considered.
+     */
+    template <typename T, typename Test>
+    static std::size_t refine(const RamDomain* column, std::size_t n, bool first, uint32_t* selection,
+            std::size_t count, const Test& test) {
+        std::size_t res = 0;
+        if (first) {
+            for (std::size_t i = 0; i < n; i++) {
+                selection[res] = static_cast<uint32_t>(i);
+                res += test(ramBitCast<T>(column[i])) ? 1 : 0;
+            }
+        } else {
+            for (std::size_t j = 0; j < count; j++) {
+                const uint32_t i = selection[j];
+                selection[res] = i;
+                res += test(ramBitCast<T>(column[i])) ? 1 : 0;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Computes the rows of the given chunk satisfying all of the given predicates.
+     */
+    void select(std::size_t chunkId, const predicates& preds, std::vector<uint32_t>& selection) const {
+        const Chunk& chunk = chunks.get(chunkId);
+        const std::size_t n = std::min(chunkSize, size() - (chunkId << chunkBits));
+
+        for (const auto& pred : preds) {
+            if (!mayMatch(chunk, pred)) {
+                selection.clear();
+                return;
+            }
+        }
+
+        selection.resize(n);
+        std::size_t count = n;
+        if (preds.empty()) {
+            for (std::size_t i = 0; i < n; i++) {
+                selection[i] = static_cast<uint32_t>(i);
+            }
+        }
+
+        bool first = true;
+        for (const auto& pred : preds) {
+            const RamDomain* column = chunk.columns[pred.column].data();
+            uint32_t* sel = selection.data();
+
+            // dispatch on the operator once per chunk such that the loops are free of branches
+#define COLUMN_FILTER(TYPE, OP)                                                                           \
+    count = refine<TYPE>(column, n, first, sel, count, [v = ramBitCast<TYPE>(pred.value)](TYPE x) { \
+        return x OP v;                                                                                   \
+    });                                                                                                  \
+    break;
+            switch (pred.op) {
+                case BinaryConstraintOp::EQ: COLUMN_FILTER(RamDomain, ==)
+                case BinaryConstraintOp::FEQ: COLUMN_FILTER(RamFloat, ==)
+                case BinaryConstraintOp::NE: COLUMN_FILTER(RamDomain, !=)
+                case BinaryConstraintOp::FNE: COLUMN_FILTER(RamFloat, !=)
+                case BinaryConstraintOp::LT: COLUMN_FILTER(RamSigned, <)
+                case BinaryConstraintOp::ULT: COLUMN_FILTER(RamUnsigned, <)
+                case BinaryConstraintOp::FLT: COLUMN_FILTER(RamFloat, <)
+                case BinaryConstraintOp::LE: COLUMN_FILTER(RamSigned, <=)
+                case BinaryConstraintOp::ULE: COLUMN_FILTER(RamUnsigned, <=)
+                case BinaryConstraintOp::FLE: COLUMN_FILTER(RamFloat, <=)
+                case BinaryConstraintOp::GT: COLUMN_FILTER(RamSigned, >)
+                case BinaryConstraintOp::UGT: COLUMN_FILTER(RamUnsigned, >)
+                case BinaryConstraintOp::FGT: COLUMN_FILTER(RamFloat, >)
+                case BinaryConstraintOp::GE: COLUMN_FILTER(RamSigned, >=)
+                case BinaryConstraintOp::UGE: COLUMN_FILTER(RamUnsigned, >=)
+                case BinaryConstraintOp::FGE: COLUMN_FILTER(RamFloat, >=)
+                default: assert(false && "unsupported column predicate");
+            }
+#undef COLUMN_FILTER
+            first = false;
+            if (count == 0) {
+                break;
+            }
+        }
+        selection.resize(count);
+    }
+
+    /**
+     * Doubles the number of slots of the given shard. The caller must hold
+     * the write lock of the shard.
+     */
+    static void grow(Shard& shard) {
+        const std::size_t capacity = std::max(initialShardCapacity, 2 * shard.slots.size());
+        std::vector<Slot> slots(capacity);
+        const std::size_t mask = capacity - 1;
+        for (const auto& cur : shard.slots) {
+            if (cur.row == 0) {
+                continue;
+            }
+            std::size_t i = cur.hash & mask;
+            while (slots[i].row != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = cur;
+        }
+        shard.slots.swap(slots);
+    }
+};
+
+}  // namespace souffle
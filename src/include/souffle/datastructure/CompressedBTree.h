@@ -0,0 +1,556 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompressedBTree.h
+ *
+ * An ordered set of tuples whose leaves are delta encoded, trading insertion
+ * throughput for a considerably smaller memory footprint than btree_set.
+ *
+ * Each leaf stores its first tuple uncompressed. Every subsequent tuple is
+ * encoded relative to its predecessor: a bit mask marks the columns that
+ * differ, followed by the zig-zag encoded differences of those columns as
+ * variable length integers. Since neighbouring tuples in lexicographical
+ * order share long prefixes and tend to differ by small amounts, most
+ * tuples occupy a few bytes only. Leaves are ordered by their (uncompressed)
+ * last tuple, such that searches locate the relevant leaf without decoding
+ * and subsequently decode a single leaf incrementally, stopping as soon as
+ * the position of the searched tuple has been passed.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/datastructure/BTree.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/**
+ * The generic implementation of compressed B-tree sets and multisets.
+ *
+ * Insertions and searches are synchronised by a single read/write lock.
+ * Iterators decode the leaf they point to on the fly and are invalidated
+ * by insertions, hence iterating must not run concurrently with inserting.
+ *
+ * @tparam Key the type of the stored tuples, an array of integral values
+ * @tparam Comparator the order of the tuples
+ * @tparam leafSize the maximum number of tuples per leaf
+ * @tparam isSet true for sets, false for multisets
+ */
+template <typename Key, typename Comparator, unsigned leafSize, bool isSet>
+class compressed_btree {
+    // the number of columns of the stored tuples
+    static constexpr std::size_t arity = std::tuple_size<Key>::value;
+
+    // the number of bytes of the mask of changed columns
+    static constexpr std::size_t maskBytes = (arity + 7) / 8;
+
+    using element = typename Key::value_type;
+    using uelement = std::make_unsigned_t<element>;
+
+    static_assert(arity > 0, "compressed B-trees require at least one column");
+    static_assert(std::is_integral_v<element>, "compressed B-trees require integral columns");
+
+    /**
+     * A leaf, covering up to leafSize consecutive tuples.
+     */
+    struct Leaf {
+        // the first tuple, stored uncompressed
+        Key first;
+
+        // the encoding of all subsequent tuples
+        std::vector<uint8_t> data;
+
+        // the number of tuples in this leaf
+        std::size_t count = 0;
+    };
+
+    /**
+     * The order of leaves, derived from the tuple comparator.
+     */
+    struct leaf_order {
+        Comparator comp;
+        bool operator()(const Key& a, const Key& b) const {
+            return comp.less(a, b);
+        }
+    };
+
+    // leaves indexed by their last tuple; equal keys only occur in multisets
+    using leaf_map = std::multimap<Key, Leaf, leaf_order>;
+    using leaf_iterator = typename leaf_map::const_iterator;
+
+public:
+    using element_type = Key;
+    using value_type = Key;
+
+    /**
+     * Compressed B-trees do not exploit access patterns; the hints are
+     * merely provided to match the interface of the other data structures.
+     */
+    struct operation_hints {
+        void clear() {}
+    };
+
+    /**
+     * An iterator over the tuples of a compressed B-tree. The iterator
+     * holds the current tuple, which is updated by decoding the
+     * difference to the next one on each increment.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, Key> {
+        friend class compressed_btree;
+
+        // the current leaf and the end of the leaves
+        leaf_iterator leaf;
+        leaf_iterator last;
+
+        // the index of the current tuple within its leaf
+        std::size_t index = 0;
+
+        // the encoding of the next tuple of the current leaf
+        const uint8_t* pos = nullptr;
+
+        // the current tuple
+        Key value{};
+
+        iterator(leaf_iterator leaf, leaf_iterator last) : leaf(leaf), last(last) {
+            enter();
+        }
+
+        void enter() {
+            index = 0;
+            if (leaf != last) {
+                value = leaf->second.first;
+                pos = leaf->second.data.data();
+            }
+        }
+
+    public:
+        iterator() = default;
+
+        const Key& operator*() const {
+            return value;
+        }
+
+        const Key* operator->() const {
+            return &value;
+        }
+
+        iterator& operator++() {
+            if (++index < leaf->second.count) {
+                pos = decode(pos, value);
+            } else {
+                ++leaf;
+                enter();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res = *this;
+            ++(*this);
+            return res;
+        }
+
+        bool operator==(const iterator& other) const {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    using const_iterator = iterator;
+    using chunk = range<iterator>;
+
+    compressed_btree() = default;
+
+    template <typename Iter>
+    compressed_btree(const Iter& a, const Iter& b) {
+        insert(a, b);
+    }
+
+    compressed_btree(const compressed_btree&) = delete;
+    compressed_btree& operator=(const compressed_btree&) = delete;
+
+    /**
+     * Inserts the given tuple. For sets, returns true if it has not been
+     * present before; multisets accept any tuple.
+     */
+    bool insert(const Key& key) {
+        lock.start_write();
+        bool res = insertInternal(key);
+        lock.end_write();
+        return res;
+    }
+
+    bool insert(const Key& key, operation_hints&) {
+        return insert(key);
+    }
+
+    /**
+     * Inserts all tuples of the given range.
+     */
+    template <typename Iter>
+    void insert(const Iter& a, const Iter& b) {
+        lock.start_write();
+        for (auto it = a; it != b; ++it) {
+            insertInternal(*it);
+        }
+        lock.end_write();
+    }
+
+    /**
+     * Inserts all tuples of the given compressed B-tree.
+     */
+    void insertAll(const compressed_btree& other) {
+        insert(other.begin(), other.end());
+    }
+
+    bool contains(const Key& key) const {
+        lock.start_read();
+        bool res = false;
+        auto it = leaves.lower_bound(key);
+        if (it != leaves.end()) {
+            // the first and last tuple of a leaf are checked without decoding
+            const Leaf& leaf = it->second;
+            if (comp(key, leaf.first) >= 0) {
+                res = comp.equal(key, it->first) || comp.equal(*seek(it, key, false), key);
+            }
+        }
+        lock.end_read();
+        return res;
+    }
+
+    bool contains(const Key& key, operation_hints&) const {
+        return contains(key);
+    }
+
+    iterator find(const Key& key) const {
+        auto res = lower_bound(key);
+        return (res != end() && comp.equal(*res, key)) ? res : end();
+    }
+
+    iterator find(const Key& key, operation_hints&) const {
+        return find(key);
+    }
+
+    /**
+     * Obtains an iterator to the first tuple not less than the given one.
+     */
+    iterator lower_bound(const Key& key) const {
+        lock.start_read();
+        auto it = leaves.lower_bound(key);
+        iterator res = (it == leaves.end()) ? end() : seek(it, key, false);
+        lock.end_read();
+        return res;
+    }
+
+    iterator lower_bound(const Key& key, operation_hints&) const {
+        return lower_bound(key);
+    }
+
+    /**
+     * Obtains an iterator to the first tuple greater than the given one.
+     */
+    iterator upper_bound(const Key& key) const {
+        lock.start_read();
+        auto it = leaves.upper_bound(key);
+        iterator res = (it == leaves.end()) ? end() : seek(it, key, true);
+        lock.end_read();
+        return res;
+    }
+
+    iterator upper_bound(const Key& key, operation_hints&) const {
+        return upper_bound(key);
+    }
+
+    iterator begin() const {
+        return iterator(leaves.begin(), leaves.end());
+    }
+
+    iterator end() const {
+        return iterator(leaves.end(), leaves.end());
+    }
+
+    std::size_t size() const {
+        return numElements;
+    }
+
+    bool empty() const {
+        return numElements == 0;
+    }
+
+    /**
+     * Removes all tuples. Must not be invoked concurrently with any other operation.
+     */
+    void clear() {
+        leaves.clear();
+        numElements = 0;
+    }
+
+    /**
+     * Splits the tuples of this tree into (at most) the given number of
+     * ranges of whole leaves to be processed in parallel.
+     */
+    std::vector<chunk> getChunks(std::size_t num) const {
+        std::vector<chunk> res;
+        if (leaves.empty()) {
+            return res;
+        }
+        num = std::max<std::size_t>(1, std::min(num, leaves.size()));
+        const std::size_t step = (leaves.size() + num - 1) / num;
+        auto cur = leaves.begin();
+        while (cur != leaves.end()) {
+            auto next = cur;
+            for (std::size_t i = 0; i < step && next != leaves.end(); i++) {
+                ++next;
+            }
+            res.push_back(make_range(iterator(cur, leaves.end()), iterator(next, leaves.end())));
+            cur = next;
+        }
+        return res;
+    }
+
+    std::vector<chunk> partition(std::size_t num) const {
+        return getChunks(num);
+    }
+
+    /**
+     * Determines the number of bytes occupied by the encoded leaves.
+     */
+    std::size_t getCompressedSize() const {
+        std::size_t res = 0;
+        for (const auto& cur : leaves) {
+            res += cur.second.data.capacity();
+        }
+        return res;
+    }
+
+    /**
+     * Determines the amount of memory used by this data structure,
+     * approximating the overhead of a map node by four pointers.
+     */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + leaves.size() * (sizeof(typename leaf_map::value_type) + 4 * sizeof(void*)) +
+               getCompressedSize();
+    }
+
+    /**
+     * Prints a summary of the compression achieved by this tree.
+     */
+    void printStats(std::ostream& out = std::cout) const {
+        const std::size_t memory = getMemoryUsage();
+        out << "---------------------------------\n";
+        out << "  Elements: " << size() << "\n";
+        out << "  Leaves: " << leaves.size() << "\n";
+        out << "  Avg elements / leaf: " << (leaves.empty() ? 0.0 : double(size()) / leaves.size()) << "\n";
+        out << "  Encoded bytes: " << getCompressedSize() << "\n";
+        out << "  Memory usage: " << memory << "\n";
+        out << "  Compression ratio: " << (memory == 0 ? 0.0 : double(size() * sizeof(Key)) / memory)
+            << "\n";
+        out << "---------------------------------\n";
+    }
+
+private:
+    // the leaves of this tree
+    leaf_map leaves;
+
+    // the total number of tuples
+    std::size_t numElements = 0;
+
+    // synchronises insertions with searches
+    mutable ReadWriteLock lock;
+
+    // buffers for decoding and re-encoding a leaf, protected by the write lock
+    std::vector<Key> buffer;
+    std::vector<uint8_t> bytes;
+
+    Comparator comp;
+
+    /**
+     * Appends the encoding of cur relative to prev to the given buffer.
+     */
+    static void encode(std::vector<uint8_t>& out, const Key& prev, const Key& cur) {
+        const std::size_t maskPos = out.size();
+        out.resize(maskPos + maskBytes, 0);
+        for (std::size_t i = 0; i < arity; i++) {
+            if (prev[i] == cur[i]) {
+                continue;
+            }
+            out[maskPos + i / 8] |= uint8_t(1) << (i % 8);
+            // zig-zag encode the wrapping difference, such that small negative deltas remain small
+            uelement delta = static_cast<uelement>(cur[i]) - static_cast<uelement>(prev[i]);
+            uelement v = (delta << 1) ^ (static_cast<uelement>(0) - (delta >> (8 * sizeof(uelement) - 1)));
+            while (v >= 0x80) {
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+    }
+
+    /**
+     * Advances cur to the tuple encoded at the given position, returning the
+     * position of the subsequent encoding.
+     */
+    static const uint8_t* decode(const uint8_t* pos, Key& cur) {
+        const uint8_t* mask = pos;
+        pos += maskBytes;
+        for (std::size_t i = 0; i < arity; i++) {
+            if ((mask[i / 8] & (uint8_t(1) << (i % 8))) == 0) {
+                continue;
+            }
+            uelement v = 0;
+            unsigned shift = 0;
+            while (*pos & 0x80) {
+                v |= static_cast<uelement>(*pos++ & 0x7f) << shift;
+                shift += 7;
+            }
+            v |= static_cast<uelement>(*pos++) << shift;
+            uelement delta = (v >> 1) ^ (static_cast<uelement>(0) - (v & 1));
+            cur[i] = static_cast<element>(static_cast<uelement>(cur[i]) + delta);
+        }
+        return pos;
+    }
+
+    /**
+     * Positions an iterator on the first tuple of the given leaf that is not
+     * less than (or, if strict, greater than) the given key. The last tuple
+     * of the leaf must satisfy this condition.
+     */
+    iterator seek(leaf_iterator it, const Key& key, bool strict) const {
+        iterator res(it, leaves.end());
+        while (res.index + 1 < it->second.count) {
+            int c = comp(res.value, key);
+            if (strict ? c > 0 : c >= 0) {
+                break;
+            }
+            res.pos = decode(res.pos, res.value);
+            res.index++;
+        }
+        return res;
+    }
+
+    /**
+     * Re-encodes the given tuples into the given leaf.
+     */
+    void encodeLeaf(Leaf& leaf, typename std::vector<Key>::const_iterator a,
+            typename std::vector<Key>::const_iterator b) {
+        bytes.clear();
+        for (auto it = a + 1; it < b; ++it) {
+            encode(bytes, *(it - 1), *it);
+        }
+        leaf.first = *a;
+        leaf.count = b - a;
+        std::vector<uint8_t>(bytes.begin(), bytes.end()).swap(leaf.data);
+    }
+
+    /**
+     * Inserts the given key; the caller must hold the write lock.
+     */
+    bool insertInternal(const Key& key) {
+        if (leaves.empty()) {
+            Leaf leaf;
+            leaf.first = key;
+            leaf.count = 1;
+            leaves.emplace(key, std::move(leaf));
+            numElements++;
+            return true;
+        }
+
+        // sets look for the leaf covering the key, multisets for the leaf after all equal tuples
+        auto it = isSet ? leaves.lower_bound(key) : leaves.upper_bound(key);
+
+        // the key exceeds all present tuples: append it to the last leaf
+        if (it == leaves.end()) {
+            --it;
+            Leaf& leaf = it->second;
+            if (leaf.count < leafSize) {
+                encode(leaf.data, it->first, key);
+                if (++leaf.count == leafSize) {
+                    leaf.data.shrink_to_fit();
+                }
+                // the last tuple of the leaf changes, hence it needs to be re-keyed
+                auto node = leaves.extract(it);
+                node.key() = key;
+                leaves.insert(leaves.end(), std::move(node));
+            } else {
+                Leaf next;
+                next.first = key;
+                next.count = 1;
+                leaves.emplace_hint(leaves.end(), key, std::move(next));
+            }
+            numElements++;
+            return true;
+        }
+
+        // decode the leaf and locate the position of the key
+        Leaf& leaf = it->second;
+        buffer.clear();
+        buffer.push_back(leaf.first);
+        const uint8_t* pos = leaf.data.data();
+        for (std::size_t i = 1; i < leaf.count; i++) {
+            buffer.push_back(buffer.back());
+            pos = decode(pos, buffer.back());
+        }
+        auto less = [&](const Key& a, const Key& b) { return comp.less(a, b); };
+        auto cur = isSet ? std::lower_bound(buffer.begin(), buffer.end(), key, less)
+                         : std::upper_bound(buffer.begin(), buffer.end(), key, less);
+        if (isSet && comp.equal(*cur, key)) {
+            return false;
+        }
+        buffer.insert(cur, key);
+        numElements++;
+
+        // the last tuple of the leaf is unaffected since the key is inserted before it
+        if (buffer.size() <= leafSize) {
+            encodeLeaf(leaf, buffer.begin(), buffer.end());
+            return true;
+        }
+
+        // split the leaf, the lower half becomes a new leaf in front of it
+        auto mid = buffer.begin() + buffer.size() / 2;
+        Leaf lower;
+        encodeLeaf(lower, buffer.begin(), mid);
+        encodeLeaf(leaf, mid, buffer.end());
+        leaves.emplace_hint(it, *(mid - 1), std::move(lower));
+        return true;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * A compressed B-tree set, storing each tuple at most once.
+ */
+template <typename Key, typename Comparator = detail::comparator<Key>, unsigned leafSize = 128>
+using compressed_btree_set = detail::compressed_btree<Key, Comparator, leafSize, true>;
+
+/**
+ * A compressed B-tree multiset, retaining tuples that are equivalent
+ * with respect to the comparator.
+ */
+template <typename Key, typename Comparator = detail::comparator<Key>, unsigned leafSize = 128>
+using compressed_btree_multiset = detail::compressed_btree<Key, Comparator, leafSize, false>;
+
+}  // namespace souffle
@@ -34,6 +34,7 @@
 #include <shared_mutex>
 #include <stdexcept>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -98,11 +99,14 @@ public:
      * @return true if the pair is new to the data structure
      */
     bool insert(value_type x, value_type y, operation_hints) {
+        // the pair is implied already, so the cached sets remain valid
+        if (contains(x, y)) {
+            return true;
+        }
         // indicate that iterators will have to generate on request
         this->statesMapStale.store(true, std::memory_order_relaxed);
-        bool retval = contains(x, y);
         sds.unionNodes(x, y);
-        return retval;
+        return false;
     }
 
     /**
@@ -110,21 +114,26 @@ public:
      * @param other the binary relation from which to add elements from
      */
     void insertAll(const EquivalenceRelation<TupleType>& other) {
-        other.genAllDisjointSetLists();
-
-        // iterate over partitions at a time
-        for (typename StatesMap::chunk it : other.equivalencePartition.getChunks(MAX_THREADS)) {
-            for (auto& p : it) {
-                value_type rep = p.first;
-                StatesList& pl = *p.second;
-                const std::size_t ksize = pl.size();
-                for (std::size_t i = 0; i < ksize; ++i) {
-                    this->sds.unionNodes(rep, pl.get(i));
+        // join each element of other with its representative, the sets of other need not be cached
+        std::atomic<bool> changed(false);
+        auto chunks = other.sds.sparseToDenseMap.getChunks(MAX_THREADS);
+        PARALLEL_START
+        pfor(auto it = chunks.begin(); it < chunks.end(); ++it) {
+            for (const auto& p : *it) {
+                value_type el = p.first;
+                value_type rep = other.sds.findNode(el);
+                if (!this->sds.contains(el, rep)) {
+                    changed.store(true, std::memory_order_relaxed);
+                    this->sds.unionNodes(el, rep);
                 }
             }
         }
-        // invalidate iterators unconditionally
-        this->statesMapStale.store(true, std::memory_order_relaxed);
+        PARALLEL_END
+
+        // invalidate iterators only if a set has changed
+        if (changed.load(std::memory_order_relaxed)) {
+            this->statesMapStale.store(true, std::memory_order_relaxed);
+        }
     }
 
     /**
@@ -135,10 +144,7 @@ public:
      */
     void extend(const EquivalenceRelation<TupleType>& other) {
         // nothing to extend if there's no new/original knowledge
-        if (other.size() == 0 || this->size() == 0) return;
-
-        this->genAllDisjointSetLists();
-        other.genAllDisjointSetLists();
+        if (other.sds.size() == 0 || this->sds.size() == 0) return;
 
         std::set<value_type> repsCovered;
 
@@ -151,26 +157,21 @@ public:
             for (; it != end; ++it) {
                 std::tie(el, std::ignore) = *it;
                 if (other.containsElement(el)) {
-                    value_type rep = other.sds.findNode(el);
-                    if (repsCovered.count(rep) == 0) {
-                        repsCovered.emplace(rep);
-                    }
+                    repsCovered.emplace(other.sds.findNode(el));
                 }
             }
         }
+        if (repsCovered.empty()) return;
 
-        // add the intersecting dj sets into this one
-        {
-            value_type el;
-            value_type rep;
-            auto it = other.sds.sparseToDenseMap.begin();
-            auto end = other.sds.sparseToDenseMap.end();
-            for (; it != end; ++it) {
-                std::tie(el, std::ignore) = *it;
-                rep = other.sds.findNode(el);
-                if (repsCovered.count(rep) != 0) {
-                    this->insert(el, rep);
-                }
+        // add the intersecting dj sets into this one, only visiting the members of the covered sets
+        other.genAllDisjointSetLists();
+        for (value_type rep : repsCovered) {
+            auto found = other.equivalencePartition.find({rep, nullptr});
+            assert(found != other.equivalencePartition.end() && "covered set has not been cached");
+            const StatesList& pl = *(*found).second;
+            const std::size_t ksize = pl.size();
+            for (std::size_t i = 0; i < ksize; ++i) {
+                this->insert(pl.get(i), rep);
             }
         }
     }
@@ -205,6 +206,7 @@ public:
         this->statesMapStale.store(true, std::memory_order_relaxed);
 
         equivalencePartition.clear();
+        statesMapNodes = 0;
     }
 
     /**
@@ -712,12 +714,16 @@ private:
     mutable std::shared_mutex statesLock;
 
     mutable StatesMap equivalencePartition;
+    // number of nodes of the disjoint set that are cached in equivalencePartition
+    mutable std::size_t statesMapNodes = 0;
     // whether the cache is stale
     mutable std::atomic<bool> statesMapStale;
 
     /**
      * Generate a cache of the sets such that they can be iterated over efficiently.
      * Each set is partitioned into a PiggyList.
+     * A stale cache is updated rather than regenerated: sets that have been joined since
+     * are merged, and nodes that have been created since are appended to their sets.
      */
     void genAllDisjointSetLists() const {
         statesLock.lock();
@@ -728,11 +734,57 @@ private:
             return;
         }
 
-        // btree version
-        emptyPartition();
+        const std::size_t dSetSize = this->sds.ds.a_blocks.size();
+        if (statesMapNodes != 0) {
+            mergeDisjointSetLists();
+        }
+        appendDisjointSetLists(statesMapNodes, dSetSize);
+        statesMapNodes = dSetSize;
+
+        statesMapStale.store(false, std::memory_order_release);
+        statesLock.unlock();
+    }
+
+    /**
+     * Merge the cached sets whose representatives have been joined with another set.
+     * The smaller list is appended to the larger one.
+     */
+    void mergeDisjointSetLists() const {
+        std::unordered_map<value_type, StatesBucket> lists;
+        for (auto& p : equivalencePartition) {
+            StatesBucket list = p.second;
+            StatesBucket& repList = lists[static_cast<value_type>(this->sds.findNode(p.first))];
+            if (repList == nullptr) {
+                repList = list;
+                continue;
+            }
+            if (repList->size() < list->size()) {
+                std::swap(repList, list);
+            }
+            const std::size_t ksize = list->size();
+            for (std::size_t i = 0; i < ksize; ++i) {
+                repList->append(list->get(i));
+            }
+            delete list;
+        }
 
-        std::size_t dSetSize = this->sds.ds.a_blocks.size();
-        for (std::size_t i = 0; i < dSetSize; ++i) {
+        // the lists are kept, only the keys are replaced
+        equivalencePartition.clear();
+        for (auto& p : lists) {
+            StorePair sp = {p.first, nullptr};
+            equivalencePartition.insert(sp, [&](StorePair& entry) {
+                entry.second = p.second;
+                return p.second;
+            });
+        }
+    }
+
+    /**
+     * Append the nodes with the dense indices [from, to) to the cached lists of their sets
+     */
+    void appendDisjointSetLists(std::size_t from, std::size_t to) const {
+        PARALLEL_START
+        pfor(std::size_t i = from; i < to; ++i) {
             typename TupleType::value_type sparseVal = this->sds.toSparse(i);
             parent_t rep = this->sds.findNode(sparseVal);
 
@@ -744,9 +796,7 @@ private:
             });
             mapList->append(sparseVal);
         }
-
-        statesMapStale.store(false, std::memory_order_release);
-        statesLock.unlock();
+        PARALLEL_END
     }
 };
 }  // namespace souffle
@@ -0,0 +1,424 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HashSet.h
+ *
+ * A concurrent open-addressing hash set to be used as a relational store
+ * for relations that are exclusively searched by full equality.
+ *
+ * Elements are stored in an append-only list, hence they retain their
+ * address and iterators remain valid while further elements are inserted.
+ * The hash table itself is split into shards, each protected by its own
+ * read/write lock, such that concurrent insertions only contend if they
+ * hash into the same shard.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/datastructure/PiggyList.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/**
+ * The finaliser of MurmurHash3, distributing the entropy of a hash value
+ * over all of its bits. Required since the low bits select the slot and the
+ * high bits select the shard.
+ */
+inline uint64_t mix_hash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * The default hash function of hash sets.
+ */
+template <typename T>
+struct hash_function {
+    std::size_t operator()(const T& value) const {
+        return static_cast<std::size_t>(mix_hash(std::hash<T>()(value)));
+    }
+};
+
+/**
+ * A hash function for tuples combining the hashes of all components.
+ */
+template <typename T, std::size_t N>
+struct hash_function<std::array<T, N>> {
+    std::size_t operator()(const std::array<T, N>& tuple) const {
+        uint64_t seed = N;
+        for (const auto& cur : tuple) {
+            // from http://www.boost.org/doc/libs/1_35_0/doc/html/boost/hash_combine_id241013.html
+            seed ^= std::hash<T>()(cur) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return static_cast<std::size_t>(mix_hash(seed));
+    }
+};
+
+}  // namespace detail
+
+/**
+ * A concurrent hash set supporting insertions, membership tests and
+ * iteration. In order to serve as an index within the interpreter and the
+ * synthesised code, the set provides lower_bound / upper_bound operations;
+ * those are only meaningful for exact matches, i.e. [lower_bound(x),
+ * upper_bound(x)) covers x if it is present and is empty otherwise.
+ *
+ * @tparam Key the type of the stored elements
+ * @tparam Hash the hash function to be applied on elements
+ * @tparam Equal the equality predicate for elements
+ * @tparam shardBits the logarithm of the number of shards
+ */
+template <typename Key, typename Hash = detail::hash_function<Key>, typename Equal = std::equal_to<Key>,
+        unsigned shardBits = 6>
+class HashSet {
+    // the number of independently locked shards
+    static constexpr std::size_t numShards = std::size_t(1) << shardBits;
+
+    // the number of slots allocated for a shard on its first insertion
+    static constexpr std::size_t initialShardCapacity = 16;
+
+    // the initial block size of the element storage (log2)
+    static constexpr std::size_t storageBlockBits = 10;
+
+    /**
+     * A slot of the open-addressing table. The position refers to the
+     * element storage, offset by one such that zero marks an empty slot.
+     */
+    struct Slot {
+        std::size_t hash = 0;
+        std::size_t pos = 0;
+    };
+
+    /**
+     * An independently locked part of the hash table.
+     */
+    struct alignas(64) Shard {
+        mutable ReadWriteLock lock;
+        std::vector<Slot> slots;
+        std::size_t count = 0;
+    };
+
+public:
+    using element_type = Key;
+    using value_type = Key;
+
+    /**
+     * Hash sets do not exploit access patterns; the hints are merely
+     * provided to match the interface of the other data structures.
+     */
+    struct operation_hints {
+        void clear() {}
+    };
+
+    /**
+     * An iterator over the elements of a hash set, enumerating them in
+     * insertion order.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, Key> {
+        const PiggyList<Key>* storage = nullptr;
+        std::size_t pos = 0;
+
+    public:
+        iterator() = default;
+
+        iterator(const PiggyList<Key>* storage, std::size_t pos) : storage(storage), pos(pos) {}
+
+        const Key& operator*() const {
+            return storage->get(pos);
+        }
+
+        const Key* operator->() const {
+            return &storage->get(pos);
+        }
+
+        iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator res = *this;
+            ++pos;
+            return res;
+        }
+
+        bool operator==(const iterator& other) const {
+            return pos == other.pos && storage == other.storage;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    using const_iterator = iterator;
+
+    HashSet() : storage(storageBlockBits) {}
+
+    template <typename Iter>
+    HashSet(const Iter& a, const Iter& b) : HashSet() {
+        insert(a, b);
+    }
+
+    HashSet(const HashSet&) = delete;
+    HashSet& operator=(const HashSet&) = delete;
+
+    /**
+     * Inserts the given element, returning true if it has not been present before.
+     */
+    bool insert(const Key& key) {
+        const std::size_t h = hash(key);
+        Shard& shard = getShard(h);
+        shard.lock.start_write();
+
+        // keep the load factor below 1/2
+        if (2 * (shard.count + 1) > shard.slots.size()) {
+            grow(shard);
+        }
+
+        const std::size_t mask = shard.slots.size() - 1;
+        for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+            Slot& slot = shard.slots[i];
+            if (slot.pos == 0) {
+                slot.hash = h;
+                slot.pos = storage.append(key) + 1;
+                shard.count++;
+                shard.lock.end_write();
+                return true;
+            }
+            if (slot.hash == h && equal(storage.get(slot.pos - 1), key)) {
+                shard.lock.end_write();
+                return false;
+            }
+        }
+    }
+
+    bool insert(const Key& key, operation_hints&) {
+        return insert(key);
+    }
+
+    /**
+     * Inserts all elements of the given range.
+     */
+    template <typename Iter>
+    void insert(const Iter& a, const Iter& b) {
+        for (auto it = a; it != b; ++it) {
+            insert(*it);
+        }
+    }
+
+    /**
+     * Inserts all elements of the given hash set.
+     */
+    void insertAll(const HashSet& other) {
+        insert(other.begin(), other.end());
+    }
+
+    bool contains(const Key& key) const {
+        return locate(key) != 0;
+    }
+
+    bool contains(const Key& key, operation_hints&) const {
+        return contains(key);
+    }
+
+    iterator find(const Key& key) const {
+        const std::size_t pos = locate(key);
+        return (pos == 0) ? end() : iterator(&storage, pos - 1);
+    }
+
+    iterator find(const Key& key, operation_hints&) const {
+        return find(key);
+    }
+
+    /**
+     * Obtains an iterator to the given element or end() if it is not present.
+     */
+    iterator lower_bound(const Key& key) const {
+        return find(key);
+    }
+
+    iterator lower_bound(const Key& key, operation_hints&) const {
+        return lower_bound(key);
+    }
+
+    /**
+     * Obtains an iterator past the given element or end() if it is not present.
+     */
+    iterator upper_bound(const Key& key) const {
+        auto res = find(key);
+        if (res != end()) {
+            ++res;
+        }
+        return res;
+    }
+
+    iterator upper_bound(const Key& key, operation_hints&) const {
+        return upper_bound(key);
+    }
+
+    iterator begin() const {
+        return iterator(&storage, 0);
+    }
+
+    iterator end() const {
+        return iterator(&storage, storage.size());
+    }
+
+    std::size_t size() const {
+        return storage.size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * Removes all elements. Must not be invoked concurrently with any other operation.
+     */
+    void clear() {
+        for (auto& shard : shards) {
+            shard.slots.clear();
+            shard.count = 0;
+        }
+        storage.clear();
+    }
+
+    /**
+     * Splits the elements of this set into (at most) the given number of
+     * consecutive ranges to be processed in parallel.
+     */
+    std::vector<range<iterator>> partition(std::size_t num) const {
+        std::vector<range<iterator>> res;
+        const std::size_t total = size();
+        if (total == 0) {
+            return res;
+        }
+        num = std::max<std::size_t>(1, std::min(num, total));
+        const std::size_t step = (total + num - 1) / num;
+        for (std::size_t i = 0; i < total; i += step) {
+            res.push_back(make_range(iterator(&storage, i), iterator(&storage, std::min(i + step, total))));
+        }
+        return res;
+    }
+
+    std::vector<range<iterator>> getChunks(std::size_t num) const {
+        return partition(num);
+    }
+
+    /**
+     * Prints a summary of the occupancy of this set.
+     */
+    void printStats(std::ostream& out = std::cout) const {
+        std::size_t capacity = 0;
+        std::size_t maxCount = 0;
+        for (const auto& shard : shards) {
+            capacity += shard.slots.size();
+            maxCount = std::max(maxCount, shard.count);
+        }
+        out << "---------------------------------\n";
+        out << "  Elements: " << size() << "\n";
+        out << "  Shards: " << numShards << "\n";
+        out << "  Slots: " << capacity << "\n";
+        out << "  Load factor: " << (capacity == 0 ? 0.0 : double(size()) / capacity) << "\n";
+        out << "  Largest shard: " << maxCount << "\n";
+        out << "---------------------------------\n";
+    }
+
+private:
+    // the element storage, providing stable addresses
+    PiggyList<Key> storage;
+
+    // the shards of the hash table
+    std::array<Shard, numShards> shards;
+
+    Hash hasher;
+    Equal equal;
+
+    std::size_t hash(const Key& key) const {
+        return hasher(key);
+    }
+
+    Shard& getShard(std::size_t h) {
+        return shards[(h >> (8 * sizeof(std::size_t) - shardBits)) & (numShards - 1)];
+    }
+
+    const Shard& getShard(std::size_t h) const {
+        return shards[(h >> (8 * sizeof(std::size_t) - shardBits)) & (numShards - 1)];
+    }
+
+    /**
+     * Obtains the storage position of the given element, offset by one, or
+     * zero if the element is not present.
+     */
+    std::size_t locate(const Key& key) const {
+        const std::size_t h = hash(key);
+        const Shard& shard = getShard(h);
+        shard.lock.start_read();
+
+        std::size_t res = 0;
+        if (!shard.slots.empty()) {
+            const std::size_t mask = shard.slots.size() - 1;
+            for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+                const Slot& slot = shard.slots[i];
+                if (slot.pos == 0) {
+                    break;
+                }
+                if (slot.hash == h && equal(storage.get(slot.pos - 1), key)) {
+                    res = slot.pos;
+                    break;
+                }
+            }
+        }
+
+        shard.lock.end_read();
+        return res;
+    }
+
+    /**
+     * Doubles the number of slots of the given shard. The caller must hold
+     * the write lock of the shard.
+     */
+    static void grow(Shard& shard) {
+        const std::size_t capacity = std::max(initialShardCapacity, 2 * shard.slots.size());
+        std::vector<Slot> slots(capacity);
+        const std::size_t mask = capacity - 1;
+        for (const auto& cur : shard.slots) {
+            if (cur.pos == 0) {
+                continue;
+            }
+            std::size_t i = cur.hash & mask;
+            while (slots[i].pos != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = cur;
+        }
+        shard.slots.swap(slots);
+    }
+};
+
+}  // namespace souffle
@@ -18,7 +18,9 @@
 #include "souffle/SymbolTable.h"
 #include "souffle/io/ReadStream.h"
 #include "souffle/io/ReadStreamCSV.h"
+#include "souffle/io/ReadStreamFacts.h"
 #include "souffle/io/ReadStreamJSON.h"
+#include "souffle/io/ReadStreamJSONL.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/io/WriteStreamCSV.h"
 #include "souffle/io/WriteStreamJSON.h"
@@ -81,6 +83,8 @@ private:
         registerReadStreamFactory(std::make_shared<ReadCinCSVFactory>());
         registerReadStreamFactory(std::make_shared<ReadFileJSONFactory>());
         registerReadStreamFactory(std::make_shared<ReadCinJSONFactory>());
+        registerReadStreamFactory(std::make_shared<ReadFileJSONLFactory>());
+        registerReadStreamFactory(std::make_shared<ReadFactsFactory>());
         registerWriteStreamFactory(std::make_shared<WriteFileCSVFactory>());
         registerWriteStreamFactory(std::make_shared<WriteCoutCSVFactory>());
         registerWriteStreamFactory(std::make_shared<WriteCoutPrintSizeFactory>());
@@ -250,6 +250,9 @@ public:
         if (!fileHandle.is_open()) {
             throw std::invalid_argument("Cannot open fact file " + baseName + "\n");
         }
+#ifdef USE_LIBZ
+        fileHandle.setThreads(std::stoul(getOr(rwOperation, "jobs", "1")));
+#endif
         // Strip headers if we're using them
         if (getOr(rwOperation, "headers", "false") == "true") {
             std::string line;
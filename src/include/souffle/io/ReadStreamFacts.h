@@ -0,0 +1,191 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamFacts.h
+ *
+ * Reads the facts of a relation that are embedded in the program
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/ReadStream.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StringUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle {
+class RecordTable;
+
+/**
+ * A table of facts stored column by column
+ *
+ * The encoding of a table is its arity and its number of rows, followed by
+ * its columns. Each column is prefixed by its length, and each value of a
+ * column is prefixed by its length as well, e.g. `2:2:6:1:a1:b6:1:11:2`
+ * holds the rows (a, 1) and (b, 2). Values are kept as text and are
+ * converted with the types of the relation when they are read.
+ */
+class FactTable {
+public:
+    explicit FactTable(std::size_t arity) : columns(arity) {}
+
+    /** Decode a table */
+    static FactTable decode(const std::string& encoding) {
+        std::size_t pos = 0;
+        FactTable table(readLength(encoding, pos));
+        table.rows = readLength(encoding, pos);
+        for (auto& column : table.columns) {
+            std::size_t length = readLength(encoding, pos);
+            if (pos + length > encoding.size()) {
+                throw std::invalid_argument("Truncated column in embedded facts");
+            }
+            column = encoding.substr(pos, length);
+            pos += length;
+        }
+        return table;
+    }
+
+    /** Encode the table as a string */
+    std::string encode() const {
+        std::stringstream out;
+        out << columns.size() << ':' << rows << ':';
+        for (const auto& column : columns) {
+            out << column.size() << ':' << column;
+        }
+        return out.str();
+    }
+
+    /** Append a row of values, one for each column */
+    void addRow(const std::vector<std::string>& row) {
+        assert(row.size() == columns.size() && "mismatching arity of embedded fact");
+        for (std::size_t i = 0; i < row.size(); i++) {
+            columns[i] += std::to_string(row[i].size());
+            columns[i] += ':';
+            columns[i] += row[i];
+        }
+        rows++;
+    }
+
+    std::size_t getArity() const {
+        return columns.size();
+    }
+
+    std::size_t size() const {
+        return rows;
+    }
+
+    /** Return the next value of a column, starting at the given position */
+    std::string nextValue(std::size_t column, std::size_t& pos) const {
+        const std::string& values = columns[column];
+        std::size_t length = readLength(values, pos);
+        std::string value = values.substr(pos, length);
+        pos += length;
+        return value;
+    }
+
+private:
+    static std::size_t readLength(const std::string& encoding, std::size_t& pos) {
+        std::size_t end = encoding.find(':', pos);
+        if (end == std::string::npos || end == pos) {
+            throw std::invalid_argument("Malformed length in embedded facts");
+        }
+        std::size_t length = std::stoull(encoding.substr(pos, end - pos));
+        pos = end + 1;
+        return length;
+    }
+
+    /** Concatenated values of each column */
+    std::vector<std::string> columns;
+
+    /** Number of rows */
+    std::size_t rows = 0;
+};
+
+class ReadStreamFacts : public ReadStream {
+public:
+    ReadStreamFacts(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable)
+            : ReadStream(rwOperation, symbolTable, recordTable),
+              table(FactTable::decode(rwOperation.at("facts"))), positions(table.getArity(), 0) {
+        if (table.getArity() != arity) {
+            throw std::invalid_argument("Embedded facts of relation " + rwOperation.at("name") +
+                                        " do not match its arity");
+        }
+    }
+
+protected:
+    /**
+     * Read and return the next tuple.
+     *
+     * Returns nullptr if no tuple was readable.
+     * @return
+     */
+    Own<RamDomain[]> readNextTuple() override {
+        if (row == table.size()) {
+            return nullptr;
+        }
+        Own<RamDomain[]> tuple = mk<RamDomain[]>(typeAttributes.size());
+        for (std::size_t column = 0; column < arity; column++) {
+            std::string element = table.nextValue(column, positions[column]);
+            try {
+                switch (typeAttributes.at(column)[0]) {
+                    case 's': tuple[column] = symbolTable.unsafeLookup(element); break;
+                    case 'i': tuple[column] = RamSignedFromString(element, nullptr, 0); break;
+                    case 'u': tuple[column] = ramBitCast(RamUnsignedFromString(element, nullptr, 0)); break;
+                    case 'f': tuple[column] = ramBitCast(RamFloatFromString(element)); break;
+                    default: fatal("invalid type attribute: `%c`", typeAttributes[column][0]);
+                }
+            } catch (...) {
+                std::stringstream errorMessage;
+                errorMessage << "Error converting <" + element + "> in column " << column + 1
+                             << " of embedded fact " << row + 1 << "; ";
+                throw std::invalid_argument(errorMessage.str());
+            }
+        }
+        ++row;
+        return tuple;
+    }
+
+    const FactTable table;
+
+    /** Position of the next value in each column */
+    std::vector<std::size_t> positions;
+
+    /** Number of rows read */
+    std::size_t row = 0;
+};
+
+class ReadFactsFactory : public ReadStreamFactory {
+public:
+    Own<ReadStream> getReader(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable) override {
+        return mk<ReadStreamFacts>(rwOperation, symbolTable, recordTable);
+    }
+
+    const std::string& getName() const override {
+        static const std::string name = "facts";
+        return name;
+    }
+
+    ~ReadFactsFactory() override = default;
+};
+
+} /* namespace souffle */
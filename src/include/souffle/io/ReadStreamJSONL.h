@@ -0,0 +1,520 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamJSONL.h
+ *
+ * Reads JSON lines, one tuple per line, without building a JSON document
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/ReadStream.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/FileUtil.h"
+#include "souffle/utility/StringUtil.h"
+#ifdef USE_LIBZ
+#include "souffle/io/gzfstream.h"
+#endif
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Reads a relation from JSON lines
+ *
+ * Each non-empty line holds one tuple, either as an array of its attributes,
+ * e.g. `[1, "a", [2, null]]`, or as an object mapping the names of all its
+ * attributes to their values, e.g. `{"x": 1, "y": "a", "z": {"p": 2, "q": null}}`.
+ * Records are written in the same way, or as null for nil. A value of an ADT is
+ * an object mapping its branch to the array of its arguments, e.g.
+ * `{"Cons": [1, {"Nil": []}]}`, or the name of its branch if the branch has no
+ * arguments, e.g. `"Nil"`.
+ *
+ * The values are parsed into tuples as the line is scanned, guided by the types
+ * of the attributes, so only a single line is held in memory at any time.
+ */
+class ReadStreamJSONL : public ReadStream {
+public:
+    ReadStreamJSONL(std::istream& file, const std::map<std::string, std::string>& rwOperation,
+            SymbolTable& symbolTable, RecordTable& recordTable)
+            : ReadStream(rwOperation, symbolTable, recordTable), file(file) {
+        std::string err;
+        params = Json::parse(rwOperation.at("params"), err);
+        if (err.length() > 0) {
+            throw std::invalid_argument("cannot get internal params: " + err);
+        }
+        std::size_t index = 0;
+        for (const auto& param : params["relation"]["params"].array_items()) {
+            attributeIndex[param.string_value()] = index++;
+        }
+    }
+
+protected:
+    /** Record type, with the positions of its fields by name */
+    struct RecordInfo {
+        std::vector<std::string> types;
+        std::map<std::string, std::size_t> fields;
+    };
+
+    /** Branch of an ADT */
+    struct BranchInfo {
+        RamDomain id;
+        std::vector<std::string> types;
+    };
+
+    /** ADT type, with its branches by name */
+    struct ADTInfo {
+        bool isEnum;
+        std::map<std::string, BranchInfo> branches;
+    };
+
+    /**
+     * Read and return the next tuple.
+     *
+     * Returns nullptr if no tuple was readable.
+     * @return
+     */
+    Own<RamDomain[]> readNextTuple() override {
+        while (getline(file, line)) {
+            ++lineNumber;
+            pos = 0;
+            skipWhiteSpace();
+            if (pos == line.size()) {
+                continue;
+            }
+
+            Own<RamDomain[]> tuple = mk<RamDomain[]>(typeAttributes.size());
+            try {
+                if (peek() == '[') {
+                    consumeChar('[');
+                    for (std::size_t i = 0; i < arity; ++i) {
+                        if (i > 0) {
+                            consumeChar(',');
+                        }
+                        tuple[i] = readValue(typeAttributes[i]);
+                    }
+                    consumeChar(']');
+                } else {
+                    readObject(attributeIndex, arity,
+                            [&](std::size_t i) { tuple[i] = readValue(typeAttributes[i]); });
+                }
+                skipWhiteSpace();
+                if (pos != line.size()) {
+                    throw std::invalid_argument("Unexpected characters after the tuple");
+                }
+            } catch (std::exception& e) {
+                std::stringstream errorMessage;
+                errorMessage << "Error in line " << lineNumber << " at column " << pos + 1 << ": "
+                             << e.what();
+                throw std::invalid_argument(errorMessage.str());
+            }
+            return tuple;
+        }
+        return nullptr;
+    }
+
+    /** Read a value of the given type */
+    RamDomain readValue(const std::string& type) {
+        switch (type[0]) {
+            case 's': return symbolTable.unsafeLookup(readString());
+            case 'i': {
+                const std::string number = readNumber();
+                std::size_t charactersRead = 0;
+                RamDomain value = RamSignedFromString(number, &charactersRead);
+                checkNumber(number, charactersRead);
+                return value;
+            }
+            case 'u': {
+                const std::string number = readNumber();
+                std::size_t charactersRead = 0;
+                RamDomain value = ramBitCast(RamUnsignedFromString(number, &charactersRead));
+                checkNumber(number, charactersRead);
+                return value;
+            }
+            case 'f': {
+                const std::string number = readNumber();
+                std::size_t charactersRead = 0;
+                RamDomain value = ramBitCast(RamFloatFromString(number, &charactersRead));
+                checkNumber(number, charactersRead);
+                return value;
+            }
+            case 'r': return readRecordValue(type);
+            case '+': return readADTValue(type);
+            default: throw std::invalid_argument("Invalid type attribute: " + type);
+        }
+    }
+
+    RamDomain readRecordValue(const std::string& type) {
+        const RecordInfo& info = getRecordInfo(type);
+        skipWhiteSpace();
+        if (line.compare(pos, 4, "null") == 0) {
+            pos += 4;
+            return 0;
+        }
+
+        std::vector<RamDomain> values(info.types.size());
+        if (peek() == '[') {
+            consumeChar('[');
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) {
+                    consumeChar(',');
+                }
+                values[i] = readValue(info.types[i]);
+            }
+            consumeChar(']');
+        } else {
+            readObject(info.fields, values.size(),
+                    [&](std::size_t i) { values[i] = readValue(info.types[i]); });
+        }
+        return recordTable.pack(values.data(), values.size());
+    }
+
+    RamDomain readADTValue(const std::string& type) {
+        const ADTInfo& info = getADTInfo(type);
+        skipWhiteSpace();
+        const bool hasArguments = peek() == '{';
+        if (hasArguments) {
+            consumeChar('{');
+        }
+        const std::string name = readString();
+        auto branch = info.branches.find(name);
+        if (branch == info.branches.end()) {
+            throw std::invalid_argument("Unknown branch " + name + " of " + type);
+        }
+        const std::vector<std::string>& types = branch->second.types;
+        const RamDomain id = branch->second.id;
+
+        std::vector<RamDomain> arguments(types.size());
+        if (hasArguments) {
+            consumeChar(':');
+            consumeChar('[');
+            for (std::size_t i = 0; i < arguments.size(); ++i) {
+                if (i > 0) {
+                    consumeChar(',');
+                }
+                arguments[i] = readValue(types[i]);
+            }
+            consumeChar(']');
+            consumeChar('}');
+        } else if (!arguments.empty()) {
+            throw std::invalid_argument("Missing arguments of branch " + name);
+        }
+
+        // encode the branch as ReadStream::readADT does
+        if (arguments.empty()) {
+            if (info.isEnum) {
+                return id;
+            }
+            RamDomain emptyArgs = recordTable.pack(toVector<RamDomain>().data(), 0);
+            return recordTable.pack(toVector<RamDomain>(id, emptyArgs).data(), 2);
+        }
+        RamDomain branchValue = arguments.size() == 1
+                                        ? arguments[0]
+                                        : recordTable.pack(arguments.data(), arguments.size());
+        return recordTable.pack(toVector<RamDomain>(id, branchValue).data(), 2);
+    }
+
+    /**
+     * Read an object that has a member for each of the given names, reading the value
+     * of a member by its position.
+     */
+    template <typename F>
+    void readObject(const std::map<std::string, std::size_t>& names, std::size_t size, F readMember) {
+        std::vector<bool> seen(size, false);
+        std::size_t count = 0;
+        consumeChar('{');
+        skipWhiteSpace();
+        if (peek() != '}') {
+            do {
+                const std::string name = readString();
+                auto member = names.find(name);
+                if (member == names.end() || member->second >= size) {
+                    throw std::invalid_argument("Unknown attribute " + name);
+                }
+                if (seen[member->second]) {
+                    throw std::invalid_argument("Duplicate attribute " + name);
+                }
+                seen[member->second] = true;
+                ++count;
+                consumeChar(':');
+                readMember(member->second);
+                skipWhiteSpace();
+            } while (peek() == ',' && ++pos);
+        }
+        consumeChar('}');
+        if (count != size) {
+            throw std::invalid_argument("Missing attributes");
+        }
+    }
+
+    /** Read a JSON string, resolving its escape sequences */
+    std::string readString() {
+        consumeChar('"');
+        std::string result;
+        while (true) {
+            if (pos >= line.size()) {
+                throw std::invalid_argument("Unterminated string");
+            }
+            char c = line[pos++];
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos >= line.size()) {
+                throw std::invalid_argument("Unterminated string");
+            }
+            c = line[pos++];
+            switch (c) {
+                case '"':
+                case '\\':
+                case '/': result += c; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = readHex4();
+                    // combine surrogate pairs
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && line.compare(pos, 2, "\\u") == 0) {
+                        pos += 2;
+                        uint32_t low = readHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            throw std::invalid_argument("Invalid surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUTF8(result, codePoint);
+                    break;
+                }
+                default: throw std::invalid_argument(std::string("Invalid escape sequence \\") + c);
+            }
+        }
+    }
+
+    uint32_t readHex4() {
+        if (pos + 4 > line.size()) {
+            throw std::invalid_argument("Invalid unicode escape sequence");
+        }
+        uint32_t value = 0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            const char c = line[pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                value |= c - 'A' + 10;
+            } else {
+                throw std::invalid_argument("Invalid unicode escape sequence");
+            }
+        }
+        return value;
+    }
+
+    static void appendUTF8(std::string& result, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            result += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            result += static_cast<char>(0xC0 | (codePoint >> 6));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            result += static_cast<char>(0xE0 | (codePoint >> 12));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            result += static_cast<char>(0xF0 | (codePoint >> 18));
+            result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    /** Read the characters of a JSON number */
+    std::string readNumber() {
+        skipWhiteSpace();
+        const std::size_t start = pos;
+        while (pos < line.size() && isNumberChar(line[pos])) {
+            ++pos;
+        }
+        if (start == pos) {
+            throw std::invalid_argument("Expected a number");
+        }
+        return line.substr(start, pos - start);
+    }
+
+    static bool isNumberChar(char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.' || c == 'e' ||
+               c == 'E';
+    }
+
+    static void checkNumber(const std::string& number, std::size_t charactersRead) {
+        if (charactersRead != number.size()) {
+            throw std::invalid_argument("Invalid number " + number);
+        }
+    }
+
+    const RecordInfo& getRecordInfo(const std::string& type) {
+        auto cached = recordInfos.find(type);
+        if (cached != recordInfos.end()) {
+            return cached->second;
+        }
+        auto&& recordInfo = types["records"][type];
+        if (recordInfo.is_null()) {
+            throw std::invalid_argument("Missing record type information: " + type);
+        }
+        RecordInfo info;
+        for (const auto& fieldType : recordInfo["types"].array_items()) {
+            info.types.push_back(fieldType.string_value());
+        }
+        std::size_t index = 0;
+        for (const auto& param : params["records"][type.substr(2)]["params"].array_items()) {
+            info.fields[param.string_value()] = index++;
+        }
+        return recordInfos.emplace(type, std::move(info)).first->second;
+    }
+
+    const ADTInfo& getADTInfo(const std::string& type) {
+        auto cached = adtInfos.find(type);
+        if (cached != adtInfos.end()) {
+            return cached->second;
+        }
+        auto&& adtInfo = types["ADTs"][type];
+        if (adtInfo.is_null() || !adtInfo["branches"].is_array()) {
+            throw std::invalid_argument("Missing ADT information: " + type);
+        }
+        ADTInfo info;
+        info.isEnum = adtInfo["enum"].bool_value();
+        RamDomain id = 0;
+        for (const auto& branch : adtInfo["branches"].array_items()) {
+            BranchInfo& branchInfo = info.branches[branch["name"].string_value()];
+            branchInfo.id = id++;
+            for (const auto& argType : branch["types"].array_items()) {
+                branchInfo.types.push_back(argType.string_value());
+            }
+        }
+        return adtInfos.emplace(type, std::move(info)).first->second;
+    }
+
+    char peek() const {
+        if (pos >= line.size()) {
+            throw std::invalid_argument("Unexpected end of line");
+        }
+        return line[pos];
+    }
+
+    /** Read past given character, consuming any preceding whitespace */
+    void consumeChar(char c) {
+        skipWhiteSpace();
+        if (peek() != c) {
+            std::stringstream error;
+            error << "Expected: '" << c << "', got: '" << line[pos] << "'";
+            throw std::invalid_argument(error.str());
+        }
+        ++pos;
+    }
+
+    void skipWhiteSpace() {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) {
+            ++pos;
+        }
+    }
+
+    std::istream& file;
+    Json params;
+
+    /** Positions of the attributes of the relation by name */
+    std::map<std::string, std::size_t> attributeIndex;
+
+    std::map<std::string, RecordInfo> recordInfos;
+    std::map<std::string, ADTInfo> adtInfos;
+
+    /** The current line and the position in it */
+    std::string line;
+    std::size_t pos = 0;
+    std::size_t lineNumber = 0;
+};
+
+class ReadFileJSONL : public ReadStreamJSONL {
+public:
+    ReadFileJSONL(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable)
+            : ReadStreamJSONL(fileHandle, rwOperation, symbolTable, recordTable),
+              baseName(souffle::baseName(getFileName(rwOperation))),
+              fileHandle(getFileName(rwOperation), std::ios::in | std::ios::binary) {
+        if (!fileHandle.is_open()) {
+            throw std::invalid_argument("Cannot open json lines file " + baseName + "\n");
+        }
+#ifdef USE_LIBZ
+        fileHandle.setThreads(std::stoul(getOr(rwOperation, "jobs", "1")));
+#endif
+    }
+
+    ~ReadFileJSONL() override = default;
+
+protected:
+    /**
+     * Return given filename or construct from relation name.
+     * Default name is [configured path]/[relation name].jsonl
+     *
+     * @param rwOperation map of IO configuration options
+     * @return input filename
+     */
+    static std::string getFileName(const std::map<std::string, std::string>& rwOperation) {
+        auto name = getOr(rwOperation, "filename", rwOperation.at("name") + ".jsonl");
+        if (name.front() != '/') {
+            name = getOr(rwOperation, "fact-dir", ".") + "/" + name;
+        }
+        return name;
+    }
+
+    std::string baseName;
+#ifdef USE_LIBZ
+    gzfstream::igzfstream fileHandle;
+#else
+    std::ifstream fileHandle;
+#endif
+};
+
+class ReadFileJSONLFactory : public ReadStreamFactory {
+public:
+    Own<ReadStream> getReader(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable) override {
+        return mk<ReadFileJSONL>(rwOperation, symbolTable, recordTable);
+    }
+
+    const std::string& getName() const override {
+        static const std::string name = "jsonl";
+        return name;
+    }
+
+    ~ReadFileJSONLFactory() override = default;
+};
+
+}  // namespace souffle
@@ -38,22 +38,37 @@ public:
             : SerialisationStream(symbolTable, recordTable, rwOperation),
               summary(rwOperation.at("IO") == "stdoutprintsize") {}
 
+    /**
+     * Write all tuples of the relation
+     *
+     * If other threads may add symbols to the symbol table while the relation is written, the
+     * symbol table is locked for each tuple rather than for the whole relation.
+     */
     template <typename T>
-    void writeAll(const T& relation) {
+    void writeAll(const T& relation, bool concurrent = false) {
         if (summary) {
             return writeSize(relation.size());
         }
-        auto lease = symbolTable.acquireLock();
-        (void)lease;  // silence "unused variable" warning
         if (arity == 0) {
             if (relation.begin() != relation.end()) {
                 writeNullary();
             }
-            return;
-        }
-        for (const auto& current : relation) {
-            writeNext(current);
+        } else if (concurrent) {
+            for (const auto& current : relation) {
+                auto lease = symbolTable.acquireLock();
+                (void)lease;  // silence "unused variable" warning
+                writeNext(current);
+            }
+        } else {
+            auto lease = symbolTable.acquireLock();
+            (void)lease;  // silence "unused variable" warning
+            for (const auto& current : relation) {
+                writeNext(current);
+            }
         }
+        auto lease = symbolTable.acquireLock();
+        (void)lease;  // silence "unused variable" warning
+        writeEnd();
     }
 
     template <typename T>
@@ -66,6 +81,8 @@ protected:
 
     virtual void writeNullary() = 0;
     virtual void writeNextTuple(const RamDomain* tuple) = 0;
+    /** Called once all tuples of the relation have been written */
+    virtual void writeEnd() {}
     virtual void writeSize(std::size_t) {
         fatal("attempting to print size of a write operation");
     }
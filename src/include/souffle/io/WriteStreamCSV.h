@@ -24,12 +24,16 @@
 #include "souffle/io/gzfstream.h"
 #endif
 
+#include <charconv>
 #include <cstddef>
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -42,32 +46,114 @@ protected:
     WriteStreamCSV(const std::map<std::string, std::string>& rwOperation, const SymbolTable& symbolTable,
             const RecordTable& recordTable)
             : WriteStream(rwOperation, symbolTable, recordTable),
-              delimiter(getOr(rwOperation, "delimiter", "\t")){};
+              delimiter(getOr(rwOperation, "delimiter", "\t")) {
+        for (std::size_t col = 0; col < arity; ++col) {
+            columnWriters.push_back(getColumnWriter(typeAttributes.at(col)));
+        }
+        buffer.reserve(bufferSize);
+        recordStream << std::setprecision(std::numeric_limits<RamFloat>::max_digits10);
+    };
 
     const std::string delimiter;
 
-    void writeNextTupleCSV(std::ostream& destination, const RamDomain* tuple) {
-        writeNextTupleElement(destination, typeAttributes.at(0), tuple[0]);
+    /** Write a block of formatted output to the destination */
+    virtual void writeBuffer(const char* data, std::size_t size) = 0;
+
+    /** Write out all buffered output */
+    void flush() {
+        if (!buffer.empty()) {
+            writeBuffer(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    void writeNullary() override {
+        buffer += "()\n";
+    }
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        (this->*columnWriters[0])(tuple[0], typeAttributes[0]);
 
         for (std::size_t col = 1; col < arity; ++col) {
-            destination << delimiter;
-            writeNextTupleElement(destination, typeAttributes.at(col), tuple[col]);
+            buffer += delimiter;
+            (this->*columnWriters[col])(tuple[col], typeAttributes[col]);
         }
 
-        destination << "\n";
+        buffer += '\n';
+        if (buffer.size() >= bufferSize) {
+            flush();
+        }
     }
 
-    void writeNextTupleElement(std::ostream& destination, const std::string& type, RamDomain value) {
+    void writeEnd() override {
+        flush();
+    }
+
+private:
+    /** Appends the formatted value of a column of the given type to the buffer */
+    using ColumnWriter = void (WriteStreamCSV::*)(RamDomain value, const std::string& type);
+
+    /** The output is written in blocks of this size */
+    static constexpr std::size_t bufferSize = 1 << 20;
+
+    static ColumnWriter getColumnWriter(const std::string& type) {
         switch (type[0]) {
-            case 's': destination << symbolTable.unsafeResolve(value); break;
-            case 'i': destination << value; break;
-            case 'u': destination << ramBitCast<RamUnsigned>(value); break;
-            case 'f': destination << ramBitCast<RamFloat>(value); break;
-            case 'r': outputRecord(destination, value, type); break;
-            case '+': outputADT(destination, value, type); break;
+            case 's': return &WriteStreamCSV::appendSymbol;
+            case 'i': return &WriteStreamCSV::appendInteger<RamSigned>;
+            case 'u': return &WriteStreamCSV::appendInteger<RamUnsigned>;
+            case 'f': return &WriteStreamCSV::appendFloat;
+            case 'r': return &WriteStreamCSV::appendRecord;
+            case '+': return &WriteStreamCSV::appendADT;
             default: fatal("unsupported type attribute: `%c`", type[0]);
         }
     }
+
+    void appendSymbol(RamDomain value, const std::string&) {
+        buffer += symbolTable.unsafeResolve(value);
+    }
+
+    template <typename T>
+    void appendInteger(RamDomain value, const std::string&) {
+        char chars[24];
+        auto result = std::to_chars(chars, chars + sizeof(chars), ramBitCast<T>(value));
+        buffer.append(chars, result.ptr);
+    }
+
+    /** Formats a float as std::ostream does with the precision of max_digits10 */
+    void appendFloat(RamDomain value, const std::string&) {
+        constexpr int precision = std::numeric_limits<RamFloat>::max_digits10;
+        char chars[32];
+#ifdef __cpp_lib_to_chars
+        auto result = std::to_chars(chars, chars + sizeof(chars), ramBitCast<RamFloat>(value),
+                std::chars_format::general, precision);
+        buffer.append(chars, result.ptr);
+#else
+        int length = std::snprintf(
+                chars, sizeof(chars), "%.*g", precision, static_cast<double>(ramBitCast<RamFloat>(value)));
+        buffer.append(chars, length);
+#endif
+    }
+
+    void appendRecord(RamDomain value, const std::string& type) {
+        recordStream.str("");
+        outputRecord(recordStream, value, type);
+        buffer += recordStream.str();
+    }
+
+    void appendADT(RamDomain value, const std::string& type) {
+        recordStream.str("");
+        outputADT(recordStream, value, type);
+        buffer += recordStream.str();
+    }
+
+    /** The writer of each column, chosen by its type */
+    std::vector<ColumnWriter> columnWriters;
+
+    /** Formatted output that has not been written yet */
+    std::string buffer;
+
+    /** Formats records and ADTs, which are rarely written */
+    std::ostringstream recordStream;
 };
 
 class WriteFileCSV : public WriteStreamCSV {
@@ -79,20 +165,17 @@ public:
         if (getOr(rwOperation, "headers", "false") == "true") {
             file << rwOperation.at("attributeNames") << std::endl;
         }
-        file << std::setprecision(std::numeric_limits<RamFloat>::max_digits10);
     }
 
-    ~WriteFileCSV() override = default;
+    ~WriteFileCSV() override {
+        flush();
+    }
 
 protected:
     std::ofstream file;
 
-    void writeNullary() override {
-        file << "()\n";
-    }
-
-    void writeNextTuple(const RamDomain* tuple) override {
-        writeNextTupleCSV(file, tuple);
+    void writeBuffer(const char* data, std::size_t size) override {
+        file.write(data, size);
     }
 
     /**
@@ -118,21 +201,19 @@ public:
             const RecordTable& recordTable)
             : WriteStreamCSV(rwOperation, symbolTable, recordTable),
               file(getFileName(rwOperation), std::ios::out | std::ios::binary) {
+        file.setThreads(std::stoul(getOr(rwOperation, "jobs", "1")));
         if (getOr(rwOperation, "headers", "false") == "true") {
             file << rwOperation.at("attributeNames") << std::endl;
         }
-        file << std::setprecision(std::numeric_limits<RamFloat>::max_digits10);
     }
 
-    ~WriteGZipFileCSV() override = default;
-
-protected:
-    void writeNullary() override {
-        file << "()\n";
+    ~WriteGZipFileCSV() override {
+        flush();
     }
 
-    void writeNextTuple(const RamDomain* tuple) override {
-        writeNextTupleCSV(file, tuple);
+protected:
+    void writeBuffer(const char* data, std::size_t size) override {
+        file.write(data, size);
     }
 
     /**
@@ -164,20 +245,16 @@ public:
             std::cout << "\n" << rwOperation.at("attributeNames");
         }
         std::cout << "\n===============\n";
-        std::cout << std::setprecision(std::numeric_limits<RamFloat>::max_digits10);
     }
 
     ~WriteCoutCSV() override {
+        flush();
         std::cout << "===============\n";
     }
 
 protected:
-    void writeNullary() override {
-        std::cout << "()\n";
-    }
-
-    void writeNextTuple(const RamDomain* tuple) override {
-        writeNextTupleCSV(std::cout, tuple);
+    void writeBuffer(const char* data, std::size_t size) override {
+        std::cout.write(data, size);
     }
 };
 
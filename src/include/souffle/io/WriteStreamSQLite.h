@@ -17,11 +17,15 @@
 #include "souffle/RamTypes.h"
 #include "souffle/SymbolTable.h"
 #include "souffle/io/WriteStream.h"
+#include "souffle/utility/ContainerUtil.h"
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -38,17 +42,21 @@ public:
     WriteStreamSQLite(const std::map<std::string, std::string>& rwOperation, const SymbolTable& symbolTable,
             const RecordTable& recordTable)
             : WriteStream(rwOperation, symbolTable, recordTable), dbFilename(getFileName(rwOperation)),
-              relationName(rwOperation.at("name")) {
-        openDB();
+              relationName(rwOperation.at("name")), batchSize(getBatchSize(rwOperation)) {
+        openDB(rwOperation);
+        executeSQL("BEGIN TRANSACTION", db);
+        inTransaction = true;
         createTables();
         prepareStatements();
-        //        executeSQL("BEGIN TRANSACTION", db);
     }
 
     ~WriteStreamSQLite() override {
         sqlite3_finalize(insertStatement);
-        sqlite3_finalize(symbolInsertStatement);
-        sqlite3_finalize(symbolSelectStatement);
+        sqlite3_finalize(batchInsertStatement);
+        if (inTransaction) {
+            // the relation has not been written completely, so leave the database as it was
+            sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
         sqlite3_close(db);
     }
 
@@ -57,26 +65,23 @@ protected:
 
     void writeNextTuple(const RamDomain* tuple) override {
         for (std::size_t i = 0; i < arity; i++) {
-            RamDomain value = 0;  // Silence warning
-
-            switch (typeAttributes.at(i)[0]) {
-                case 's': value = getSymbolTableID(tuple[i]); break;
-                default: value = tuple[i]; break;
-            }
-
-#if RAM_DOMAIN_SIZE == 64
-            if (sqlite3_bind_int64(insertStatement, i + 1, value) != SQLITE_OK) {
-#else
-            if (sqlite3_bind_int(insertStatement, i + 1, value) != SQLITE_OK) {
-#endif
-                throwError("SQLite error in sqlite3_bind_text: ");
+            rows.push_back(tuple[i]);
+            // symbols are looked up in the database once per batch
+            if (typeAttributes.at(i)[0] == 's' && dbSymbolTable.emplace(tuple[i], 0).second) {
+                newSymbols.push_back(tuple[i]);
             }
         }
-        if (sqlite3_step(insertStatement) != SQLITE_DONE) {
-            throwError("SQLite error in sqlite3_step: ");
+        if (rows.size() == batchSize * arity) {
+            writeBatch();
+            executeSQL("COMMIT", db);
+            executeSQL("BEGIN TRANSACTION", db);
         }
-        sqlite3_clear_bindings(insertStatement);
-        sqlite3_reset(insertStatement);
+    }
+
+    void writeEnd() override {
+        writeBatch();
+        executeSQL("COMMIT", db);
+        inTransaction = false;
     }
 
 private:
@@ -102,89 +107,149 @@ private:
         throw std::invalid_argument(error.str());
     }
 
-    uint64_t getSymbolTableIDFromDB(int index) {
-        if (sqlite3_bind_text(symbolSelectStatement, 1, symbolTable.unsafeResolve(index).c_str(), -1,
-                    SQLITE_TRANSIENT) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_bind_text: ");
-        }
-        if (sqlite3_step(symbolSelectStatement) != SQLITE_ROW) {
-            throwError("SQLite error in sqlite3_step: ");
+    sqlite3_stmt* prepareStatement(const std::string& sql) {
+        sqlite3_stmt* statement = nullptr;
+        const char* tail = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, &tail) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
         }
-        uint64_t rowid = sqlite3_column_int64(symbolSelectStatement, 0);
-        sqlite3_clear_bindings(symbolSelectStatement);
-        sqlite3_reset(symbolSelectStatement);
-        return rowid;
+        return statement;
     }
-    uint64_t getSymbolTableID(int index) {
-        if (dbSymbolTable.count(index) != 0) {
-            return dbSymbolTable[index];
+
+    void bindValue(sqlite3_stmt* statement, int index, RamDomain value) {
+#if RAM_DOMAIN_SIZE == 64
+        if (sqlite3_bind_int64(statement, index, value) != SQLITE_OK) {
+#else
+        if (sqlite3_bind_int(statement, index, value) != SQLITE_OK) {
+#endif
+            throwError("SQLite error in sqlite3_bind_int: ");
         }
+    }
 
-        if (sqlite3_bind_text(symbolInsertStatement, 1, symbolTable.unsafeResolve(index).c_str(), -1,
+    void bindSymbol(sqlite3_stmt* statement, int index, RamDomain symbol) {
+        if (sqlite3_bind_text(statement, index, symbolTable.unsafeResolve(symbol).c_str(), -1,
                     SQLITE_TRANSIENT) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_bind_text: ");
         }
-        // Either the insert succeeds and we have a new row id or it already exists and a select is needed.
-        uint64_t rowid;
-        if (sqlite3_step(symbolInsertStatement) != SQLITE_DONE) {
-            // The symbol already exists so select it.
-            rowid = getSymbolTableIDFromDB(index);
-        } else {
-            rowid = sqlite3_last_insert_rowid(db);
+    }
+
+    /**
+     * Insert the buffered rows, using the multi-row insert statement for as many rows as possible
+     */
+    void writeBatch() {
+        resolveSymbols();
+        const std::size_t rowCount = (arity == 0) ? 0 : rows.size() / arity;
+        std::size_t row = 0;
+        for (; row + rowsPerInsert <= rowCount; row += rowsPerInsert) {
+            insertRows(batchInsertStatement, row, rowsPerInsert);
+        }
+        for (; row < rowCount; ++row) {
+            insertRows(insertStatement, row, 1);
         }
-        sqlite3_clear_bindings(symbolInsertStatement);
-        sqlite3_reset(symbolInsertStatement);
+        rows.clear();
+    }
 
-        dbSymbolTable[index] = rowid;
-        return rowid;
+    void insertRows(sqlite3_stmt* statement, std::size_t first, std::size_t count) {
+        int index = 1;
+        for (std::size_t row = first; row < first + count; ++row) {
+            for (std::size_t i = 0; i < arity; i++) {
+                RamDomain value = rows[row * arity + i];
+                if (typeAttributes.at(i)[0] == 's') {
+                    value = dbSymbolTable[value];
+                }
+                bindValue(statement, index++, value);
+            }
+        }
+        if (sqlite3_step(statement) != SQLITE_DONE) {
+            throwError("SQLite error in sqlite3_step: ");
+        }
+        sqlite3_reset(statement);
     }
 
-    void openDB() {
+    /**
+     * Insert the symbols that are new to this writer into the symbol table of the database
+     * and look up their ids, as many symbols per statement as SQLite permits.
+     */
+    void resolveSymbols() {
+        for (std::size_t first = 0; first < newSymbols.size(); first += maxVariables) {
+            const std::size_t count = std::min(maxVariables, newSymbols.size() - first);
+
+            std::stringstream insertSQL;
+            std::stringstream selectSQL;
+            insertSQL << "INSERT OR IGNORE INTO '" << symbolTableName << "' (symbol) VALUES (?)";
+            selectSQL << "SELECT id, symbol FROM '" << symbolTableName << "' WHERE symbol IN (?";
+            for (std::size_t i = 1; i < count; i++) {
+                insertSQL << ",(?)";
+                selectSQL << ",?";
+            }
+            selectSQL << ");";
+
+            sqlite3_stmt* symbolInsertStatement = prepareStatement(insertSQL.str());
+            for (std::size_t i = 0; i < count; i++) {
+                bindSymbol(symbolInsertStatement, i + 1, newSymbols[first + i]);
+            }
+            int rc = sqlite3_step(symbolInsertStatement);
+            sqlite3_finalize(symbolInsertStatement);
+            if (rc != SQLITE_DONE) {
+                throwError("SQLite error in sqlite3_step: ");
+            }
+
+            std::unordered_map<std::string, RamDomain> symbols;
+            sqlite3_stmt* symbolSelectStatement = prepareStatement(selectSQL.str());
+            for (std::size_t i = 0; i < count; i++) {
+                RamDomain symbol = newSymbols[first + i];
+                symbols[symbolTable.unsafeResolve(symbol)] = symbol;
+                bindSymbol(symbolSelectStatement, i + 1, symbol);
+            }
+            while ((rc = sqlite3_step(symbolSelectStatement)) == SQLITE_ROW) {
+                auto text = reinterpret_cast<const char*>(sqlite3_column_text(symbolSelectStatement, 1));
+                dbSymbolTable[symbols.at(text)] = sqlite3_column_int64(symbolSelectStatement, 0);
+            }
+            sqlite3_finalize(symbolSelectStatement);
+            if (rc != SQLITE_DONE) {
+                throwError("SQLite error in sqlite3_step: ");
+            }
+        }
+        newSymbols.clear();
+    }
+
+    void openDB(const std::map<std::string, std::string>& rwOperation) {
         if (sqlite3_open(dbFilename.c_str(), &db) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_open");
         }
         sqlite3_extended_result_codes(db, 1);
-        executeSQL("PRAGMA synchronous = OFF", db);
-        executeSQL("PRAGMA journal_mode = MEMORY", db);
+        executeSQL("PRAGMA synchronous = " +
+                           getPragma(rwOperation, "synchronous", "OFF", {"OFF", "NORMAL", "FULL", "EXTRA"}),
+                db);
+        executeSQL("PRAGMA journal_mode = " +
+                           getPragma(rwOperation, "journalmode", "MEMORY",
+                                   {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"}),
+                db);
+        maxVariables = sqlite3_limit(db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
     }
 
     void prepareStatements() {
-        prepareInsertStatement();
-        prepareSymbolInsertStatement();
-        prepareSymbolSelectStatement();
-    }
-    void prepareSymbolInsertStatement() {
-        std::stringstream insertSQL;
-        insertSQL << "INSERT INTO " << symbolTableName;
-        insertSQL << " VALUES(null,@V0);";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &symbolInsertStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
-        }
-    }
-
-    void prepareSymbolSelectStatement() {
-        std::stringstream selectSQL;
-        selectSQL << "SELECT id FROM " << symbolTableName;
-        selectSQL << " WHERE symbol = @V0;";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &symbolSelectStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+        if (arity == 0) {
+            return;
         }
+        rowsPerInsert = std::max<std::size_t>(1, std::min(maxRowsPerInsert, maxVariables / arity));
+        insertStatement = prepareStatement(getInsertSQL(1));
+        batchInsertStatement = prepareStatement(getInsertSQL(rowsPerInsert));
     }
 
-    void prepareInsertStatement() {
+    /** Return the SQL inserting the given number of rows into the relation table */
+    std::string getInsertSQL(std::size_t rowCount) const {
         std::stringstream insertSQL;
         insertSQL << "INSERT INTO '_" << relationName << "' VALUES ";
-        insertSQL << "(@V0";
-        for (unsigned int i = 1; i < arity; i++) {
-            insertSQL << ",@V" << i;
-        }
-        insertSQL << ");";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &insertStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+        for (std::size_t row = 0; row < rowCount; row++) {
+            insertSQL << (row == 0 ? "(?" : ",(?");
+            for (std::size_t i = 1; i < arity; i++) {
+                insertSQL << ",?";
+            }
+            insertSQL << ")";
         }
+        insertSQL << ";";
+        return insertSQL.str();
     }
 
     void createTables() {
@@ -269,14 +334,70 @@ private:
         return name;
     }
 
+    /**
+     * Return the number of rows that are written per transaction
+     *
+     * @param rwOperation map of IO configuration options
+     * @return the batch size
+     */
+    static std::size_t getBatchSize(const std::map<std::string, std::string>& rwOperation) {
+        const std::string value = getOr(rwOperation, "batchsize", "100000");
+        std::size_t pos = 0;
+        std::size_t batchSize = 0;
+        try {
+            batchSize = std::stoull(value, &pos);
+        } catch (...) {
+        }
+        if (batchSize == 0 || pos != value.size()) {
+            throw std::invalid_argument("Invalid batchsize of SQLite output: " + value);
+        }
+        return batchSize;
+    }
+
+    /**
+     * Return the value of a pragma option, which must be one of the given values
+     *
+     * @param rwOperation map of IO configuration options
+     * @return the upper case value of the option
+     */
+    static std::string getPragma(const std::map<std::string, std::string>& rwOperation, const std::string& key,
+            const std::string& defaultValue, const std::set<std::string>& values) {
+        std::string value = getOr(rwOperation, key, defaultValue);
+        std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+        if (values.count(value) == 0) {
+            throw std::invalid_argument("Invalid " + key + " of SQLite output: " + value);
+        }
+        return value;
+    }
+
+    /** Maximum number of rows of a multi-row insert statement */
+    static constexpr std::size_t maxRowsPerInsert = 256;
+
     const std::string dbFilename;
     const std::string relationName;
     const std::string symbolTableName = "__SymbolTable";
 
+    /** Number of rows written per transaction */
+    const std::size_t batchSize;
+
+    /** Maximum number of parameters of a statement */
+    std::size_t maxVariables = 0;
+
+    /** Number of rows of the multi-row insert statement */
+    std::size_t rowsPerInsert = 1;
+
+    /** Whether a transaction is open that has not been committed */
+    bool inTransaction = false;
+
+    /** The buffered rows of the current batch */
+    std::vector<RamDomain> rows;
+
+    /** Symbols of the current batch that have not been looked up in the database */
+    std::vector<RamDomain> newSymbols;
+
     std::unordered_map<uint64_t, uint64_t> dbSymbolTable;
     sqlite3_stmt* insertStatement = nullptr;
-    sqlite3_stmt* symbolInsertStatement = nullptr;
-    sqlite3_stmt* symbolSelectStatement = nullptr;
+    sqlite3_stmt* batchInsertStatement = nullptr;
     sqlite3* db = nullptr;
 };
 
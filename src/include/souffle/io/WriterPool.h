@@ -0,0 +1,258 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriterPool.h
+ *
+ * Writes output relations in the background while evaluation continues
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Runs the tasks writing output relations in the background
+ *
+ * The outputs are queued and written by a fixed number of worker threads, one per job of
+ * the program, while evaluation continues. Outputs to the same file or database are
+ * written one after another, as e.g. a SQLite database accepts a single writer at a time.
+ * A relation must not be modified while it is written: wait() has to be called before a
+ * relation is changed or destroyed, and waitAll() before the program finishes.
+ *
+ * Outputs to the terminal are written immediately to keep their order. With a single job,
+ * or without parallel execution, where the symbol table is not synchronised, all outputs
+ * are written immediately. A task that fails reports its error and exits the program when
+ * it is waited for.
+ */
+class WriterPool {
+public:
+    /**
+     * @param jobs the number of jobs of the program, or 0 for all cores
+     */
+    explicit WriterPool(std::size_t jobs = 1) {
+        setJobs(jobs);
+    }
+
+    WriterPool(const WriterPool&) = delete;
+    WriterPool& operator=(const WriterPool&) = delete;
+
+    ~WriterPool() {
+        waitAll();
+        stopWorkers();
+    }
+
+    /** Set the number of jobs of the program, or 0 for all cores, after all outputs are written */
+    void setJobs(std::size_t jobs) {
+        const std::size_t threads =
+                jobs > 0 ? jobs : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        if (threads == numThreads) {
+            return;
+        }
+        waitAll();
+        stopWorkers();
+        numThreads = threads;
+    }
+
+    /** The number of threads that outputs and inputs may use */
+    std::size_t getNumThreads() const {
+        return numThreads;
+    }
+
+    /**
+     * Write a relation with the given IO directive
+     *
+     * @param relation the relation that is written
+     * @param directive the IO directive of the output
+     * @param task writes the relation, and receives whether symbols may be added concurrently
+     */
+    template <typename Task>
+    void write(const void* relation, const std::map<std::string, std::string>& directive, Task task) {
+#ifdef IS_PARALLEL
+        auto io = directive.find("IO");
+        if (numThreads > 1 && (io == directive.end() || io->second.rfind("stdout", 0) != 0)) {
+            Job job{getTarget(directive), std::packaged_task<void()>([task]() { task(true); })};
+            std::lock_guard<std::mutex> guard(lock);
+            writers.emplace(relation, job.task.get_future().share());
+            if (workers.empty()) {
+                for (std::size_t i = 0; i < numThreads; ++i) {
+                    workers.emplace_back([this]() { work(); });
+                }
+            }
+            // an output waits behind the pending outputs to its file or database
+            auto pos = job.target.empty() ? blocked.end() : blocked.find(job.target);
+            if (pos != blocked.end()) {
+                pos->second.push_back(std::move(job));
+                return;
+            }
+            if (!job.target.empty()) {
+                blocked[job.target];
+            }
+            queue.push_back(std::move(job));
+            available.notify_one();
+            return;
+        }
+#endif
+        (void)relation;
+        (void)directive;
+        try {
+            task(false);
+        } catch (std::exception& e) {
+            fail(e);
+        }
+    }
+
+    /** Wait until the outputs of the relation have been written */
+    void wait(const void* relation) {
+        std::vector<std::shared_future<void>> done;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto range = writers.equal_range(relation);
+            for (auto it = range.first; it != range.second; ++it) {
+                done.push_back(std::move(it->second));
+            }
+            writers.erase(range.first, range.second);
+        }
+        finish(done);
+    }
+
+    /** Wait until all outputs have been written */
+    void waitAll() {
+        std::vector<std::shared_future<void>> done;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto& writer : writers) {
+                done.push_back(std::move(writer.second));
+            }
+            writers.clear();
+        }
+        finish(done);
+    }
+
+private:
+    /** A queued output, and the file or database it writes */
+    struct Job {
+        std::string target;
+        std::packaged_task<void()> task;
+    };
+
+    /** Run queued outputs until the workers are stopped */
+    void work() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                available.wait(guard, [&]() { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job.task();
+            if (job.target.empty()) {
+                continue;
+            }
+            // release the next output to the same file or database
+            std::lock_guard<std::mutex> guard(lock);
+            auto pos = blocked.find(job.target);
+            if (pos->second.empty()) {
+                blocked.erase(pos);
+            } else {
+                queue.push_back(std::move(pos->second.front()));
+                pos->second.pop_front();
+                available.notify_one();
+            }
+        }
+    }
+
+    /** Stop the workers once the queue is empty */
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        stopping = false;
+    }
+
+    /** Return the file or database written by an output, or empty if it is named after the relation */
+    static std::string getTarget(const std::map<std::string, std::string>& directive) {
+        auto name = directive.find("filename");
+        if (name == directive.end()) {
+            name = directive.find("dbname");
+        }
+        if (name == directive.end()) {
+            return "";
+        }
+        auto dir = directive.find("output-dir");
+        return dir == directive.end() ? name->second : dir->second + "/" + name->second;
+    }
+
+    static void finish(std::vector<std::shared_future<void>>& done) {
+        for (auto& writer : done) {
+            try {
+                writer.get();
+            } catch (std::exception& e) {
+                fail(e);
+            }
+        }
+    }
+
+    static void fail(const std::exception& e) {
+        std::cerr << e.what();
+        exit(EXIT_FAILURE);
+    }
+
+    /** The number of worker threads */
+    std::size_t numThreads = 1;
+
+    /** Guards the queue and the pending writers, as statements may be executed in parallel */
+    std::mutex lock;
+
+    /** Signals queued outputs and the end of the workers */
+    std::condition_variable available;
+
+    /** Whether the workers are asked to stop */
+    bool stopping = false;
+
+    /** The worker threads, which are started by the first queued output */
+    std::vector<std::thread> workers;
+
+    /** The outputs ready to be written */
+    std::deque<Job> queue;
+
+    /** The outputs waiting for a pending output to the same file or database */
+    std::map<std::string, std::deque<Job>> blocked;
+
+    /** The pending writers of each relation */
+    std::multimap<const void*, std::shared_future<void>> writers;
+};
+
+}  // namespace souffle
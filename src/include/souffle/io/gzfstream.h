@@ -15,10 +15,19 @@
 
 #pragma once
 
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <zlib.h>
 
 namespace souffle {
@@ -27,6 +36,108 @@ namespace gzfstream {
 
 namespace internal {
 
+/** Size of the blocks of uncompressed data that are compressed independently */
+constexpr std::size_t gzipBlockSize = 1 << 20;
+
+/** Size of the header of a gzip member that records the size of the member */
+constexpr std::size_t gzipHeaderSize = 20;
+
+/** Size of the trailer of a gzip member, holding the checksum and size of its data */
+constexpr std::size_t gzipTrailerSize = 8;
+
+inline void writeLittleEndian(char* destination, uint32_t value) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        destination[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+inline uint32_t readLittleEndian(const char* source) {
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(source[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Compress a block into a complete gzip member
+ *
+ * The size of the member is stored in an extra field of its header, so that the members
+ * of a file can be found without decompressing them.
+ */
+inline std::string compressMember(const std::string& block) {
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("cannot initialise gzip compression");
+    }
+    const auto blockSize = static_cast<uLong>(block.size());
+    std::string member(gzipHeaderSize + deflateBound(&stream, blockSize) + gzipTrailerSize, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+    stream.avail_in = static_cast<uInt>(blockSize);
+    stream.next_out = reinterpret_cast<Bytef*>(&member[gzipHeaderSize]);
+    stream.avail_out = static_cast<uInt>(member.size() - gzipHeaderSize);
+    const int result = deflate(&stream, Z_FINISH);
+    const std::size_t size = gzipHeaderSize + stream.total_out + gzipTrailerSize;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw std::runtime_error("cannot compress gzip block");
+    }
+    member.resize(size);
+
+    // header with the extra field 'SF' holding the size of the member
+    const char header[] = {'\x1f', '\x8b', 8, 4, 0, 0, 0, 0, 0, '\xff', 8, 0, 'S', 'F', 4, 0};
+    memcpy(&member[0], header, sizeof(header));
+    writeLittleEndian(&member[sizeof(header)], static_cast<uint32_t>(size));
+
+    const auto* data = reinterpret_cast<const Bytef*>(block.data());
+    writeLittleEndian(&member[size - 8], static_cast<uint32_t>(crc32(0, data, static_cast<uInt>(blockSize))));
+    writeLittleEndian(&member[size - 4], static_cast<uint32_t>(blockSize));
+    return member;
+}
+
+/** Return the size of the member with the given header, or 0 if the header does not record it */
+inline std::size_t memberSize(const char* header) {
+    const char expected[] = {'\x1f', '\x8b', 8, 4};
+    const char extra[] = {8, 0, 'S', 'F', 4, 0};
+    if (memcmp(header, expected, sizeof(expected)) != 0 || memcmp(header + 10, extra, sizeof(extra)) != 0) {
+        return 0;
+    }
+    const std::size_t size = readLittleEndian(header + 16);
+    return size >= gzipHeaderSize + gzipTrailerSize ? size : 0;
+}
+
+/** Decompress a gzip member written by compressMember */
+inline std::string decompressMember(const std::string& member) {
+    const std::size_t compressedSize = member.size() - gzipHeaderSize - gzipTrailerSize;
+    std::string block(readLittleEndian(&member[member.size() - 4]), '\0');
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("cannot initialise gzip decompression");
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(&member[gzipHeaderSize]));
+    stream.avail_in = static_cast<uInt>(compressedSize);
+    stream.next_out = reinterpret_cast<Bytef*>(&block[0]);
+    stream.avail_out = static_cast<uInt>(block.size());
+    const int result = inflate(&stream, Z_FINISH);
+    const bool complete = result == Z_STREAM_END && stream.total_out == block.size();
+    inflateEnd(&stream);
+    const auto* data = reinterpret_cast<const Bytef*>(block.data());
+    if (!complete || crc32(0, data, static_cast<uInt>(block.size())) !=
+                             readLittleEndian(&member[member.size() - gzipTrailerSize])) {
+        throw std::runtime_error("corrupted gzip block");
+    }
+    return block;
+}
+
+/**
+ * Stream buffer of a gzip file
+ *
+ * Written files are split into blocks that are compressed in parallel into separate gzip
+ * members; standard tools read them as a single file. When such a file is read, its members
+ * are decompressed in parallel. Any other file is read with zlib, which also accepts files
+ * that are not compressed. The number of threads compressing or decompressing blocks is
+ * given by setThreads(), as streams are also used on threads outside of OpenMP.
+ */
 class gzfstreambuf : public std::streambuf {
 public:
     gzfstreambuf() {
@@ -47,6 +158,33 @@ public:
         }
 
         this->mode = mode;
+        this->filename = filename;
+        if ((mode & std::ios::out) != 0) {
+            rawFile = fopen(filename.c_str(), "wb");
+            if (rawFile == nullptr) {
+                return nullptr;
+            }
+            block.resize(gzipBlockSize);
+            setp(&block[0], &block[0] + block.size());
+            parallel = true;
+            isOpen = true;
+            return this;
+        }
+
+        // read files written in blocks in parallel
+        rawFile = fopen(filename.c_str(), "rb");
+        if (rawFile != nullptr) {
+            char header[gzipHeaderSize];
+            if (fread(header, 1, gzipHeaderSize, rawFile) == gzipHeaderSize && memberSize(header) != 0 &&
+                    fseek(rawFile, 0, SEEK_SET) == 0) {
+                parallel = true;
+                isOpen = true;
+                return this;
+            }
+            fclose(rawFile);
+            rawFile = nullptr;
+        }
+
         std::string gzmode((mode & std::ios::in) != 0 ? "rb" : "wb");
         fileHandle = gzopen(filename.c_str(), gzmode.c_str());
 
@@ -62,7 +200,24 @@ public:
         if (is_open()) {
             sync();
             isOpen = false;
-            if (gzclose(fileHandle) == Z_OK) {
+            bool success = true;
+            if ((mode & std::ios::out) != 0) {
+                // write the last block, and an empty member if the file would be empty
+                if (pptr() > pbase() || !written) {
+                    success = submitBlock();
+                }
+                success = flushMembers(0) && success;
+            }
+            pending.clear();
+            if (rawFile != nullptr) {
+                success = fclose(rawFile) == 0 && success;
+                rawFile = nullptr;
+            }
+            if (fileHandle != nullptr) {
+                success = gzclose(fileHandle) == Z_OK && success;
+                fileHandle = nullptr;
+            }
+            if (success) {
                 return this;
             }
         }
@@ -73,6 +228,11 @@ public:
         return isOpen;
     }
 
+    /** Set the number of threads that compress or decompress blocks at the same time */
+    void setThreads(std::size_t numThreads) {
+        threads = std::max<std::size_t>(numThreads, 1);
+    }
+
     ~gzfstreambuf() override {
         try {
             close();
@@ -87,15 +247,13 @@ protected:
             return EOF;
         }
 
+        if (!submitBlock()) {
+            return EOF;
+        }
         if (c != EOF) {
             *pptr() = c;
             pbump(1);
         }
-        int toWrite = pptr() - pbase();
-        if (gzwrite(fileHandle, pbase(), toWrite) != toWrite) {
-            return EOF;
-        }
-        pbump(-toWrite);
 
         return c;
     }
@@ -107,6 +265,9 @@ protected:
         if ((gptr() != nullptr) && (gptr() < egptr())) {
             return traits_type::to_int_type(*gptr());
         }
+        if (parallel) {
+            return underflowParallel();
+        }
 
         unsigned charsPutBack = gptr() - eback();
         if (charsPutBack > reserveSize) {
@@ -125,6 +286,10 @@ protected:
     }
 
     int sync() override {
+        // blocks are only compressed once full, as every block becomes a gzip member
+        if (parallel) {
+            return 0;
+        }
         if ((pptr() != nullptr) && pptr() > pbase()) {
             int toWrite = pptr() - pbase();
             if (gzwrite(fileHandle, pbase(), toWrite) != toWrite) {
@@ -136,6 +301,111 @@ protected:
     }
 
 private:
+    /** Run a task on its own thread if the stream may use several threads */
+    template <typename Task>
+    std::future<std::string> launch(Task task) const {
+#ifdef IS_PARALLEL
+        if (threads > 1) {
+            return std::async(std::launch::async, std::move(task));
+        }
+#endif
+        return std::async(std::launch::deferred, std::move(task));
+    }
+
+    /** Limit of the blocks that are compressed or decompressed at the same time */
+    std::size_t maxPending() const {
+        return threads;
+    }
+
+    /** Start compressing the written block, and continue with an empty one */
+    bool submitBlock() {
+        block.resize(pptr() - pbase());
+        pending.push_back(launch([data = std::move(block)]() { return compressMember(data); }));
+        written = true;
+        block.resize(gzipBlockSize);
+        setp(&block[0], &block[0] + block.size());
+        return flushMembers(maxPending() - 1);
+    }
+
+    /** Write compressed members to the file until at most the given number is pending */
+    bool flushMembers(std::size_t limit) {
+        while (pending.size() > limit) {
+            std::string member;
+            try {
+                member = pending.front().get();
+            } catch (std::exception&) {
+                pending.pop_front();
+                return false;
+            }
+            pending.pop_front();
+            if (fwrite(member.data(), 1, member.size(), rawFile) != member.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int_type underflowParallel() {
+        while (true) {
+            while (!atEnd && pending.size() < maxPending()) {
+                readMember();
+            }
+            if (pending.empty()) {
+                if (foreignOffset < 0) {
+                    return EOF;
+                }
+                // continue reading members not written in blocks with zlib
+                fileHandle = gzopen(filename.c_str(), "rb");
+                if (fileHandle == nullptr || gzseek(fileHandle, foreignOffset, SEEK_SET) != foreignOffset) {
+                    return EOF;
+                }
+                parallel = false;
+                setg(buffer + reserveSize, buffer + reserveSize, buffer + reserveSize);
+                return underflow();
+            }
+
+            try {
+                block = pending.front().get();
+            } catch (std::exception&) {
+                pending.clear();
+                atEnd = true;
+                foreignOffset = -1;
+                return EOF;
+            }
+            pending.pop_front();
+            if (!block.empty()) {
+                setg(&block[0], &block[0], &block[0] + block.size());
+                return traits_type::to_int_type(*gptr());
+            }
+        }
+    }
+
+    /** Read the next member of the file, and start decompressing it */
+    void readMember() {
+        char header[gzipHeaderSize];
+        const std::size_t headerRead = fread(header, 1, gzipHeaderSize, rawFile);
+        if (headerRead == 0) {
+            atEnd = true;
+            return;
+        }
+        const std::size_t size = headerRead == gzipHeaderSize ? memberSize(header) : 0;
+        if (size == 0) {
+            // the remaining members have to be read sequentially
+            atEnd = true;
+            foreignOffset = readOffset;
+            return;
+        }
+
+        std::string member(size, '\0');
+        memcpy(&member[0], header, gzipHeaderSize);
+        if (fread(&member[gzipHeaderSize], 1, size - gzipHeaderSize, rawFile) != size - gzipHeaderSize) {
+            atEnd = true;
+            return;
+        }
+        readOffset += readLittleEndian(&member[size - 4]);
+        pending.push_back(launch([data = std::move(member)]() { return decompressMember(data); }));
+    }
+
     static constexpr unsigned int bufferSize = 65536;
     static constexpr unsigned int reserveSize = 16;
 
@@ -143,6 +413,34 @@ private:
     gzFile fileHandle = {};
     bool isOpen = false;
     std::ios_base::openmode mode = std::ios_base::in;
+    std::string filename;
+
+    /** Whether the file is written or read in blocks */
+    bool parallel = false;
+
+    /** The number of threads compressing or decompressing blocks */
+    std::size_t threads = 1;
+
+    /** The file, if it is written or read in blocks */
+    FILE* rawFile = nullptr;
+
+    /** The block that is written or read */
+    std::string block;
+
+    /** Blocks that are compressed or decompressed, in the order of the file */
+    std::deque<std::future<std::string>> pending;
+
+    /** Whether a member has been written */
+    bool written = false;
+
+    /** Whether all members that can be read in parallel have been read */
+    bool atEnd = false;
+
+    /** Size of the data of the members that have been read */
+    z_off_t readOffset = 0;
+
+    /** Position in the data of the first member that does not record its size, or -1 */
+    z_off_t foreignOffset = -1;
 };
 
 class gzfstream : virtual public std::ios {
@@ -172,6 +470,10 @@ public:
         return buf.is_open();
     }
 
+    void setThreads(std::size_t threads) {
+        buf.setThreads(threads);
+    }
+
     void close() {
         if (buf.is_open()) {
             if (buf.close() == nullptr) {
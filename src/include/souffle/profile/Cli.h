@@ -8,9 +8,12 @@
 
 #pragma once
 
+#include "souffle/profile/EventLog.h"
+#include "souffle/profile/ProfileEvent.h"
 #include "souffle/profile/StringUtils.h"
 #include "souffle/profile/Tui.h"
 
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
@@ -32,7 +35,7 @@ public:
         int c;
         option longOptions[1];
         longOptions[0] = {nullptr, 0, nullptr, 0};
-        while ((c = getopt_long(argc, argv, "c:hj::", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "c:hj::o:t:", longOptions, nullptr)) != EOF) {
             // An invalid argument was given
             if (c == '?') {
                 exit(EXIT_FAILURE);
@@ -60,7 +63,9 @@ public:
 
         if (args.count('h') != 0 || args.count('f') == 0) {
             std::cout << "Souffle Profiler" << std::endl
-                      << "Usage: souffle-profile <log-file> [ -h | -c <command> [options] | -j ]" << std::endl
+                      << "Usage: souffle-profile <log-file> "
+                         "[ -h | -c <command> [options] | -j | -o <file> | -t <file> ]"
+                      << std::endl
                       << "<log-file>            The log file to profile." << std::endl
                       << "-c <command>          Run the given command on the log file, try with  "
                          "'-c help' for a list"
@@ -69,12 +74,35 @@ public:
                       << "-j[filename]          Generate a GUI (html/js) version of the profiler."
                       << std::endl
                       << "                      Default filename is profiler_html/[num].html" << std::endl
+                      << "-o <filename>         Convert the log file to a JSON log file." << std::endl
+                      << "-t <filename>         Export the timeline of the program in the Chrome trace event"
+                      << std::endl
+                      << "                      format, e.g., for Perfetto." << std::endl
                       << "-h                    Print this help message." << std::endl;
             exit(0);
         }
         std::string filename = args['f'];
 
-        if (args.count('c') != 0) {
+        if (args.count('o') != 0) {
+            ProfileEventSingleton::instance().setDBFromFile(filename);
+            std::ofstream os(args['o']);
+            if (!os.is_open()) {
+                std::cerr << "Cannot open file <" << args['o'] << ">" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            ProfileEventSingleton::instance().getDB().print(os);
+        } else if (args.count('t') != 0) {
+            if (!EventLog::isEventLog(filename)) {
+                std::cerr << "The timeline requires a binary log file" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            std::ofstream os(args['t']);
+            if (!os.is_open()) {
+                std::cerr << "Cannot open file <" << args['t'] << ">" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            EventLog::exportTrace(filename, os);
+        } else if (args.count('c') != 0) {
             Tui tui(filename, false, false);
             for (auto& command : Tools::split(args['c'], ";")) {
                 tui.runCommand(Tools::split(command, " "));
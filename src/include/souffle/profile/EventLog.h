@@ -0,0 +1,429 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file EventLog.h
+ *
+ * Declares the binary log to which profile events are streamed
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/profile/EventProcessor.h"
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/json11.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+namespace profile {
+
+/**
+ * @class EventLog
+ * @brief Streams profile events to a binary log file
+ *
+ * Events are recorded as fixed-size records. Every thread writes its events
+ * into a ring buffer of its own without taking any locks; a background
+ * thread periodically drains the ring buffers into the log file. The memory
+ * used for profiling is therefore bounded by the size of the ring buffers,
+ * and the events recorded before a crash are found in the log file.
+ *
+ * Texts of events are written once to the log and then referred to by an
+ * identifier. The records are written in the byte order of the host.
+ *
+ * The log is converted into a profile database by replaying its events
+ * through the event processor, see EventLog::replay. The spans of time in
+ * which the threads executed parts of the program are not part of the
+ * database; they are exported as a timeline, see EventLog::exportTrace.
+ */
+class EventLog {
+public:
+    /** Kinds of records in the log */
+    enum class Kind : uint32_t { String, Config, Time, Timing, Quantity, Utilisation, Span, Counters };
+
+    /** Record of an event; texts are given by the identifiers of their strings */
+    struct Event {
+        Kind kind;
+        uint32_t text;
+        uint64_t values[6];
+    };
+
+    EventLog() = default;
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    ~EventLog() {
+        close();
+    }
+
+    /** @brief Open the log file and start the writer thread */
+    bool open(const std::string& filename) {
+        close();
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(MAGIC, sizeof(MAGIC));
+        strings.clear();
+        stringIds.clear();
+        writtenStrings = 0;
+        rings.clear();
+        generation = ++generations();
+        running = true;
+        writer = std::thread([this]() { run(); });
+        return true;
+    }
+
+    /** @brief Check whether events are streamed to a log file */
+    bool isOpen() const {
+        return running;
+    }
+
+    /** @brief Write all recorded events, stop the writer thread and close the log file */
+    void close() {
+        if (!running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            running = false;
+        }
+        wakeup.notify_one();
+        writer.join();
+        file.close();
+    }
+
+    /** @brief Record an event */
+    void record(Kind kind, const std::string& text, std::initializer_list<uint64_t> values) {
+        ThreadState& state = getRegisteredThreadState();
+        Event event{kind, intern(state, text), {}};
+        std::copy(values.begin(), values.end(), event.values);
+
+        Ring& ring = *state.ring;
+        const std::size_t head = ring.head.load(std::memory_order_relaxed);
+        // wait for the writer if the ring buffer is full
+        while (head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+            wakeup.notify_one();
+            std::this_thread::yield();
+        }
+        ring.events[head % RING_SIZE] = event;
+        ring.head.store(head + 1, std::memory_order_release);
+        if ((head + 1) % (RING_SIZE / 2) == 0) {
+            wakeup.notify_one();
+        }
+    }
+
+    /** @brief Check whether the given file is a binary event log */
+    static bool isEventLog(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        char magic[sizeof(MAGIC)];
+        return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    /**
+     * @brief Replay the events of a log into a profile database
+     *
+     * A truncated record at the end of the log, e.g., left by a crashed
+     * program, is ignored.
+     */
+    static void replay(const std::string& filename, ProfileDatabase& db) {
+        auto& processor = EventProcessorSingleton::instance();
+        read(filename, [&](const std::vector<std::string>& texts, const Event& event) {
+            // replay the event with the arguments given by the profile event singleton
+            const char* txt = texts[event.text].c_str();
+            const uint64_t* v = event.values;
+            switch (event.kind) {
+                case Kind::Config:
+                    processor.process(db, txt, texts.at(v[0]).c_str(), texts.at(v[1]).c_str());
+                    break;
+                case Kind::Time: processor.process(db, txt, microseconds(v[0])); break;
+                case Kind::Timing:
+                    processor.process(db, txt, microseconds(v[0]), microseconds(v[1]),
+                            static_cast<std::size_t>(v[2]), static_cast<std::size_t>(v[3]),
+                            static_cast<std::size_t>(v[4]), static_cast<std::size_t>(v[5]));
+                    break;
+                case Kind::Quantity:
+                    processor.process(db, txt, static_cast<std::size_t>(v[0]), static_cast<int>(v[1]));
+                    break;
+                case Kind::Utilisation:
+                    processor.process(db, txt, microseconds(v[0]), v[1], v[2], static_cast<std::size_t>(v[3]),
+                            static_cast<std::size_t>(v[4]));
+                    break;
+                case Kind::Counters:
+                    processor.process(db, txt, texts.at(v[4]).c_str(), v[0], v[1], v[2], v[3]);
+                    break;
+                case Kind::Span: break;
+                default: fatal("unknown profile event kind");
+            }
+        });
+    }
+
+    /**
+     * @brief Export the spans of a log as a timeline in the Chrome trace event format
+     *
+     * The timeline can be viewed with Perfetto or chrome://tracing. Spans are
+     * shown on the thread that executed them, and are categorised by the
+     * first field of their text; their name is the second field, if any.
+     */
+    static void exportTrace(const std::string& filename, std::ostream& os) {
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        std::vector<bool> threads;
+        read(filename, [&](const std::vector<std::string>& texts, const Event& event) {
+            if (event.kind != Kind::Span) {
+                return;
+            }
+            const std::string& text = texts[event.text];
+            const std::size_t end = text.find(';');
+            std::string category = text.substr(0, end);
+            category.erase(0, category.find_first_not_of('@'));
+            std::string name = category;
+            if (end != std::string::npos) {
+                name = text.substr(end + 1, text.find(';', end + 1) - end - 1);
+            }
+
+            os << (first ? "\n" : ",\n");
+            first = false;
+            const uint64_t thread = event.values[2];
+            if (thread >= threads.size()) {
+                threads.resize(thread + 1, false);
+            }
+            if (!threads[thread]) {
+                threads[thread] = true;
+                os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+                   << ",\"args\":{\"name\":\"" << (thread == 0 ? "main" : "thread " + std::to_string(thread))
+                   << "\"}},\n";
+            }
+            os << "{\"name\":" << json11::Json(name).dump() << ",\"cat\":" << json11::Json(category).dump()
+               << ",\"ph\":\"X\",\"ts\":" << event.values[0]
+               << ",\"dur\":" << event.values[1] - event.values[0] << ",\"pid\":1,\"tid\":" << thread
+               << ",\"args\":{\"text\":" << json11::Json(text).dump() << "}}";
+        });
+        os << "\n]}\n";
+    }
+
+    /** @brief Get the identifier of a string, writing the string to the log if necessary */
+    uint32_t intern(const std::string& text) {
+        return intern(getRegisteredThreadState(), text);
+    }
+
+    /** @brief Get the index of the current thread, given by the order in which threads record events */
+    uint64_t getThreadIndex() {
+        return getRegisteredThreadState().thread;
+    }
+
+private:
+    /** Header of a log file */
+    static constexpr char MAGIC[16] = {
+            'S', 'O', 'U', 'F', 'F', 'L', 'E', '-', 'P', 'R', 'O', 'F', '-', 'v', '1', '\n'};
+
+    /** Number of events in the ring buffer of a thread */
+    static constexpr std::size_t RING_SIZE = 4096;
+
+    /** Interval in which the writer thread drains the ring buffers */
+    static constexpr std::chrono::milliseconds WRITE_INTERVAL{100};
+
+    /** Single-producer single-consumer ring buffer of the events of a thread */
+    struct Ring {
+        std::array<Event, RING_SIZE> events;
+        /** Position of the next event written by the thread */
+        alignas(64) std::atomic<std::size_t> head{0};
+        /** Position of the next event read by the writer */
+        alignas(64) std::atomic<std::size_t> tail{0};
+    };
+
+    /** State of the recording thread */
+    struct ThreadState {
+        /** Generation of the log the state belongs to */
+        std::size_t generation = 0;
+        /** Ring buffer of the thread */
+        Ring* ring = nullptr;
+        /** Index of the thread */
+        uint64_t thread = 0;
+        /** Strings interned by the thread */
+        std::unordered_map<std::string, uint32_t> strings;
+    };
+
+    static ThreadState& getThreadState() {
+        static thread_local ThreadState state;
+        return state;
+    }
+
+    /** Counter distinguishing the logs opened by a process */
+    static std::atomic<std::size_t>& generations() {
+        static std::atomic<std::size_t> counter{0};
+        return counter;
+    }
+
+    /** Return the state of the current thread, creating its ring buffer if necessary */
+    ThreadState& getRegisteredThreadState() {
+        ThreadState& state = getThreadState();
+        if (state.generation != generation) {
+            std::lock_guard<std::mutex> lock(ringMutex);
+            state.generation = generation;
+            state.thread = rings.size();
+            rings.push_back(std::make_unique<Ring>());
+            state.ring = rings.back().get();
+            state.strings.clear();
+        }
+        return state;
+    }
+
+    /**
+     * Read a log file
+     *
+     * The given function is called with the strings read so far for each
+     * event. A truncated record at the end of the log is ignored.
+     */
+    template <typename F>
+    static void read(const std::string& filename, const F& f) {
+        std::ifstream in(filename, std::ios::binary);
+        char magic[sizeof(MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            std::cerr << "Profile log file <" << filename << "> is not a binary event log" << std::endl;
+            return;
+        }
+
+        std::vector<std::string> texts;
+        Event event{};
+        while (in.read(reinterpret_cast<char*>(&event.kind), sizeof(event.kind))) {
+            if (event.kind == Kind::String) {
+                uint32_t length = 0;
+                if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+                    break;
+                }
+                std::string text(length, '\0');
+                if (!in.read(&text[0], length)) {
+                    break;
+                }
+                texts.push_back(std::move(text));
+                continue;
+            }
+            if (!in.read(reinterpret_cast<char*>(&event) + sizeof(event.kind),
+                        sizeof(Event) - sizeof(event.kind)) ||
+                    event.text >= texts.size()) {
+                break;
+            }
+            f(texts, event);
+        }
+    }
+
+    uint32_t intern(ThreadState& state, const std::string& text) {
+        auto pos = state.strings.find(text);
+        if (pos != state.strings.end()) {
+            return pos->second;
+        }
+        std::lock_guard<std::mutex> lock(stringMutex);
+        auto res = stringIds.emplace(text, static_cast<uint32_t>(strings.size()));
+        if (res.second) {
+            strings.push_back(text);
+        }
+        state.strings.emplace(text, res.first->second);
+        return res.first->second;
+    }
+
+    /** Run method of the writer thread */
+    void run() {
+        std::unique_lock<std::mutex> lock(writerMutex);
+        while (running) {
+            wakeup.wait_for(lock, WRITE_INTERVAL);
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+        lock.unlock();
+        drain();
+    }
+
+    /** Write the recorded events of all threads to the log file */
+    void drain() {
+        std::vector<std::pair<Ring*, std::size_t>> heads;
+        {
+            std::lock_guard<std::mutex> lock(ringMutex);
+            for (auto& ring : rings) {
+                heads.emplace_back(ring.get(), ring->head.load(std::memory_order_acquire));
+            }
+        }
+
+        // events are only recorded after their strings have been interned, so all
+        // strings of the events up to the heads are written first
+        {
+            std::lock_guard<std::mutex> lock(stringMutex);
+            for (; writtenStrings < strings.size(); writtenStrings++) {
+                const std::string& text = strings[writtenStrings];
+                const Kind kind = Kind::String;
+                const auto length = static_cast<uint32_t>(text.size());
+                file.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+                file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                file.write(text.data(), length);
+            }
+        }
+
+        for (auto& cur : heads) {
+            Ring& ring = *cur.first;
+            std::size_t tail = ring.tail.load(std::memory_order_relaxed);
+            while (tail != cur.second) {
+                const std::size_t begin = tail % RING_SIZE;
+                const std::size_t count = std::min(cur.second - tail, RING_SIZE - begin);
+                file.write(reinterpret_cast<const char*>(&ring.events[begin]), count * sizeof(Event));
+                tail += count;
+            }
+            ring.tail.store(tail, std::memory_order_release);
+        }
+        file.flush();
+    }
+
+    /** Log file */
+    std::ofstream file;
+
+    /** Writer thread */
+    std::thread writer;
+
+    /** Writer thread is running */
+    std::atomic<bool> running{false};
+
+    std::mutex writerMutex;
+    std::condition_variable wakeup;
+
+    /** Generation of the log */
+    std::size_t generation = 0;
+
+    /** Ring buffers of the threads */
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::mutex ringMutex;
+
+    /** Interned strings */
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIds;
+    std::mutex stringMutex;
+
+    /** Number of strings written to the log file */
+    std::size_t writtenStrings = 0;
+};
+
+}  // namespace profile
+}  // namespace souffle
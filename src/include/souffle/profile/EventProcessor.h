@@ -20,6 +20,7 @@
 #include "souffle/profile/ProfileDatabase.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StreamUtil.h"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdarg>
@@ -472,10 +473,12 @@ public:
         uint64_t systemTime = va_arg(args, uint64_t);
         uint64_t userTime = va_arg(args, uint64_t);
         std::size_t maxRSS = va_arg(args, std::size_t);
+        std::size_t rss = va_arg(args, std::size_t);
         std::string timeString = std::to_string(time.count());
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "systemtime"}, systemTime);
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "usertime"}, userTime);
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "maxRSS"}, maxRSS);
+        db.addSizeEntry({"program", "usage", "timepoint", timeString, "rss"}, rss);
     }
 } programResourceUtilisationProcessor;
 
@@ -535,6 +538,43 @@ public:
 
 } relationReadsProcessor;
 
+/**
+ * Performance Counters Profile Event Processor
+ *
+ * Sums up the counters of the timed regions of relations and rules over all
+ * iterations and versions.
+ */
+const class CountersProcessor : public EventProcessor {
+public:
+    CountersProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@counters", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string names = va_arg(args, char*);
+        const std::string& kind = signature[1];
+        std::vector<std::string> path;
+        if (kind == "@t-nonrecursive-relation" || kind == "@t-recursive-relation") {
+            path = {"program", "relation", signature[2], "counters"};
+        } else if (kind == "@t-nonrecursive-rule") {
+            path = {"program", "relation", signature[2], "rule-counters", signature[4]};
+        } else if (kind == "@t-recursive-rule") {
+            path = {"program", "relation", signature[2], "rule-counters", signature[5]};
+        } else {
+            return;
+        }
+        db.addTextEntry({"program", "counters"}, names);
+        std::size_t start = 0;
+        while (start <= names.size()) {
+            std::size_t end = std::min(names.find(',', start), names.size());
+            path.push_back(names.substr(start, end - start));
+            db.incrementSizeEntry(path, va_arg(args, uint64_t));
+            path.pop_back();
+            start = end + 1;
+        }
+    }
+} countersProcessor;
+
 /**
  * Config entry processor
  */
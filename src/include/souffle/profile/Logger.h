@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "souffle/profile/PerfCounters.h"
 #include "souffle/profile/ProfileEvent.h"
 #include "souffle/utility/MiscUtil.h"
 #include <cstddef>
@@ -52,6 +53,9 @@ public:
 #endif  // WIN32
         // Assume that if we are logging the progress of an event then we care about usage during that time.
         ProfileEventSingleton::instance().resetTimerInterval();
+        if (profile::PerfCounters::instance().isOpen()) {
+            startCounters = profile::PerfCounters::instance().read();
+        }
     }
 
     ~Logger() {
@@ -65,8 +69,18 @@ public:
         getrusage(RUSAGE_SELF, &ru);
         std::size_t endMaxRSS = ru.ru_maxrss;
 #endif  // WIN32
+        time_point end = now();
+        if (profile::PerfCounters::instance().isOpen()) {
+            auto counters = profile::PerfCounters::instance().read();
+            for (std::size_t i = 0; i < counters.size(); i++) {
+                counters[i] -= startCounters[i];
+            }
+            ProfileEventSingleton::instance().makeCountersEvent(
+                    label, profile::PerfCounters::instance().getNames(), counters);
+        }
         ProfileEventSingleton::instance().makeTimingEvent(
-                label, start, now(), startMaxRSS, endMaxRSS, size() - preSize, iteration);
+                label, start, end, startMaxRSS, endMaxRSS, size() - preSize, iteration);
+        ProfileEventSingleton::instance().makeSpanEvent(label, start, end);
     }
 
 private:
@@ -76,5 +90,25 @@ private:
     std::size_t iteration;
     std::function<std::size_t()> size;
     std::size_t preSize;
+    profile::PerfCounters::Values startCounters{};
+};
+
+/**
+ * Records the span of time in which the current thread executes a part of
+ * the program, e.g., a stratum, a loop iteration, a query or its share of a
+ * parallel loop. The spans make up the timeline of the program exported by
+ * souffle-profile.
+ */
+class TraceSpan {
+public:
+    TraceSpan(std::string label) : label(std::move(label)), start(now()) {}
+
+    ~TraceSpan() {
+        ProfileEventSingleton::instance().makeSpanEvent(label, start, now());
+    }
+
+private:
+    std::string label;
+    time_point start;
 };
 }  // end of namespace souffle
@@ -0,0 +1,202 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file PerfCounters.h
+ *
+ * Declares the hardware performance counters used for profiling
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+namespace souffle {
+namespace profile {
+
+/**
+ * @class PerfCounters
+ * @brief Performance counters of the threads of the program
+ *
+ * Each thread opens its own counters of cycles, instructions, last-level
+ * cache misses and branch misses via perf_event_open. If the kernel refuses
+ * the hardware counters, e.g., due to its perf_event_paranoid setting or in
+ * a virtual machine, the software counters task-clock, page-faults,
+ * context-switches and cpu-migrations are used instead; if these are
+ * refused as well, no counters are available.
+ *
+ * Reading the counters sums up the counters of all threads, so a region of
+ * the program also accounts for the work done by the threads of its
+ * parallel loops.
+ */
+class PerfCounters {
+public:
+    /** Number of counters */
+    static constexpr std::size_t NUM_COUNTERS = 4;
+
+    using Values = std::array<uint64_t, NUM_COUNTERS>;
+
+    /** get instance */
+    static PerfCounters& instance() {
+        static PerfCounters counters;
+        return counters;
+    }
+
+    /** @brief Open the counters of the current thread and of the threads of an OpenMP team */
+    void open() {
+        openThread();
+#ifdef _OPENMP
+#pragma omp parallel
+        openThread();
+#endif
+    }
+
+    /** @brief Check whether counters are available */
+    bool isOpen() const {
+        return names != nullptr;
+    }
+
+    /** @brief Get the comma-separated names of the counters */
+    const char* getNames() const {
+        return names;
+    }
+
+    /** @brief Read the sums of the counters of all threads */
+    Values read() {
+        Values sums{};
+#ifdef __linux__
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& fds : threads) {
+            for (std::size_t i = 0; i < NUM_COUNTERS; i++) {
+                uint64_t value = 0;
+                if (::read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+                    sums[i] += value;
+                }
+            }
+        }
+#endif  // __linux__
+        return sums;
+    }
+
+private:
+    PerfCounters() = default;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (const auto& fds : threads) {
+            for (int fd : fds) {
+                ::close(fd);
+            }
+        }
+#endif  // __linux__
+    }
+
+    /** Open the counters of the current thread, unless they have been opened already */
+    void openThread() {
+#ifdef __linux__
+        static thread_local bool opened = false;
+        if (opened) {
+            return;
+        }
+        opened = true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!probed) {
+            // the first thread determines the kind of counters of all threads
+            probed = true;
+            if (openCounters(HARDWARE)) {
+                names = HARDWARE_NAMES;
+                counters = HARDWARE;
+            } else if (openCounters(SOFTWARE)) {
+                names = SOFTWARE_NAMES;
+                counters = SOFTWARE;
+            }
+        } else if (names != nullptr) {
+            openCounters(counters);
+        }
+#endif  // __linux__
+    }
+
+#ifdef __linux__
+    /** Type and configuration of a counter */
+    using Counter = std::pair<uint32_t, uint64_t>;
+
+    static constexpr std::array<Counter, NUM_COUNTERS> HARDWARE = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+    static constexpr const char* HARDWARE_NAMES = "cycles,instructions,llc-misses,branch-misses";
+
+    static constexpr std::array<Counter, NUM_COUNTERS> SOFTWARE = {{
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+    }};
+    static constexpr const char* SOFTWARE_NAMES = "task-clock,page-faults,context-switches,cpu-migrations";
+
+    /** Open the given counters for the current thread; on failure, no counter is kept open */
+    bool openCounters(const std::array<Counter, NUM_COUNTERS>& kinds) {
+        std::array<int, NUM_COUNTERS> fds{};
+        for (std::size_t i = 0; i < NUM_COUNTERS; i++) {
+            perf_event_attr attr{};
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = kinds[i].first;
+            attr.config = kinds[i].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[i] < 0) {
+                for (std::size_t j = 0; j < i; j++) {
+                    ::close(fds[j]);
+                }
+                return false;
+            }
+        }
+        threads.push_back(fds);
+        return true;
+    }
+
+    /** The kind of counters has been determined */
+    bool probed = false;
+
+    /** Kind of counters opened */
+    std::array<Counter, NUM_COUNTERS> counters{};
+
+    /** File descriptors of the counters of the threads */
+    std::vector<std::array<int, NUM_COUNTERS>> threads;
+#endif  // __linux__
+
+    /** Names of the counters, or null if no counters are available */
+    const char* names = nullptr;
+
+    std::mutex mutex;
+};
+
+}  // namespace profile
+}  // namespace souffle
@@ -3,6 +3,7 @@
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/json11.h"
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
@@ -145,7 +146,7 @@ public:
  */
 class SizeEntry : public Entry {
 private:
-    std::size_t size;  // size
+    std::atomic<std::size_t> size;  // size
 public:
     SizeEntry(const std::string& key, std::size_t size) : Entry(key), size(size) {}
 
@@ -154,6 +155,11 @@ public:
         return size;
     }
 
+    // add to size
+    void increment(std::size_t amount) {
+        size += amount;
+    }
+
     // accept visitor
     void accept(Visitor& v) override {
         v.visit(*this);
@@ -161,7 +167,7 @@ public:
 
     // print entry
     void print(std::ostream& os, int tabpos) const override {
-        os << std::string(tabpos, ' ') << "\"" << getKey() << "\": " << size;
+        os << std::string(tabpos, ' ') << "\"" << getKey() << "\": " << getSize();
     }
 };
 
@@ -372,6 +378,18 @@ public:
         dir->writeEntry(std::move(entry));
     }
 
+    // add to size entry, creating it if it does not exist
+    void incrementSizeEntry(std::vector<std::string> qualifier, std::size_t amount) {
+        assert(qualifier.size() > 0 && "no qualifier");
+        std::vector<std::string> path(qualifier.begin(), qualifier.end() - 1);
+        DirectoryEntry* dir = lookupPath(path);
+
+        const std::string& key = qualifier.back();
+        auto* entry = as<SizeEntry>(dir->writeEntry(mk<SizeEntry>(key, 0)));
+        assert(entry != nullptr && "entry is not a size entry");
+        entry->increment(amount);
+    }
+
     // add text entry
     void addTextEntry(std::vector<std::string> qualifier, const std::string& text) {
         assert(qualifier.size() > 0 && "no qualifier");
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include "souffle/profile/EventLog.h"
 #include "souffle/profile/EventProcessor.h"
+#include "souffle/profile/PerfCounters.h"
 #include "souffle/profile/ProfileDatabase.h"
+#include "souffle/utility/MemoryUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StringUtil.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -46,6 +50,9 @@ class ProfileEventSingleton {
     profile::ProfileDatabase database;
     std::string filename{""};
 
+    /** log events are streamed to instead of the database */
+    profile::EventLog log;
+
     ProfileEventSingleton() = default;
 
 public:
@@ -62,13 +69,21 @@ public:
 
     /** create config record */
     void makeConfigRecord(const std::string& key, const std::string& value) {
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Config, "@config", {log.intern(key), log.intern(value)});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(database, "@config", key.c_str(), value.c_str());
     }
 
     /** create time event */
     void makeTimeEvent(const std::string& txt) {
-        profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), std::chrono::duration_cast<microseconds>(now().time_since_epoch()));
+        microseconds time = std::chrono::duration_cast<microseconds>(now().time_since_epoch());
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Time, txt, {static_cast<uint64_t>(time.count())});
+            return;
+        }
+        profile::EventProcessorSingleton::instance().process(database, txt.c_str(), time);
     }
 
     /** create an event for recording start and end times */
@@ -76,12 +91,51 @@ public:
             std::size_t endMaxRSS, std::size_t size, std::size_t iteration) {
         microseconds start_ms = std::chrono::duration_cast<microseconds>(start.time_since_epoch());
         microseconds end_ms = std::chrono::duration_cast<microseconds>(end.time_since_epoch());
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Timing, txt,
+                    {static_cast<uint64_t>(start_ms.count()), static_cast<uint64_t>(end_ms.count()),
+                            startMaxRSS, endMaxRSS, size, iteration});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(
                 database, txt.c_str(), start_ms, end_ms, startMaxRSS, endMaxRSS, size, iteration);
     }
 
+    /**
+     * create an event for the span of time in which the current thread executed a part of the program
+     *
+     * Spans are only recorded when events are streamed to a binary log, from
+     * which souffle-profile exports the timeline of the program.
+     */
+    void makeSpanEvent(const std::string& txt, time_point start, time_point end) {
+        if (log.isOpen()) {
+            microseconds start_ms = std::chrono::duration_cast<microseconds>(start.time_since_epoch());
+            microseconds end_ms = std::chrono::duration_cast<microseconds>(end.time_since_epoch());
+            log.record(profile::EventLog::Kind::Span, txt,
+                    {static_cast<uint64_t>(start_ms.count()), static_cast<uint64_t>(end_ms.count()),
+                            log.getThreadIndex()});
+        }
+    }
+
+    /** create an event for the performance counters of a timed region */
+    void makeCountersEvent(
+            const std::string& txt, const char* names, const profile::PerfCounters::Values& values) {
+        const std::string text = "@counters;" + txt;
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Counters, text,
+                    {values[0], values[1], values[2], values[3], log.intern(names)});
+            return;
+        }
+        profile::EventProcessorSingleton::instance().process(
+                database, text.c_str(), names, values[0], values[1], values[2], values[3]);
+    }
+
     /** create quantity event */
     void makeQuantityEvent(const std::string& txt, std::size_t number, int iteration) {
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Quantity, txt, {number, static_cast<uint64_t>(iteration)});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), number, iteration);
     }
 
@@ -120,17 +174,37 @@ public:
         /* Maximum resident set size (kb) */
         std::size_t maxRSS = ru.ru_maxrss;
 #endif  // WIN32
+        /* Current resident set size (kb) */
+        std::size_t rss = getResidentMemory() / 1024;
 
+        if (log.isOpen()) {
+            log.record(profile::EventLog::Kind::Utilisation, txt,
+                    {static_cast<uint64_t>(time.count()), systemTime, userTime, maxRSS, rss});
+            return;
+        }
         profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), time, systemTime, userTime, maxRSS);
+                database, txt.c_str(), time, systemTime, userTime, maxRSS, rss);
     }
 
-    void setOutputFile(std::string outputFilename) {
+    /**
+     * Set the profile log file
+     *
+     * If stream is set, events are streamed to a binary log as they occur,
+     * which is converted by souffle-profile. Otherwise, and for log files
+     * with a .json extension, the events are kept in the database and
+     * written as JSON by dump().
+     */
+    void setOutputFile(std::string outputFilename, bool stream = false) {
         filename = outputFilename;
+        if (stream && !endsWith(filename, ".json") && !log.open(filename)) {
+            std::cerr << "Cannot open profile log file <" + filename + ">";
+        }
     }
     /** Dump all events */
     void dump() {
-        if (!filename.empty()) {
+        if (log.isOpen()) {
+            log.close();
+        } else if (!filename.empty()) {
             std::ofstream os(filename);
             if (!os.is_open()) {
                 std::cerr << "Cannot open profile log file <" + filename + ">";
@@ -158,7 +232,12 @@ public:
     }
 
     void setDBFromFile(const std::string& databaseFilename) {
-        database = profile::ProfileDatabase(databaseFilename);
+        if (profile::EventLog::isEventLog(databaseFilename)) {
+            database = profile::ProfileDatabase();
+            profile::EventLog::replay(databaseFilename, database);
+        } else {
+            database = profile::ProfileDatabase(databaseFilename);
+        }
     }
 
 private:
@@ -74,6 +74,7 @@ private:
         uint64_t maxRSS;
         std::chrono::microseconds systemtime;
         std::chrono::microseconds usertime;
+        uint64_t rss;
         bool operator<(const Usage& other) const {
             return time < other.time;
         }
@@ -208,6 +209,8 @@ public:
             }
         } else if (c[0] == "configuration") {
             configuration();
+        } else if (c[0] == "counters") {
+            counters(resultLimit);
         } else {
             std::cout << "Unknown command. Use \"help\" for a list of commands.\n";
         }
@@ -510,7 +513,7 @@ public:
                << ", ";
             ss << 100.0 * (usage.systemtime - previousUsage.systemtime) / (usage.time - previousUsage.time)
                << ", ";
-            ss << usage.maxRSS * 1024 << ", ";
+            ss << usage.rss * 1024 << ", ";
             ss << '"';
             bool firstCol = true;
             for (auto& cur : out.getProgramRun()->getRelationsAtTime(previousUsage.time, usage.time)) {
@@ -702,6 +705,8 @@ public:
         std::printf("  %-30s%-5s %s\n", "usage [relation id|rule id]", "-",
                 "display CPU usage graphs for a relation or rule.");
         std::printf("  %-30s%-5s %s\n", "memory", "-", "display memory usage.");
+        std::printf("  %-30s%-5s %s\n", "counters", "-",
+                "display performance counters of relations and rules (--profile-counters).");
         std::printf("  %-30s%-5s %s\n", "help", "-", "print this.");
 
         std::cout << "\nInteractive mode only commands:" << std::endl;
@@ -788,6 +793,9 @@ public:
             currentUsage.usertime = std::chrono::duration<uint64_t, std::micro>(cur);
             currentUsage.maxRSS =
                     as<SizeEntry>(usageStats->readDirectoryEntry(currentKey)->readEntry("maxRSS"))->getSize();
+            // logs of older versions only contain the peak resident set size
+            const auto* rss = as<SizeEntry>(usageStats->readDirectoryEntry(currentKey)->readEntry("rss"));
+            currentUsage.rss = rss != nullptr ? rss->getSize() : currentUsage.maxRSS;
 
             // Duplicate times are possible
             if (allUsages.find(currentUsage) != allUsages.end()) {
@@ -795,6 +803,7 @@ public:
                 currentUsage.systemtime = std::max(existing.systemtime, currentUsage.systemtime);
                 currentUsage.usertime = std::max(existing.usertime, currentUsage.usertime);
                 currentUsage.maxRSS = std::max(existing.maxRSS, currentUsage.maxRSS);
+                currentUsage.rss = std::max(existing.rss, currentUsage.rss);
                 allUsages.erase(currentUsage);
             }
             allUsages.insert(currentUsage);
@@ -823,7 +832,7 @@ public:
 
         // Store the timepoints we need for the graph
         for (uint32_t i = 1; i <= width; ++i) {
-            auto it = allUsages.upper_bound(Usage{startTime + timeStep * i, 0, {}, {}});
+            auto it = allUsages.upper_bound(Usage{startTime + timeStep * i, 0, {}, {}, 0});
             if (it != allUsages.begin()) {
                 --it;
             }
@@ -865,7 +874,7 @@ public:
         }
 
         // Find maximum so we can normalise the graph
-        Usage previousUsage{{}, 0, {}, {}};
+        Usage previousUsage{{}, 0, {}, {}, 0};
         for (auto& currentUsage : usages) {
             double usageDiff = (currentUsage.systemtime - previousUsage.systemtime + currentUsage.usertime -
                                 previousUsage.usertime)
@@ -890,7 +899,7 @@ public:
             }
         }
 
-        previousUsage = {{}, 0, {}, {}};
+        previousUsage = {{}, 0, {}, {}, 0};
         uint32_t col = 0;
         for (const Usage& currentUsage : usages) {
             uint64_t curHeight = 0;
@@ -941,7 +950,7 @@ public:
     void memoryUsage(std::chrono::microseconds /* endTime */, std::chrono::microseconds /* startTime */,
             uint32_t height = 20) {
         uint32_t width = getTermWidth() - 8;
-        uint64_t maxMaxRSS = 0;
+        uint64_t maxRSS = 0;
 
         std::set<Usage> usages = getUsageStats(width);
         char grid[height][width];
@@ -952,11 +961,11 @@ public:
         }
 
         for (auto& usage : usages) {
-            maxMaxRSS = std::max(maxMaxRSS, usage.maxRSS);
+            maxRSS = std::max(maxRSS, usage.rss);
         }
         std::size_t col = 0;
         for (const Usage& currentUsage : usages) {
-            uint64_t curHeight = height * currentUsage.maxRSS / maxMaxRSS;
+            uint64_t curHeight = height * currentUsage.rss / maxRSS;
             for (uint32_t row = 0; row < curHeight; ++row) {
                 grid[row][col] = '*';
             }
@@ -965,7 +974,7 @@ public:
 
         // Print array
         for (int32_t row = height - 1; row >= 0; --row) {
-            printf("%6s ", Tools::formatMemory(maxMaxRSS * (row + 1) / height).c_str());
+            printf("%6s ", Tools::formatMemory(maxRSS * (row + 1) / height).c_str());
             for (uint32_t col = 0; col < width; ++col) {
                 std::cout << grid[row][col];
             }
@@ -992,6 +1001,7 @@ public:
         linereader.appendTabCompletion("limit ");
         linereader.appendTabCompletion("memory");
         linereader.appendTabCompletion("configuration");
+        linereader.appendTabCompletion("counters");
 
         // add rel tab completes after the rest so users can see all commands first
         for (auto& row : Tools::formatTable(relationTable, precision)) {
@@ -1017,6 +1027,58 @@ public:
         std::cout << std::endl;
     }
 
+    /** Display the performance counters of relations and their rules, ordered by the first counter */
+    void counters(std::size_t limit) {
+        const auto& db = ProfileEventSingleton::instance().getDB();
+        auto* namesEntry = as<TextEntry>(db.lookupEntry({"program", "counters"}));
+        auto* relations = as<DirectoryEntry>(db.lookupEntry({"program", "relation"}));
+        if (namesEntry == nullptr || relations == nullptr) {
+            std::cout << "No performance counters recorded, use --profile-counters.\n";
+            return;
+        }
+        const std::vector<std::string> names = Tools::split(namesEntry->getText(), ",");
+
+        std::vector<std::pair<std::vector<std::size_t>, std::string>> rows;
+        auto addRow = [&](const DirectoryEntry* entry, const std::string& name) {
+            if (entry == nullptr) {
+                return;
+            }
+            std::vector<std::size_t> values;
+            for (const auto& counter : names) {
+                auto* value = as<SizeEntry>(entry->readEntry(counter));
+                values.push_back(value != nullptr ? value->getSize() : 0);
+            }
+            rows.emplace_back(std::move(values), name);
+        };
+        for (const auto& rel : relations->getKeys()) {
+            auto* relation = relations->readDirectoryEntry(rel);
+            if (relation == nullptr) {
+                continue;
+            }
+            addRow(relation->readDirectoryEntry("counters"), rel);
+            if (auto* rules = relation->readDirectoryEntry("rule-counters")) {
+                for (const auto& rule : rules->getKeys()) {
+                    addRow(rules->readDirectoryEntry(rule), "  " + rule);
+                }
+            }
+        }
+        std::stable_sort(rows.begin(), rows.end(),
+                [](const auto& a, const auto& b) { return a.first.front() > b.first.front(); });
+
+        std::cout << "  ----- Performance Counters -----\n";
+        for (const auto& name : names) {
+            std::printf("%18s", name.c_str());
+        }
+        std::printf("  %s\n", "NAME");
+        for (std::size_t i = 0; i < rows.size() && i < limit; i++) {
+            for (std::size_t value : rows[i].first) {
+                std::printf("%18s", Tools::formatNum(precision, value).c_str());
+            }
+            std::printf("  %s\n", rows[i].second.c_str());
+        }
+        std::cout << std::endl;
+    }
+
     void top() {
         const std::shared_ptr<ProgramRun>& run = out.getProgramRun();
         auto* totalRelationsEntry = as<TextEntry>(ProfileEventSingleton::instance().getDB().lookupEntry(
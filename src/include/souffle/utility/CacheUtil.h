@@ -17,6 +17,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <fstream>
 
 // -------------------------------------------------------------------------------
@@ -25,6 +26,25 @@
 
 namespace souffle {
 
+/** The size of a cache line, in bytes, assumed when prefetching */
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Requests the cache lines of the given memory area to be loaded, without waiting
+ * for them. Does nothing on compilers without prefetch support.
+ */
+inline void prefetchMemory(const void* begin, std::size_t size) {
+#if defined(__GNUC__) || defined(__clang__)
+    const char* bytes = static_cast<const char*>(begin);
+    for (std::size_t offset = 0; offset < size; offset += CACHE_LINE_SIZE) {
+        __builtin_prefetch(bytes + offset);
+    }
+#else
+    (void)begin;
+    (void)size;
+#endif
+}
+
 /**
  * An Least-Recently-Used cache for arbitrary element types. Elements can be signaled
  * to be accessed and iterated through in their LRU order.
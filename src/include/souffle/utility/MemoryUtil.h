@@ -0,0 +1,80 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MemoryUtil.h
+ *
+ * @brief Utilities for inspecting and releasing the memory of the process
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef WIN32
+#include <windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif  // WIN32
+
+namespace souffle {
+
+/**
+ * Return the current resident set size of the process in bytes.
+ *
+ * Where the current resident set size cannot be determined, the peak
+ * resident set size is returned instead.
+ */
+inline std::size_t getResidentMemory() {
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS processMemoryCounters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &processMemoryCounters, sizeof(processMemoryCounters));
+    return processMemoryCounters.WorkingSetSize;
+#else
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total = 0;
+    std::size_t resident = 0;
+    if (statm >> total >> resident) {
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif  // __linux__
+    struct rusage ru {};
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(ru.ru_maxrss);
+#else
+    return static_cast<std::size_t>(ru.ru_maxrss) * 1024;
+#endif  // __APPLE__
+#endif  // WIN32
+}
+
+/** The amount of cleared tuple data after which freed memory is handed back to the operating system */
+constexpr std::size_t MEMORY_RELEASE_THRESHOLD = 64 * 1024 * 1024;
+
+/**
+ * Hand memory that has been freed back to the operating system.
+ *
+ * Clearing a relation returns its nodes to the heap of the allocator, which
+ * keeps them for later allocations; the resident set size of the process
+ * only shrinks once the unused pages are released.
+ */
+inline void releaseFreeMemory() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif  // __GLIBC__
+}
+
+}  // namespace souffle
@@ -39,7 +39,9 @@ public:
     /** This constructor is used when program enter a new scope.
      * Only Subroutine value needs to be copied */
     Context(Context& ctxt) : returnValues(ctxt.returnValues), args(ctxt.args) {}
-    virtual ~Context() = default;
+    virtual ~Context() {
+        flushBuffers();
+    }
 
     const RamDomain*& operator[](std::size_t index) {
         if (index >= data.size()) {
@@ -109,6 +111,28 @@ public:
         return views[id].get();
     }
 
+    /** @brief Return an insert buffer of a relation, which is created on first use */
+    template <typename Rel>
+    typename Rel::Buffer& getBuffer(Rel& rel, std::size_t id) {
+        if (buffers.size() < id + 1) {
+            buffers.resize(id + 1);
+        }
+        if (!buffers[id]) {
+            buffers[id] = mk<typename Rel::Buffer>(rel);
+        }
+        return static_cast<typename Rel::Buffer&>(*buffers[id]);
+    }
+
+    /** @brief Add the tuples of all insert buffers to their relations, and release the buffers */
+    void flushBuffers() {
+        for (auto& buffer : buffers) {
+            if (buffer) {
+                buffer->flush();
+            }
+        }
+        buffers.clear();
+    }
+
 private:
     /** @brief Run-time value */
     std::vector<const RamDomain*> data;
@@ -120,6 +144,8 @@ private:
     VecOwn<RamDomain[]> allocatedDataContainer;
     /** @brief Views */
     VecOwn<ViewWrapper> views;
+    /** @brief Insert buffers */
+    VecOwn<BufferWrapper> buffers;
 };
 
 }  // namespace souffle::interpreter
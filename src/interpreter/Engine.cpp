@@ -24,7 +24,9 @@
 #include "interpreter/ViewContext.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Break.h"
+#include "ram/BuildBloomFilter.h"
 #include "ram/Call.h"
 #include "ram/Choice.h"
 #include "ram/Clear.h"
@@ -43,6 +45,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -87,8 +90,10 @@
 #include "souffle/io/ReadStream.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/profile/Logger.h"
+#include "souffle/profile/PerfCounters.h"
 #include "souffle/profile/ProfileEvent.h"
 #include "souffle/utility/EvaluatorUtil.h"
+#include "souffle/utility/MemoryUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StringUtil.h"
@@ -99,15 +104,16 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <dlfcn.h>
@@ -137,14 +143,31 @@ namespace souffle::interpreter {
 
 namespace {
 constexpr RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;
+
+/** Apply an operation to the values of two registers of a batch, in a loop that compilers vectorise */
+template <typename T, typename F>
+void mapBatch(RamDomain* target, const RamDomain* lhs, const RamDomain* rhs, std::size_t count, F op) {
+    for (std::size_t i = 0; i < count; ++i) {
+        target[i] = ramBitCast(static_cast<T>(op(ramBitCast<T>(lhs[i]), ramBitCast<T>(rhs[i]))));
+    }
+}
+
+/** Deselect the tuples of a batch whose values in two registers fail a comparison */
+template <typename T, typename F>
+void selectBatch(uint8_t* selected, const RamDomain* lhs, const RamDomain* rhs, std::size_t count, F cmp) {
+    for (std::size_t i = 0; i < count; ++i) {
+        selected[i] &= static_cast<uint8_t>(cmp(ramBitCast<T>(lhs[i]), ramBitCast<T>(rhs[i])));
+    }
 }
+}  // namespace
 
 Engine::Engine(ram::TranslationUnit& tUnit)
         : profileEnabled(Global::config().has("profile")),
           frequencyCounterEnabled(Global::config().has("profile-frequency")),
           isProvenance(Global::config().has("provenance")),
+          batchEnabled(Global::config().has("batch")),
           numOfThreads(std::stoi(Global::config().get("jobs"))), tUnit(tUnit),
-          isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()) {
+          isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()), writers(numOfThreads) {
 #ifdef _OPENMP
     if (numOfThreads > 0) {
         omp_set_num_threads(numOfThreads);
@@ -186,6 +209,14 @@ void* Engine::getMethodHandle(const std::string& method) {
 }
 
 VecOwn<Engine::RelationHandle>& Engine::getRelationMap() {
+    // relations are created when they are first used by the intermediate representation
+    for (const ram::Relation* rel : tUnit.getProgram().getRelations()) {
+        getGenerator().encodeRelation(rel->getName());
+    }
+    writers.waitAll();
+    if (spillManager) {
+        spillManager->restoreAll();
+    }
     return relations;
 }
 
@@ -196,11 +227,18 @@ void Engine::createRelation(const ram::Relation& id, const std::size_t idx) {
 
     RelationHandle res;
 
-    if (id.getRepresentation() == RelationRepresentation::EQREL) {
+    RelationRepresentation representation = isa->getRepresentation(id);
+    if (representation == RelationRepresentation::EQREL) {
         res = createEqrelRelation(id, isa->getIndexSelection(id.getName()));
     } else {
         if (isProvenance) {
             res = createProvenanceRelation(id, isa->getIndexSelection(id.getName()));
+        } else if (representation == RelationRepresentation::HASHSET) {
+            res = createHashsetRelation(id, isa->getIndexSelection(id.getName()));
+        } else if (representation == RelationRepresentation::COLUMNAR) {
+            res = createColumnarRelation(id, isa->getIndexSelection(id.getName()));
+        } else if (representation == RelationRepresentation::COMPRESSED) {
+            res = createCompressedRelation(id, isa->getIndexSelection(id.getName()));
         } else {
             res = createBTreeRelation(id, isa->getIndexSelection(id.getName()));
         }
@@ -272,21 +310,38 @@ void Engine::executeMain() {
     generateIR();
     assert(main != nullptr && "Executing an empty program");
 
+    if (Global::config().has("memory-limit")) {
+        spillManager = mk<SpillManager>(
+                std::stoul(Global::config().get("memory-limit")), tUnit.getProgram(), *isa, relations);
+    }
+
     Context ctxt;
 
     if (!profileEnabled) {
         Context ctxt;
         execute(main.get(), ctxt);
     } else {
-        ProfileEventSingleton::instance().setOutputFile(Global::config().get("profile"));
-        // Prepare the frequency table for threaded use
-        const ram::Program& program = tUnit.getProgram();
-        visit(program, [&](const ram::TupleOperation& node) {
-            if (!node.getProfileText().empty()) {
-                frequencies.emplace(node.getProfileText(), std::deque<std::atomic<std::size_t>>());
-                frequencies[node.getProfileText()].emplace_back(0);
+        // Live profiling reads the events from the database, otherwise they are streamed to a binary
+        // log unless it is written as JSON
+        ProfileEventSingleton::instance().setOutputFile(
+                Global::config().get("profile"), !Global::config().has("live-profile"));
+        // Counters are assigned while generating the tree and determine the layout of the frequency
+        // tables, so all subroutines are generated before anything is counted
+        if (frequencyCounterEnabled) {
+            for (std::size_t id = 0; id < subroutine.size(); ++id) {
+                getSubroutine(id);
             }
-        });
+        }
+        // Prepare the frequency tables of all threads
+        const ram::Program& program = tUnit.getProgram();
+#ifdef _OPENMP
+        frequencies.reset(omp_get_max_threads());
+#else
+        frequencies.reset(1);
+#endif
+        if (Global::config().has("profile-counters")) {
+            profile::PerfCounters::instance().open();
+        }
         // Enable profiling for execution of main
         ProfileEventSingleton::instance().startTimer();
         ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");
@@ -312,30 +367,41 @@ void Engine::executeMain() {
         Context ctxt;
         execute(main.get(), ctxt);
         ProfileEventSingleton::instance().stopTimer();
-        for (auto const& cur : frequencies) {
-            for (std::size_t i = 0; i < cur.second.size(); ++i) {
-                ProfileEventSingleton::instance().makeQuantityEvent(cur.first, cur.second[i], i);
-            }
-        }
+        frequencies.forEachCount([](const std::string& text, std::size_t iteration, std::size_t count) {
+            ProfileEventSingleton::instance().makeQuantityEvent(text, count, iteration);
+        });
         for (auto const& cur : reads) {
             ProfileEventSingleton::instance().makeQuantityEvent(
                     "@relation-reads;" + cur.first, cur.second, 0);
         }
     }
+    writers.waitAll();
     SignalHandler::instance()->reset();
 }
 
-void Engine::generateIR() {
-    const ram::Program& program = tUnit.getProgram();
-    NodeGenerator generator(*this);
-    if (subroutine.empty()) {
-        for (const auto& sub : program.getSubroutines()) {
-            subroutine.push_back(generator.generateTree(*sub.second));
-        }
+NodeGenerator& Engine::getGenerator() {
+    if (generator == nullptr) {
+        generator = mk<NodeGenerator>(*this);
+        subroutine.resize(tUnit.getProgram().getSubroutines().size());
     }
+    return *generator;
+}
+
+void Engine::generateIR() {
     if (main == nullptr) {
-        main = generator.generateTree(program.getMain());
+        main = getGenerator().generateTree(tUnit.getProgram().getMain());
+    }
+}
+
+const Node* Engine::getSubroutine(std::size_t id) {
+    // strata and provenance subproofs that are never executed are not generated, and neither are
+    // the relations only they use, unless the frequencies are profiled
+    NodeGenerator& gen = getGenerator();
+    if (subroutine[id] == nullptr) {
+        auto subs = tUnit.getProgram().getSubroutines();
+        subroutine[id] = gen.generateTree(*std::next(subs.begin(), id)->second);
     }
+    return subroutine[id].get();
 }
 
 void Engine::executeSubroutine(
@@ -343,11 +409,13 @@ void Engine::executeSubroutine(
     Context ctxt;
     ctxt.setReturnValues(ret);
     ctxt.setArguments(args);
-    generateIR();
+    if (spillManager) {
+        spillManager->restoreAll();
+    }
     const ram::Program& program = tUnit.getProgram();
     auto subs = program.getSubroutines();
     std::size_t i = distance(subs.begin(), subs.find(name));
-    execute(subroutine[i].get(), ctxt);
+    execute(getSubroutine(i), ctxt);
 }
 
 RamDomain Engine::execute(const Node* node, Context& ctxt) {
@@ -824,6 +892,14 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         FOR_EACH_PROVENANCE(PROVENANCE_EXISTENCE_CHECK)
 #undef PROVENANCE_EXISTENCE_CHECK
 
+        CASE(BloomFilterCheck)
+            uint64_t hash = BloomFilter::begin(shadow.getChildren().size());
+            for (const auto& child : shadow.getChildren()) {
+                hash = BloomFilter::combine(hash, execute(child.get(), ctxt));
+            }
+            return shadow.getFilter().mayContain(BloomFilter::finish(hash));
+        ESAC(BloomFilterCheck)
+
         CASE(Constraint)
         // clang-format off
 #define COMPARE_NUMERIC(ty, op) return EVAL_LEFT(ty) op EVAL_RIGHT(ty)
@@ -903,14 +979,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
         CASE(TupleOperation)
             bool result = execute(shadow.getChild(), ctxt);
-
-            auto& currentFrequencies = frequencies[cur.getProfileText()];
-            while (currentFrequencies.size() <= getIterationNumber()) {
-#pragma omp critical(frequencies)
-                currentFrequencies.emplace_back(0);
-            }
-            frequencies[cur.getProfileText()][getIterationNumber()]++;
-
+            frequencies.increment(shadow.getCounter(), getIterationNumber());
             return result;
         ESAC(TupleOperation)
 
@@ -948,6 +1017,10 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         FOR_EACH(PARALLEL_INDEX_SCAN)
 #undef PARALLEL_INDEX_SCAN
 
+        CASE(LeapfrogScan)
+            return evalLeapfrogScan(cur, shadow, ctxt);
+        ESAC(LeapfrogScan)
+
 #define CHOICE(Structure, Arity, ...)                                   \
     CASE(Choice, Structure, Arity)                                      \
         const auto& rel = *static_cast<RelType*>(shadow.getRelation()); \
@@ -1053,12 +1126,8 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                 result = execute(shadow.getNestedOperation(), ctxt);
             }
 
-            if (profileEnabled && frequencyCounterEnabled && !cur.getProfileText().empty()) {
-                auto& currentFrequencies = frequencies[cur.getProfileText()];
-                while (currentFrequencies.size() <= getIterationNumber()) {
-                    currentFrequencies.emplace_back(0);
-                }
-                frequencies[cur.getProfileText()][getIterationNumber()]++;
+            if (shadow.isCounted()) {
+                frequencies.increment(shadow.getCounter(), getIterationNumber());
             }
             return result;
         ESAC(Filter)
@@ -1112,7 +1181,14 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
         CASE(Loop)
             resetIterationNumber();
-            while (execute(shadow.getChild(), ctxt)) {
+            while (true) {
+                std::optional<TraceSpan> span;
+                if (profileEnabled) {
+                    span.emplace("@iteration;iteration " + std::to_string(getIterationNumber()));
+                }
+                if (!execute(shadow.getChild(), ctxt)) {
+                    break;
+                }
                 incIterationNumber();
             }
             resetIterationNumber();
@@ -1141,7 +1217,9 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
 #define CLEAR(Structure, Arity, ...)                              \
     CASE(Clear, Structure, Arity)                                 \
+        writers.wait(shadow.getRelation());                       \
         auto& rel = *static_cast<RelType*>(shadow.getRelation()); \
+        clearedMemory += rel.size() * Arity * sizeof(RamDomain);  \
         rel.__purge();                                            \
         return true;                                              \
     ESAC(Clear)
@@ -1149,8 +1227,38 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         FOR_EACH(CLEAR)
 #undef CLEAR
 
+        CASE(BuildBloomFilter)
+            const auto& rel = *shadow.getRelation();
+            const auto& columns = cur.getColumns();
+            auto& filter = shadow.getFilter();
+            filter.reset(rel.size());
+            for (const RamDomain* tuple : rel) {
+                uint64_t hash = BloomFilter::begin(columns.size());
+                for (std::size_t column : columns) {
+                    hash = BloomFilter::combine(hash, tuple[column]);
+                }
+                filter.insert(BloomFilter::finish(hash));
+            }
+            return true;
+        ESAC(BuildBloomFilter)
+
         CASE(Call)
-            execute(subroutine[shadow.getSubroutineId()].get(), ctxt);
+            if (spillManager) {
+                // spilling modifies relations that may still be written
+                writers.waitAll();
+                spillManager->enterStratum(shadow.getSubroutineId());
+            }
+            {
+                std::optional<TraceSpan> span;
+                if (profileEnabled) {
+                    span.emplace("@stratum;" + cur.getName());
+                }
+                execute(getSubroutine(shadow.getSubroutineId()), ctxt);
+            }
+            if (clearedMemory >= MEMORY_RELEASE_THRESHOLD) {
+                releaseFreeMemory();
+                clearedMemory = 0;
+            }
             return true;
         ESAC(Call)
 
@@ -1162,11 +1270,18 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(LogSize)
 
         CASE(IO)
-            const auto& directive = cur.getDirectives();
+            // streams compress and decompress with the threads of the program
+            auto directive = cur.getDirectives();
+            directive["jobs"] = std::to_string(writers.getNumThreads());
             const std::string& op = cur.get("operation");
             auto& rel = *shadow.getRelation();
+            std::optional<TraceSpan> span;
+            if (profileEnabled) {
+                span.emplace("@io;" + cur.getRelation() + ";" + op);
+            }
 
             if (op == "input") {
+                writers.wait(shadow.getRelation());
                 try {
                     IOSystem::getInstance()
                             .getReader(directive, getSymbolTable(), getRecordTable())
@@ -1176,14 +1291,13 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                 }
                 return true;
             } else if (op == "output" || op == "printsize") {
-                try {
+                // the relation is written while evaluation continues, until it is modified again
+                RelationWrapper* relation = shadow.getRelation();
+                writers.write(relation, directive, [this, directive, relation](bool concurrent) {
                     IOSystem::getInstance()
                             .getWriter(directive, getSymbolTable(), getRecordTable())
-                            ->writeAll(rel);
-                } catch (std::exception& e) {
-                    std::cerr << e.what();
-                    exit(EXIT_FAILURE);
-                }
+                            ->writeAll(*relation, concurrent);
+                });
                 return true;
             } else {
                 assert("wrong i/o operation");
@@ -1192,6 +1306,10 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(IO)
 
         CASE(Query)
+            std::optional<TraceSpan> span;
+            if (profileEnabled) {
+                span.emplace("@query");
+            }
             ViewContext* viewContext = shadow.getViewContext();
 
             // Execute view-free operations in outer filter if any.
@@ -1226,10 +1344,13 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                 }
             }
             execute(shadow.getChild(), ctxt);
+            ctxt.flushBuffers();
             return true;
         ESAC(Query)
 
         CASE(Extend)
+            writers.wait(getRelationHandle(shadow.getSourceId()).get());
+            writers.wait(getRelationHandle(shadow.getTargetId()).get());
             auto& src = *static_cast<EqrelRelation*>(getRelationHandle(shadow.getSourceId()).get());
             auto& trg = *static_cast<EqrelRelation*>(getRelationHandle(shadow.getTargetId()).get());
             src.extend(trg);
@@ -1238,6 +1359,8 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(Extend)
 
         CASE(Swap)
+            writers.wait(getRelationHandle(shadow.getSourceId()).get());
+            writers.wait(getRelationHandle(shadow.getTargetId()).get());
             swapRelation(shadow.getSourceId(), shadow.getTargetId());
             return true;
         ESAC(Swap)
@@ -1341,7 +1464,25 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
 
 template <typename Rel>
 RamDomain Engine::evalScan(const Rel& rel, const ram::Scan& cur, const Scan& shadow, Context& ctxt) {
-    for (const auto& tuple : rel.scan()) {
+    // column stores skip the chunks ruled out by comparisons with constants
+    auto tuples = [&]() {
+        if constexpr (std::is_same_v<Rel, Relation<Rel::Arity, Columnar>>) {
+            return rel.filter(shadow.getColumnPredicates());
+        } else {
+            return rel.scan();
+        }
+    }();
+
+    if (shadow.getBatchFilter() != nullptr) {
+        evalBatchedTuples<Rel::Arity>(tuples, cur.getTupleId(), shadow, ctxt);
+        return true;
+    }
+    if (!shadow.getProbes().empty()) {
+        evalProbedTuples<Rel::Arity>(tuples, cur.getTupleId(), shadow, ctxt);
+        return true;
+    }
+
+    for (const auto& tuple : tuples) {
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
             break;
@@ -1350,20 +1491,179 @@ RamDomain Engine::evalScan(const Rel& rel, const ram::Scan& cur, const Scan& sha
     return true;
 }
 
+template <std::size_t Arity, typename Range>
+void Engine::evalProbedTuples(const Range& range, std::size_t tupleId, const Scan& shadow, Context& ctxt) {
+    constexpr std::size_t groupSize = Scan::PROBE_GROUP_SIZE;
+    std::array<souffle::Tuple<RamDomain, Arity>, groupSize> group;
+    RamDomain keys[groupSize * Scan::MAX_PROBE_ARITY];
+
+    auto it = range.begin();
+    const auto end = range.end();
+    while (it != end) {
+        std::size_t count = 0;
+        for (; count < groupSize && it != end; ++it) {
+            std::copy_n((*it).data(), Arity, group[count++].begin());
+        }
+
+        // walk the keys of all tuples of the group through each probed index together
+        for (const ExistenceCheck* probe : shadow.getProbes()) {
+            const auto& superInfo = probe->getSuperInst();
+            const std::size_t keyArity = superInfo.first.size();
+            for (std::size_t i = 0; i < count; ++i) {
+                RamDomain* key = &keys[i * keyArity];
+                std::copy(superInfo.first.begin(), superInfo.first.end(), key);
+                for (const auto& tupleElement : superInfo.tupleFirst) {
+                    key[tupleElement[0]] = group[i][tupleElement[2]];
+                }
+            }
+            ctxt.getView(probe->getViewId())->prefetch(keys, count);
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            ctxt[tupleId] = group[i].data();
+            if (!execute(shadow.getNestedOperation(), ctxt)) {
+                return;
+            }
+        }
+    }
+}
+
+template <std::size_t Arity, typename Range>
+void Engine::evalBatchedTuples(const Range& range, std::size_t tupleId, const Scan& shadow, Context& ctxt) {
+    constexpr std::size_t batchSize = BatchFilter::BATCH_SIZE;
+    const BatchFilter& filter = *shadow.getBatchFilter();
+    std::vector<souffle::Tuple<RamDomain, Arity>> batch(batchSize);
+    std::vector<RamDomain> registers(filter.getRegisterCount() * batchSize);
+    std::vector<uint8_t> selected(batchSize);
+
+    auto it = range.begin();
+    const auto end = range.end();
+    while (it != end) {
+        std::size_t count = 0;
+        for (; count < batchSize && it != end; ++it) {
+            std::copy_n((*it).data(), Arity, batch[count++].begin());
+        }
+        std::fill_n(selected.begin(), count, 1);
+        evalBatchFilter(filter, batch.front().data(), Arity, count, registers.data(), selected.data());
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (selected[i] == 0) {
+                continue;
+            }
+            ctxt[tupleId] = batch[i].data();
+            if (!execute(shadow.getNestedOperation(), ctxt)) {
+                return;
+            }
+        }
+    }
+}
+
+void Engine::evalBatchFilter(const BatchFilter& filter, const RamDomain* tuples, std::size_t arity,
+        std::size_t count, RamDomain* registers, uint8_t* selected) {
+    constexpr std::size_t batchSize = BatchFilter::BATCH_SIZE;
+    // clang-format off
+#define BATCH_FUNCTOR(opCode, ty, op)                                  \
+    case FunctorOp::opCode: mapBatch<ty>(target, lhs, rhs, count, op); break;
+#define BATCH_COMPARE(opCode, ty, cmp)                                 \
+    case BinaryConstraintOp::opCode: selectBatch<ty>(selected, lhs, rhs, count, cmp); break;
+    // clang-format on
+
+    for (const auto& instruction : filter.getInstructions()) {
+        RamDomain* target = registers + instruction.target * batchSize;
+        const RamDomain* lhs = registers + instruction.lhs * batchSize;
+        const RamDomain* rhs = registers + instruction.rhs * batchSize;
+        switch (instruction.kind) {
+            case BatchFilter::Kind::Column:
+                for (std::size_t i = 0; i < count; ++i) {
+                    target[i] = tuples[i * arity + instruction.value];
+                }
+                break;
+            case BatchFilter::Kind::Constant: std::fill_n(target, count, instruction.value); break;
+            case BatchFilter::Kind::Functor:
+                // signed arithmetic is done on the unsigned values of the same bits, which wrap around
+                switch (instruction.functor) {
+                    BATCH_FUNCTOR(NEG, RamUnsigned, [](RamUnsigned x, RamUnsigned) { return 0 - x; })
+                    BATCH_FUNCTOR(FNEG, RamFloat, [](RamFloat x, RamFloat) { return -x; })
+                    BATCH_FUNCTOR(BNOT, RamUnsigned, [](RamUnsigned x, RamUnsigned) { return ~x; })
+                    BATCH_FUNCTOR(UBNOT, RamUnsigned, [](RamUnsigned x, RamUnsigned) { return ~x; })
+                    BATCH_FUNCTOR(ADD, RamUnsigned, std::plus<RamUnsigned>())
+                    BATCH_FUNCTOR(UADD, RamUnsigned, std::plus<RamUnsigned>())
+                    BATCH_FUNCTOR(FADD, RamFloat, std::plus<RamFloat>())
+                    BATCH_FUNCTOR(SUB, RamUnsigned, std::minus<RamUnsigned>())
+                    BATCH_FUNCTOR(USUB, RamUnsigned, std::minus<RamUnsigned>())
+                    BATCH_FUNCTOR(FSUB, RamFloat, std::minus<RamFloat>())
+                    BATCH_FUNCTOR(MUL, RamUnsigned, std::multiplies<RamUnsigned>())
+                    BATCH_FUNCTOR(UMUL, RamUnsigned, std::multiplies<RamUnsigned>())
+                    BATCH_FUNCTOR(FMUL, RamFloat, std::multiplies<RamFloat>())
+                    BATCH_FUNCTOR(BAND, RamUnsigned, std::bit_and<RamUnsigned>())
+                    BATCH_FUNCTOR(UBAND, RamUnsigned, std::bit_and<RamUnsigned>())
+                    BATCH_FUNCTOR(BOR, RamUnsigned, std::bit_or<RamUnsigned>())
+                    BATCH_FUNCTOR(UBOR, RamUnsigned, std::bit_or<RamUnsigned>())
+                    BATCH_FUNCTOR(BXOR, RamUnsigned, std::bit_xor<RamUnsigned>())
+                    BATCH_FUNCTOR(UBXOR, RamUnsigned, std::bit_xor<RamUnsigned>())
+                    default: fatal("unsupported batch functor");
+                }
+                break;
+            case BatchFilter::Kind::Comparison:
+                switch (instruction.comparison) {
+                    BATCH_COMPARE(EQ, RamDomain, std::equal_to<RamDomain>())
+                    BATCH_COMPARE(FEQ, RamFloat, std::equal_to<RamFloat>())
+                    BATCH_COMPARE(NE, RamDomain, std::not_equal_to<RamDomain>())
+                    BATCH_COMPARE(FNE, RamFloat, std::not_equal_to<RamFloat>())
+                    BATCH_COMPARE(LT, RamSigned, std::less<RamSigned>())
+                    BATCH_COMPARE(ULT, RamUnsigned, std::less<RamUnsigned>())
+                    BATCH_COMPARE(FLT, RamFloat, std::less<RamFloat>())
+                    BATCH_COMPARE(LE, RamSigned, std::less_equal<RamSigned>())
+                    BATCH_COMPARE(ULE, RamUnsigned, std::less_equal<RamUnsigned>())
+                    BATCH_COMPARE(FLE, RamFloat, std::less_equal<RamFloat>())
+                    BATCH_COMPARE(GT, RamSigned, std::greater<RamSigned>())
+                    BATCH_COMPARE(UGT, RamUnsigned, std::greater<RamUnsigned>())
+                    BATCH_COMPARE(FGT, RamFloat, std::greater<RamFloat>())
+                    BATCH_COMPARE(GE, RamSigned, std::greater_equal<RamSigned>())
+                    BATCH_COMPARE(UGE, RamUnsigned, std::greater_equal<RamUnsigned>())
+                    BATCH_COMPARE(FGE, RamFloat, std::greater_equal<RamFloat>())
+                    default: fatal("unsupported batch comparison");
+                }
+                break;
+        }
+    }
+
+#undef BATCH_FUNCTOR
+#undef BATCH_COMPARE
+}
+
 template <typename Rel>
 RamDomain Engine::evalParallelScan(
         const Rel& rel, const ram::ParallelScan& cur, const ParallelScan& shadow, Context& ctxt) {
     auto viewContext = shadow.getViewContext();
 
-    auto pStream = rel.partitionScan(numOfThreads);
+    auto pStream = [&]() {
+        if constexpr (std::is_same_v<Rel, Relation<Rel::Arity, Columnar>>) {
+            return rel.partitionFilter(shadow.getColumnPredicates(), numOfThreads);
+        } else {
+            return rel.partitionScan(numOfThreads);
+        }
+    }();
 
     PARALLEL_START
+        std::optional<TraceSpan> span;
+        if (profileEnabled) {
+            span.emplace("@parallel");
+        }
         Context newCtxt(ctxt);
         auto viewInfo = viewContext->getViewInfoForNested();
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            if (shadow.getBatchFilter() != nullptr) {
+                evalBatchedTuples<Rel::Arity>(*it, cur.getTupleId(), shadow, newCtxt);
+                continue;
+            }
+            if (!shadow.getProbes().empty()) {
+                evalProbedTuples<Rel::Arity>(*it, cur.getTupleId(), shadow, newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1387,6 +1687,10 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
     std::size_t viewId = shadow.getViewId();
     auto view = Rel::castView(ctxt.getView(viewId));
     // conduct range query
+    if (!shadow.getProbes().empty()) {
+        evalProbedTuples<Arity>(view->range(low, high), cur.getTupleId(), shadow, ctxt);
+        return true;
+    }
     for (const auto& tuple : view->range(low, high)) {
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
@@ -1396,6 +1700,65 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
     return true;
 }
 
+RamDomain Engine::evalLeapfrogScan(const ram::LeapfrogScan& cur, const LeapfrogScan& shadow, Context& ctxt) {
+    // bounds and views of the scan followed by those of its partners; all their encoded
+    // tuples end with the intersected column, as every other column is bound
+    const auto& partners = shadow.getPartners();
+    const std::size_t count = partners.size() + 1;
+    std::vector<std::vector<RamDomain>> lows(count);
+    std::vector<std::vector<RamDomain>> highs(count);
+    std::vector<ViewWrapper*> views(count);
+    auto setBounds = [&](std::size_t i, const SuperInstruction& superInfo, std::size_t viewId) {
+        lows[i] = superInfo.first;
+        for (const auto& tupleElement : superInfo.tupleFirst) {
+            lows[i][tupleElement[0]] = ctxt[tupleElement[1]][tupleElement[2]];
+        }
+        for (const auto& expr : superInfo.exprFirst) {
+            lows[i][expr.first] = execute(expr.second.get(), ctxt);
+        }
+        highs[i] = lows[i];
+        highs[i].back() = MAX_RAM_SIGNED;
+        views[i] = ctxt.getView(viewId);
+    };
+    setBounds(0, shadow.getSuperInst(), shadow.getViewId());
+    for (std::size_t i = 1; i < count; ++i) {
+        setBounds(i, partners[i - 1]->getSuperInst(), partners[i - 1]->getViewId());
+    }
+
+    // the ranges seek the largest value found so far in turn, until all of them agree on it
+    RamDomain value = MIN_RAM_SIGNED;
+    std::size_t agreed = 0;
+    const RamDomain* tuple = nullptr;
+    for (std::size_t i = 0;; i = (i + 1) % count) {
+        lows[i].back() = value;
+        const RamDomain* found = views[i]->seek(lows[i].data(), highs[i].data());
+        if (found == nullptr) {
+            break;
+        }
+        if (i == 0) {
+            tuple = found;
+        }
+        RamDomain next = found[lows[i].size() - 1];
+        if (next != value) {
+            value = next;
+            agreed = 1;
+        } else {
+            agreed++;
+        }
+        if (agreed < count) {
+            continue;
+        }
+
+        ctxt[cur.getTupleId()] = tuple;
+        if (!execute(shadow.getNestedOperation(), ctxt) || value == MAX_RAM_SIGNED) {
+            break;
+        }
+        value++;
+        agreed = 0;
+    }
+    return true;
+}
+
 template <typename Rel>
 RamDomain Engine::evalParallelIndexScan(
         const Rel& rel, const ram::ParallelIndexScan& cur, const ParallelIndexScan& shadow, Context& ctxt) {
@@ -1411,12 +1774,20 @@ RamDomain Engine::evalParallelIndexScan(
     std::size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
     PARALLEL_START
+        std::optional<TraceSpan> span;
+        if (profileEnabled) {
+            span.emplace("@parallel");
+        }
         Context newCtxt(ctxt);
         auto viewInfo = viewContext->getViewInfoForNested();
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+            if (!shadow.getProbes().empty()) {
+                evalProbedTuples<Rel::Arity>(*it, cur.getTupleId(), shadow, newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1449,6 +1820,10 @@ RamDomain Engine::evalParallelChoice(
     auto pStream = rel.partitionScan(numOfThreads);
     auto viewInfo = viewContext->getViewInfoForNested();
     PARALLEL_START
+        std::optional<TraceSpan> span;
+        if (profileEnabled) {
+            span.emplace("@parallel");
+        }
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
@@ -1505,6 +1880,10 @@ RamDomain Engine::evalParallelIndexChoice(const Rel& rel, const ram::ParallelInd
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
 
     PARALLEL_START
+        std::optional<TraceSpan> span;
+        if (profileEnabled) {
+            span.emplace("@parallel");
+        }
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
@@ -1709,8 +2088,12 @@ RamDomain Engine::evalInsert(Rel& rel, const Insert& shadow, Context& ctxt) {
         tuple[expr.first] = execute(expr.second.get(), ctxt);
     }
 
-    // insert in target relation
-    rel.insert(tuple);
+    // insert in target relation, or collect the tuple for a batch insertion
+    if (shadow.isBuffered()) {
+        ctxt.getBuffer(rel, shadow.getBufferId()).insert(tuple);
+    } else {
+        rel.insert(tuple);
+    }
     return true;
 }
 
@@ -1734,8 +2117,12 @@ RamDomain Engine::evalGuardedInsert(Rel& rel, const GuardedInsert& shadow, Conte
         tuple[expr.first] = execute(expr.second.get(), ctxt);
     }
 
-    // insert in target relation
-    rel.insert(tuple);
+    // insert in target relation, or collect the tuple for a batch insertion
+    if (shadow.isBuffered()) {
+        ctxt.getBuffer(rel, shadow.getBufferId()).insert(tuple);
+    } else {
+        rel.insert(tuple);
+    }
     return true;
 }
 
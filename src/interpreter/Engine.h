@@ -18,22 +18,27 @@
 
 #include "Global.h"
 #include "interpreter/Context.h"
+#include "interpreter/FrequencyTable.h"
 #include "interpreter/Generator.h"
 #include "interpreter/Index.h"
 #include "interpreter/Node.h"
 #include "interpreter/Relation.h"
+#include "interpreter/SpillManager.h"
 #include "ram/TranslationUnit.h"
 #include "ram/analysis/Index.h"
 #include "souffle/RamTypes.h"
 #include "souffle/RecordTable.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/datastructure/BloomFilter.h"
+#include "souffle/io/WriterPool.h"
 #include "souffle/utility/ContainerUtil.h"
 #include <atomic>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #ifdef _OPENMP
 #include <omp.h>
@@ -62,8 +67,12 @@ public:
             const std::string& name, const std::vector<RamDomain>& args, std::vector<RamDomain>& ret);
 
 private:
-    /** @brief Generate intermediate representation from RAM */
+    /** @brief Generate intermediate representation of the main program from RAM */
     void generateIR();
+    /** @brief Return the intermediate representation of a subroutine, generated on its first use */
+    const Node* getSubroutine(std::size_t id);
+    /** @brief Return the generator of the intermediate representation */
+    NodeGenerator& getGenerator();
     /** @brief Remove a relation from the environment */
     void dropRelation(const std::size_t relId);
     /** @brief Swap the content of two relations */
@@ -92,7 +101,7 @@ private:
     void resetIterationNumber();
     /** @brief Increment the counter */
     int incCounter();
-    /** @brief Return the relation map. */
+    /** @brief Return the relation map, with all relations of the program created */
     VecOwn<RelationHandle>& getRelationMap();
     /** @brief Create and add relation into the runtime environment.  */
     void createRelation(const ram::Relation& id, const std::size_t idx);
@@ -114,6 +123,30 @@ private:
     template <typename Rel>
     RamDomain evalIndexScan(const ram::IndexScan& cur, const IndexScan& shadow, Context& ctxt);
 
+    /**
+     * Execute the nested operation of a leapfrog scan for each value of the intersected column
+     * that is found both in the range of the scan and in the ranges of all its partners.
+     */
+    RamDomain evalLeapfrogScan(const ram::LeapfrogScan& cur, const LeapfrogScan& shadow, Context& ctxt);
+
+    /**
+     * Execute the nested operation of a scan for each tuple in the given range. The probes
+     * of the nested filter are prefetched for groups of tuples before the tuples are processed.
+     */
+    template <std::size_t Arity, typename Range>
+    void evalProbedTuples(const Range& range, std::size_t tupleId, const Scan& shadow, Context& ctxt);
+
+    /**
+     * Execute the nested operation of a scan for each tuple in the given range that passes the
+     * batch filter of the scan. The tuples are copied in batches, over which the filter is evaluated.
+     */
+    template <std::size_t Arity, typename Range>
+    void evalBatchedTuples(const Range& range, std::size_t tupleId, const Scan& shadow, Context& ctxt);
+
+    /** Evaluate a batch filter over a batch of tuples of the given arity, and deselect failing tuples */
+    void evalBatchFilter(const BatchFilter& filter, const RamDomain* tuples, std::size_t arity,
+            std::size_t count, RamDomain* registers, uint8_t* selected);
+
     template <typename Rel>
     RamDomain evalParallelIndexScan(const Rel& rel, const ram::ParallelIndexScan& cur,
             const ParallelIndexScan& shadow, Context& ctxt);
@@ -158,7 +191,9 @@ private:
     const bool frequencyCounterEnabled;
     /** If running a provenance program */
     const bool isProvenance;
-    /** subroutines */
+    /** If outer scans evaluate their filters over batches of tuples */
+    const bool batchEnabled;
+    /** subroutines, which are null until they are first executed */
     VecOwn<Node> subroutine;
     /** main program */
     Own<Node> main;
@@ -168,22 +203,32 @@ private:
     std::atomic<RamDomain> counter{0};
     /** Loop iteration counter */
     std::size_t iteration = 0;
+    /** Tuple data cleared since memory has been released to the operating system */
+    std::size_t clearedMemory = 0;
     /** Profile for rule frequencies */
-    std::map<std::string, std::deque<std::atomic<std::size_t>>> frequencies;
+    FrequencyTable frequencies;
+    /** Bloom filters over columns of relations, which are kept at fixed addresses */
+    std::map<std::pair<std::string, std::vector<std::size_t>>, BloomFilter> bloomFilters;
     /** Profile for relation reads */
     std::map<std::string, std::atomic<std::size_t>> reads;
     /** DLL */
     std::vector<void*> dll;
     /** Program */
     ram::TranslationUnit& tUnit;
+    /** Generator of the intermediate representation, which creates relations on their first use */
+    Own<NodeGenerator> generator;
     /** IndexAnalysis */
     ram::analysis::IndexAnalysis* isa;
     /** Record Table*/
     RecordTable recordTable;
     /** Symbol table for relations */
     VecOwn<RelationHandle> relations;
+    /** Spill manager enforcing the memory limit, if any */
+    Own<SpillManager> spillManager;
     /** Symbol table */
     SymbolTable symbolTable;
+    /** Writers of output relations, which finish before the relations are destroyed */
+    WriterPool writers;
 };
 
 }  // namespace souffle::interpreter
@@ -0,0 +1,128 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file FrequencyTable.h
+ *
+ * Declares the table of frequency counters used by the interpreter when
+ * profiling with --profile-frequency.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle::interpreter {
+
+/**
+ * @class FrequencyTable
+ * @brief Counts the executions of profiled operations
+ *
+ * Each profiled operation is assigned a counter while the interpreter tree
+ * is generated; operations sharing a profile text share their counter.
+ * Every thread increments the counters in a table of its own, indexed by
+ * the loop iteration and the counter, so counting requires neither locks
+ * nor atomic operations. The tables of all threads are only summed up
+ * when the profile is written. As the number of counters is the stride of
+ * the tables, all counters have to be created before the tables are prepared.
+ */
+class FrequencyTable {
+public:
+    /** @brief Get the counter of the given profile text, creating it if necessary */
+    std::size_t getCounter(const std::string& profileText) {
+        auto pos = counters.find(profileText);
+        if (pos != counters.end()) {
+            return pos->second;
+        }
+        assert(tables.empty() && "counter created after the frequency tables have been prepared");
+        return counters.emplace(profileText, counters.size()).first->second;
+    }
+
+    /** @brief Discard all counts and prepare the tables for the given number of threads */
+    void reset(std::size_t numThreads) {
+        tables.clear();
+        tables.resize(std::max<std::size_t>(numThreads, 1));
+    }
+
+    /** @brief Count an execution of an operation in the given iteration */
+    inline void increment(std::size_t counter, std::size_t iteration) {
+#ifdef _OPENMP
+        std::size_t thread = omp_get_thread_num();
+#else
+        std::size_t thread = 0;
+#endif
+        assert(thread < tables.size() && "frequency table has not been prepared for the thread");
+        auto& counts = tables[thread].counts;
+        const std::size_t pos = iteration * counters.size() + counter;
+        if (pos >= counts.size()) {
+            counts.resize((iteration + 1) * counters.size(), 0);
+        }
+        counts[pos]++;
+    }
+
+    /**
+     * @brief Sum up the counts of all threads
+     *
+     * The given function is called with the profile text, the iteration and
+     * the count for every iteration up to the last one in which the operation
+     * has been executed, and at least for the first iteration.
+     */
+    template <typename F>
+    void forEachCount(const F& f) const {
+        const std::size_t numCounters = counters.size();
+        if (numCounters == 0) {
+            return;
+        }
+        std::size_t numIterations = 1;
+        for (const auto& table : tables) {
+            numIterations = std::max(numIterations, table.counts.size() / numCounters);
+        }
+
+        std::vector<std::size_t> sums(numIterations);
+        for (const auto& cur : counters) {
+            std::fill(sums.begin(), sums.end(), 0);
+            std::size_t last = 0;
+            for (const auto& table : tables) {
+                for (std::size_t pos = cur.second; pos < table.counts.size(); pos += numCounters) {
+                    std::size_t iteration = pos / numCounters;
+                    sums[iteration] += table.counts[pos];
+                    if (table.counts[pos] != 0) {
+                        last = std::max(last, iteration);
+                    }
+                }
+            }
+            for (std::size_t i = 0; i <= last; i++) {
+                f(cur.first, i, sums[i]);
+            }
+        }
+    }
+
+private:
+    /** Counts of a thread, aligned to a cache line to avoid false sharing */
+    struct alignas(64) ThreadTable {
+        std::vector<std::size_t> counts;
+    };
+
+    /** Counters of the profile texts */
+    std::map<std::string, std::size_t> counters;
+
+    /** Tables of the threads */
+    std::vector<ThreadTable> tables;
+};
+
+}  // namespace souffle::interpreter
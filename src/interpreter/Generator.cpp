@@ -164,6 +164,17 @@ NodePtr NodeGenerator::visit_(
             encodeView(&provExists), std::move(superOp));
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::BloomFilterCheck>, const ram::BloomFilterCheck& check) {
+    NodePtrVec children;
+    for (const auto* value : check.getValues()) {
+        if (!isUndefValue(value)) {
+            children.push_back(dispatch(*value));
+        }
+    }
+    return mk<BloomFilterCheck>(I_BloomFilterCheck, &check, std::move(children),
+            getBloomFilter(check.getRelation(), check.getColumns()));
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::Constraint>, const ram::Constraint& relOp) {
     return mk<Constraint>(I_Constraint, &relOp, dispatch(relOp.getLHS()), dispatch(relOp.getRHS()));
 }
@@ -173,8 +184,9 @@ NodePtr NodeGenerator::visit_(type_identity<ram::NestedOperation>, const ram::Ne
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::TupleOperation>, const ram::TupleOperation& search) {
-    if (engine.profileEnabled && engine.frequencyCounterEnabled && !search.getProfileText().empty()) {
-        return mk<TupleOperation>(I_TupleOperation, &search, dispatch(search.getOperation()));
+    std::size_t counter = getFrequencyCounter(search.getProfileText());
+    if (counter != ProfiledOperation::NO_COUNTER) {
+        return mk<TupleOperation>(I_TupleOperation, &search, dispatch(search.getOperation()), counter);
     }
     return dispatch(search.getOperation());
 }
@@ -184,7 +196,15 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Scan>, const ram::Scan& scan) {
     std::size_t relId = encodeRelation(scan.getRelation());
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("Scan", lookup(scan.getRelation()));
-    return mk<Scan>(type, &scan, rel, visit_(type_identity<ram::TupleOperation>(), scan));
+    Own<BatchFilter> batchFilter;
+    auto res = mk<Scan>(type, &scan, rel, generateScanOperation(scan, batchFilter));
+    res->setColumnPredicates(getColumnPredicates(scan));
+    if (batchFilter != nullptr) {
+        res->setBatchFilter(std::move(batchFilter));
+    } else {
+        res->setProbes(getProbes(*res, scan.getTupleId()));
+    }
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::ParallelScan& pScan) {
@@ -192,8 +212,15 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::Paral
     std::size_t relId = encodeRelation(pScan.getRelation());
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("ParallelScan", lookup(pScan.getRelation()));
-    auto res = mk<ParallelScan>(type, &pScan, rel, visit_(type_identity<ram::TupleOperation>(), pScan));
+    Own<BatchFilter> batchFilter;
+    auto res = mk<ParallelScan>(type, &pScan, rel, generateScanOperation(pScan, batchFilter));
     res->setViewContext(parentQueryViewContext);
+    res->setColumnPredicates(getColumnPredicates(pScan));
+    if (batchFilter != nullptr) {
+        res->setBatchFilter(std::move(batchFilter));
+    } else {
+        res->setProbes(getProbes(*res, pScan.getTupleId()));
+    }
     return res;
 }
 
@@ -201,8 +228,10 @@ NodePtr NodeGenerator::visit_(type_identity<ram::IndexScan>, const ram::IndexSca
     orderingContext.addTupleWithIndexOrder(iScan.getTupleId(), iScan);
     SuperInstruction indexOperation = getIndexSuperInstInfo(iScan);
     NodeType type = constructNodeType("IndexScan", lookup(iScan.getRelation()));
-    return mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
+    auto res = mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
             encodeView(&iScan), std::move(indexOperation));
+    res->setProbes(getProbes(*res, iScan.getTupleId()));
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::ParallelIndexScan& piscan) {
@@ -214,9 +243,24 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::
     auto res = mk<ParallelIndexScan>(type, &piscan, rel, visit_(type_identity<ram::TupleOperation>(), piscan),
             encodeIndexPos(piscan), std::move(indexOperation));
     res->setViewContext(parentQueryViewContext);
+    res->setProbes(getProbes(*res, piscan.getTupleId()));
     return res;
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::LeapfrogScan>, const ram::LeapfrogScan& lScan) {
+    VecOwn<ExistenceCheck> partners;
+    for (const auto* partner : lScan.getPartners()) {
+        auto ramRelation = lookup(partner->getRelation());
+        NodeType type = constructNodeType("ExistenceCheck", ramRelation);
+        partners.push_back(mk<ExistenceCheck>(type, partner, false, encodeView(partner),
+                getExistenceSuperInstInfo(*partner), ramRelation.isTemp(), ramRelation.getName()));
+    }
+    orderingContext.addTupleWithIndexOrder(lScan.getTupleId(), lScan);
+    SuperInstruction indexOperation = getIndexSuperInstInfo(lScan);
+    return mk<LeapfrogScan>(I_LeapfrogScan, &lScan, visit_(type_identity<ram::TupleOperation>(), lScan),
+            encodeView(&lScan), std::move(indexOperation), std::move(partners));
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::Choice>, const ram::Choice& choice) {
     orderingContext.addTupleWithDefaultOrder(choice.getTupleId(), choice);
     std::size_t relId = encodeRelation(choice.getRelation());
@@ -334,7 +378,8 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Break>, const ram::Break& break
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::Filter>, const ram::Filter& filter) {
-    return mk<Filter>(I_Filter, &filter, dispatch(filter.getCondition()), dispatch(filter.getOperation()));
+    return mk<Filter>(I_Filter, &filter, dispatch(filter.getCondition()), dispatch(filter.getOperation()),
+            getFrequencyCounter(filter.getProfileText()));
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::GuardedInsert>, const ram::GuardedInsert& guardedInsert) {
@@ -343,7 +388,9 @@ NodePtr NodeGenerator::visit_(type_identity<ram::GuardedInsert>, const ram::Guar
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("GuardedInsert", lookup(guardedInsert.getRelation()));
     auto condition = guardedInsert.getCondition();
-    return mk<GuardedInsert>(type, &guardedInsert, rel, std::move(superOp), dispatch(*condition));
+    auto res = mk<GuardedInsert>(type, &guardedInsert, rel, std::move(superOp), dispatch(*condition));
+    setInsertBuffer(*res, guardedInsert);
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::Insert>, const ram::Insert& insert) {
@@ -351,7 +398,9 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Insert>, const ram::Insert& ins
     std::size_t relId = encodeRelation(insert.getRelation());
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType("Insert", lookup(insert.getRelation()));
-    return mk<Insert>(type, &insert, rel, std::move(superOp));
+    auto res = mk<Insert>(type, &insert, rel, std::move(superOp));
+    setInsertBuffer(*res, insert);
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::SubroutineReturn>, const ram::SubroutineReturn& ret) {
@@ -419,6 +468,13 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Clear>, const ram::Clear& clear
     return mk<Clear>(type, &clear, rel);
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::BuildBloomFilter>, const ram::BuildBloomFilter& build) {
+    std::size_t relId = encodeRelation(build.getRelation());
+    auto rel = getRelationHandle(relId);
+    return mk<BuildBloomFilter>(I_BuildBloomFilter, &build, rel,
+            getBloomFilter(build.getRelation(), build.getColumns()));
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::LogSize>, const ram::LogSize& size) {
     std::size_t relId = encodeRelation(size.getRelation());
     auto rel = getRelationHandle(relId);
@@ -472,6 +528,21 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Query>, const ram::Query& query
 
     visit(*next, [&](const ram::AbstractParallel&) { viewContext->isParallel = true; });
 
+    // insertions into relations read by the query have to be visible immediately
+    queryReads.clear();
+    bufferTable.clear();
+    visit(query, [&](const ram::Node& node) {
+        if (const auto* op = as<ram::RelationOperation>(node)) {
+            queryReads.insert(op->getRelation());
+        } else if (const auto* exists = as<ram::AbstractExistenceCheck>(node)) {
+            queryReads.insert(exists->getRelation());
+        } else if (const auto* emptiness = as<ram::EmptinessCheck>(node)) {
+            queryReads.insert(emptiness->getRelation());
+        } else if (const auto* size = as<ram::RelationSize>(node)) {
+            queryReads.insert(size->getRelation());
+        }
+    });
+
     auto res = mk<Query>(I_Query, &query, dispatch(*next));
     res->setViewContext(parentQueryViewContext);
     return res;
@@ -533,12 +604,28 @@ std::size_t NodeGenerator::encodeView(const ram::Node* node) {
     return id;
 }
 
+std::size_t NodeGenerator::getFrequencyCounter(const std::string& profileText) {
+    if (!engine.profileEnabled || !engine.frequencyCounterEnabled || profileText.empty()) {
+        return ProfiledOperation::NO_COUNTER;
+    }
+    return engine.frequencies.getCounter(profileText);
+}
+
+BloomFilter& NodeGenerator::getBloomFilter(
+        const std::string& relName, const std::vector<std::size_t>& columns) {
+    return engine.bloomFilters[std::make_pair(relName, columns)];
+}
+
 const ram::Relation& NodeGenerator::lookup(const std::string& relName) {
     auto it = relationMap.find(relName);
     assert(it != relationMap.end() && "relation not found");
     return *it->second;
 }
 
+NodeType NodeGenerator::constructNodeType(std::string tokBase, const ram::Relation& rel) {
+    return interpreter::constructNodeType(std::move(tokBase), rel, engine.isa->getRepresentation(rel));
+}
+
 std::size_t NodeGenerator::getArity(const std::string& relName) {
     auto rel = lookup(relName);
     return rel.getArity();
@@ -578,6 +665,195 @@ const std::string& NodeGenerator::getViewRelation(const ram::Node* node) {
     fatal("The ram::Node does not require a view.");
 }
 
+std::vector<ColumnPredicate> NodeGenerator::getColumnPredicates(const ram::RelationOperation& scan) {
+    std::vector<ColumnPredicate> res;
+    const auto* filter = as<ram::Filter>(scan.getOperation());
+    if (filter == nullptr ||
+            engine.isa->getRepresentation(lookup(scan.getRelation())) != RelationRepresentation::COLUMNAR) {
+        return res;
+    }
+
+    auto getConstant = [&](const ram::Expression& expr, RamDomain& value) {
+        if (const auto* num = as<ram::NumericConstant>(expr)) {
+            value = num->getConstant();
+            return true;
+        }
+        if (const auto* str = as<ram::StringConstant>(expr)) {
+            value = engine.getSymbolTable().lookup(str->getConstant());
+            return true;
+        }
+        return false;
+    };
+
+    for (const auto& cond : ram::toConjunctionList(&filter->getCondition())) {
+        const auto* constraint = as<ram::Constraint>(cond);
+        if (constraint == nullptr) {
+            continue;
+        }
+        BinaryConstraintOp op = constraint->getOperator();
+        const ram::Expression* lhs = &constraint->getLHS();
+        const ram::Expression* rhs = &constraint->getRHS();
+        if (!isA<ram::TupleElement>(lhs)) {
+            std::swap(lhs, rhs);
+            if (!isColumnPredicateOp(op)) {
+                continue;
+            }
+            op = swappedConstraintOp(op);
+        }
+        const auto* element = as<ram::TupleElement>(lhs);
+        RamDomain value;
+        if (element == nullptr || element->getTupleId() != scan.getTupleId() || !isColumnPredicateOp(op) ||
+                !getConstant(*rhs, value)) {
+            continue;
+        }
+        // the column refers to the encoded tuple of the main index
+        res.push_back({orderingContext.mapOrder(scan.getTupleId(), element->getElement()), op, value});
+    }
+    return res;
+}
+
+std::vector<const ExistenceCheck*> NodeGenerator::getProbes(const Scan& scan, std::size_t tupleId) {
+    std::vector<const ExistenceCheck*> res;
+    const auto* filter = dynamic_cast<const Filter*>(scan.getNestedOperation());
+    if (filter == nullptr) {
+        return res;
+    }
+
+    std::function<void(const Node*)> collect = [&](const Node* cond) {
+        if (const auto* conj = dynamic_cast<const Conjunction*>(cond)) {
+            collect(conj->getLhs());
+            collect(conj->getRhs());
+        } else if (const auto* neg = dynamic_cast<const Negation*>(cond)) {
+            collect(neg->getChild());
+        } else if (const auto* exists = dynamic_cast<const ExistenceCheck*>(cond)) {
+            const auto& superInfo = exists->getSuperInst();
+            if (!superInfo.exprFirst.empty() || superInfo.first.size() > Scan::MAX_PROBE_ARITY) {
+                return;
+            }
+            for (const auto& tupleElement : superInfo.tupleFirst) {
+                if (tupleElement[1] != tupleId) {
+                    return;
+                }
+            }
+            switch (engine.isa->getRepresentation(lookup(exists->getRelationName()))) {
+                case RelationRepresentation::EQREL:
+                case RelationRepresentation::HASHSET:
+                case RelationRepresentation::COLUMNAR:
+                case RelationRepresentation::COMPRESSED: return;
+                default: res.push_back(exists);
+            }
+        }
+    };
+    collect(filter->getCondition());
+    return res;
+}
+
+NodePtr NodeGenerator::generateScanOperation(
+        const ram::RelationOperation& scan, Own<BatchFilter>& batchFilter) {
+    const auto* filter = as<ram::Filter>(scan.getOperation());
+    if (!engine.batchEnabled || scan.getTupleId() != 0 || filter == nullptr ||
+            getFrequencyCounter(scan.getProfileText()) != ProfiledOperation::NO_COUNTER ||
+            getFrequencyCounter(filter->getProfileText()) != ProfiledOperation::NO_COUNTER) {
+        return visit_(type_identity<ram::TupleOperation>(), scan);
+    }
+
+    std::vector<const ram::Condition*> conditions;
+    std::function<void(const ram::Condition&)> collect = [&](const ram::Condition& cond) {
+        if (const auto* conj = as<ram::Conjunction>(cond)) {
+            collect(conj->getLHS());
+            collect(conj->getRHS());
+        } else {
+            conditions.push_back(&cond);
+        }
+    };
+    collect(filter->getCondition());
+
+    auto batch = mk<BatchFilter>();
+    std::vector<const ram::Condition*> remaining;
+    for (const auto* cond : conditions) {
+        const auto* constraint = as<ram::Constraint>(cond);
+        if (constraint != nullptr && BatchFilter::supports(constraint->getOperator())) {
+            // a comparison is only added once both of its sides compile
+            BatchFilter attempt = *batch;
+            auto lhs = compileBatchExpression(constraint->getLHS(), scan.getTupleId(), attempt);
+            auto rhs = compileBatchExpression(constraint->getRHS(), scan.getTupleId(), attempt);
+            if (lhs && rhs) {
+                attempt.addComparison(constraint->getOperator(), *lhs, *rhs);
+                *batch = std::move(attempt);
+                continue;
+            }
+        }
+        remaining.push_back(cond);
+    }
+    if (batch->empty()) {
+        return visit_(type_identity<ram::TupleOperation>(), scan);
+    }
+    batchFilter = std::move(batch);
+
+    NodePtr condition;
+    for (const auto* cond : remaining) {
+        auto next = dispatch(*cond);
+        condition = condition == nullptr ? std::move(next)
+                                         : mk<Conjunction>(I_Conjunction, &filter->getCondition(),
+                                                   std::move(condition), std::move(next));
+    }
+    if (condition == nullptr) {
+        return dispatch(filter->getOperation());
+    }
+    return mk<Filter>(I_Filter, filter, std::move(condition), dispatch(filter->getOperation()),
+            ProfiledOperation::NO_COUNTER);
+}
+
+std::optional<std::size_t> NodeGenerator::compileBatchExpression(
+        const ram::Expression& expr, std::size_t tupleId, BatchFilter& batchFilter) {
+    if (const auto* element = as<ram::TupleElement>(expr)) {
+        if (static_cast<std::size_t>(element->getTupleId()) != tupleId) {
+            return std::nullopt;
+        }
+        // the column refers to the encoded tuple of the main index
+        return batchFilter.addColumn(orderingContext.mapOrder(tupleId, element->getElement()));
+    }
+    if (const auto* num = as<ram::NumericConstant>(expr)) {
+        return batchFilter.addConstant(num->getConstant());
+    }
+    if (const auto* str = as<ram::StringConstant>(expr)) {
+        return batchFilter.addConstant(engine.getSymbolTable().lookup(str->getConstant()));
+    }
+
+    const auto* op = as<ram::IntrinsicOperator>(expr);
+    if (op == nullptr || !BatchFilter::supports(op->getOperator())) {
+        return std::nullopt;
+    }
+    const auto args = op->getArguments();
+    if (args.empty() || args.size() > 2) {
+        return std::nullopt;
+    }
+    auto lhs = compileBatchExpression(*args.front(), tupleId, batchFilter);
+    auto rhs = compileBatchExpression(*args.back(), tupleId, batchFilter);
+    if (!lhs || !rhs) {
+        return std::nullopt;
+    }
+    return batchFilter.addFunctor(op->getOperator(), *lhs, *rhs);
+}
+
+void NodeGenerator::setInsertBuffer(Insert& insert, const ram::Insert& ramInsert) {
+    const auto& relName = ramInsert.getRelation();
+    const auto& rel = lookup(relName);
+    // with --batch, sequential queries add their tuples in sorted batches as well
+    if (!parentQueryViewContext || !(parentQueryViewContext->isParallel || engine.batchEnabled) ||
+            engine.isProvenance || rel.getArity() == 0 ||
+            engine.isa->getRepresentation(rel) == RelationRepresentation::EQREL ||
+            queryReads.count(relName) > 0) {
+        return;
+    }
+    // insertions into the same relation share the buffer
+    auto pos = bufferTable.find(relName);
+    if (pos == bufferTable.end()) {
+        pos = bufferTable.emplace(relName, bufferTable.size()).first;
+    }
+    insert.setBufferId(pos->second);
+}
+
 SuperInstruction NodeGenerator::getIndexSuperInstInfo(const ram::IndexOperation& ramIndex) {
     std::size_t arity = getArity(ramIndex.getRelation());
     auto interpreterRel = encodeRelation(ramIndex.getRelation());
@@ -26,7 +26,9 @@
 #include "ram/AbstractParallel.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Break.h"
+#include "ram/BuildBloomFilter.h"
 #include "ram/Call.h"
 #include "ram/Choice.h"
 #include "ram/Clear.h"
@@ -48,6 +50,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -70,6 +73,7 @@
 #include "ram/ProvenanceExistenceCheck.h"
 #include "ram/Query.h"
 #include "ram/Relation.h"
+#include "ram/RelationOperation.h"
 #include "ram/RelationSize.h"
 #include "ram/Scan.h"
 #include "ram/Sequence.h"
@@ -93,10 +97,13 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <set>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
@@ -124,6 +131,9 @@ public:
      */
     NodePtr generateTree(const ram::Node& root);
 
+    /** @brief Encode and create the relation, return the relation id */
+    std::size_t encodeRelation(const std::string& relName);
+
     NodePtr visit_(type_identity<ram::NumericConstant>, const ram::NumericConstant& num) override;
 
     NodePtr visit_(type_identity<ram::StringConstant>, const ram::StringConstant& num) override;
@@ -160,6 +170,8 @@ public:
     NodePtr visit_(type_identity<ram::ProvenanceExistenceCheck>,
             const ram::ProvenanceExistenceCheck& provExists) override;
 
+    NodePtr visit_(type_identity<ram::BloomFilterCheck>, const ram::BloomFilterCheck& check) override;
+
     NodePtr visit_(type_identity<ram::Constraint>, const ram::Constraint& relOp) override;
 
     NodePtr visit_(type_identity<ram::NestedOperation>, const ram::NestedOperation& nested) override;
@@ -174,6 +186,8 @@ public:
 
     NodePtr visit_(type_identity<ram::ParallelIndexScan>, const ram::ParallelIndexScan& piscan) override;
 
+    NodePtr visit_(type_identity<ram::LeapfrogScan>, const ram::LeapfrogScan& lScan) override;
+
     NodePtr visit_(type_identity<ram::Choice>, const ram::Choice& choice) override;
 
     NodePtr visit_(type_identity<ram::ParallelChoice>, const ram::ParallelChoice& pChoice) override;
@@ -222,6 +236,8 @@ public:
 
     NodePtr visit_(type_identity<ram::Clear>, const ram::Clear& clear) override;
 
+    NodePtr visit_(type_identity<ram::BuildBloomFilter>, const ram::BuildBloomFilter& build) override;
+
     NodePtr visit_(type_identity<ram::LogSize>, const ram::LogSize& size) override;
 
     NodePtr visit_(type_identity<ram::IO>, const ram::IO& io) override;
@@ -293,14 +309,20 @@ private:
     /** @brief Encode and return the View id of an operation. */
     std::size_t encodeView(const ram::Node* node);
 
+    /** @brief Return the frequency counter of a profiled operation, or NO_COUNTER if it is not counted */
+    std::size_t getFrequencyCounter(const std::string& profileText);
+
+    /** @brief Return the Bloom filter over the given columns of a relation */
+    BloomFilter& getBloomFilter(const std::string& relName, const std::vector<std::size_t>& columns);
+
     /** @brief get arity of relation */
     const ram::Relation& lookup(const std::string& relName);
 
     /** @brief get arity of relation */
     std::size_t getArity(const std::string& relName);
 
-    /** @brief Encode and create the relation, return the relation id */
-    std::size_t encodeRelation(const std::string& relName);
+    /** @brief Construct the node type of an operation on the given relation */
+    NodeType constructNodeType(std::string tokBase, const ram::Relation& rel);
 
     /* @brief Get a relation instance from engine */
     RelationHandle* getRelationHandle(const std::size_t idx);
@@ -316,6 +338,38 @@ private:
      */
     const std::string& getViewRelation(const ram::Node* node);
 
+    /**
+     * @brief Collect the comparisons of the scanned tuple with constants from a filter
+     * directly nested in the scan, which column stores evaluate chunk by chunk.
+     */
+    std::vector<ColumnPredicate> getColumnPredicates(const ram::RelationOperation& scan);
+
+    /**
+     * @brief Collect the existence checks on B-trees in a filter directly nested in the scan,
+     * whose keys only depend on the scanned tuple, so they can be prefetched for groups of tuples.
+     */
+    std::vector<const ExistenceCheck*> getProbes(const Scan& scan, std::size_t tupleId);
+
+    /**
+     * @brief Generate the operation nested in a scan. With --batch, the comparisons of a filter directly
+     * nested in the outermost scan of a query that only involve arithmetic on the scanned tuple and
+     * constants are compiled into a batch filter, and only the other conditions guard the operation.
+     */
+    NodePtr generateScanOperation(const ram::RelationOperation& scan, Own<BatchFilter>& batchFilter);
+
+    /**
+     * @brief Compile an expression over the scanned tuple and constants into a batch filter, and return
+     * the register holding its values. Return nothing if the expression cannot be evaluated over batches.
+     */
+    std::optional<std::size_t> compileBatchExpression(
+            const ram::Expression& expr, std::size_t tupleId, BatchFilter& batchFilter);
+
+    /**
+     * @brief Set the insert buffer of an insertion into a relation that the parallel query does not
+     * read, so that each thread adds its tuples in sorted batches.
+     */
+    void setInsertBuffer(Insert& insert, const ram::Insert& ramInsert);
+
     /**
      * @brief Encode and return the super-instruction information about a index operation.
      */
@@ -348,6 +402,10 @@ private:
     std::unordered_map<const ram::Node*, std::size_t> viewTable;
     /** Environment encoding, store a mapping from ram::Relation to its id */
     std::unordered_map<std::string, std::size_t> relTable;
+    /** Relations read by the current query */
+    std::set<std::string> queryReads;
+    /** Store a mapping from the relations inserted by the current query to their insert buffer id */
+    std::unordered_map<std::string, std::size_t> bufferTable;
     /** name / relation mapping */
     std::unordered_map<std::string, const ram::Relation*> relationMap;
     /** ordering context */
@@ -22,14 +22,17 @@
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StreamUtil.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iosfwd>
 #include <iterator>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -137,8 +140,42 @@ inline std::ostream& operator<<(std::ostream& out, const Order& order) {
  */
 struct ViewWrapper {
     virtual ~ViewWrapper() = default;
+
+    /**
+     * Requests the memory visited when searching the given encoded keys, stored one
+     * after the other, to be loaded into the cache. Ignored by most data structures.
+     */
+    virtual void prefetch(const RamDomain* /* keys */, std::size_t /* count */) {}
+
+    /**
+     * Returns the first encoded tuple within the given encoded bounds, or nullptr if there is
+     * none. Leapfrog scans skip through the B-trees they intersect by repeated seeks, so the
+     * returned tuple has to stay in place; only B-trees are sought.
+     */
+    virtual const RamDomain* seek(const RamDomain* /* low */, const RamDomain* /* high */) {
+        return nullptr;
+    }
 };
 
+/** Whether a data structure can prefetch the search paths of keys */
+template <typename Data, typename = void>
+struct supports_prefetch : std::false_type {};
+
+template <typename Data>
+struct supports_prefetch<Data,
+        std::void_t<decltype(std::declval<const Data&>().prefetch(
+                std::declval<const typename Data::element_type*>(), std::size_t()))>> : std::true_type {};
+
+/** Whether a data structure can insert keys using operation hints */
+template <typename Data, typename Key, typename = void>
+struct supports_hinted_insert : std::false_type {};
+
+template <typename Data, typename Key>
+struct supports_hinted_insert<Data, Key,
+        std::void_t<decltype(std::declval<Data&>().insert(
+                std::declval<const Key&>(), std::declval<typename Data::operation_hints&>()))>>
+        : std::true_type {};
+
 /**
  * An index is an abstraction of a data structure
  */
@@ -183,6 +220,22 @@ public:
             return !range(low, high).empty();
         }
 
+        void prefetch(const RamDomain* keys, std::size_t count) override {
+            if constexpr (supports_prefetch<Data>::value) {
+                // the keys are laid out as an array of tuples
+                data.prefetch(reinterpret_cast<const Tuple*>(keys), count);
+            }
+        }
+
+        const RamDomain* seek(const RamDomain* low, const RamDomain* high) override {
+            const auto& highTuple = *reinterpret_cast<const Tuple*>(high);
+            auto pos = data.lower_bound(*reinterpret_cast<const Tuple*>(low), hints);
+            if (pos == data.end() || cmp(*pos, highTuple) > 0) {
+                return nullptr;
+            }
+            return (*pos).data();
+        }
+
         /** Obtains a pair of iterators representing the given range within this index. */
         souffle::range<iterator> range(const Tuple& low, const Tuple& high) {
             if (cmp(low, high) > 0) {
@@ -236,6 +289,36 @@ public:
         return data.insert(order.encode(tuple));
     }
 
+    /**
+     * Inserts a batch of tuples. The batch is sorted in the order of this index first, such
+     * that the operation hints of each insertion point to the position of the next one. The
+     * tuples that were not present before are moved to the front of the batch.
+     *
+     * @return the number of tuples that were not present before
+     */
+    std::size_t insert(Tuple* begin, Tuple* end) {
+        for (Tuple* cur = begin; cur != end; ++cur) {
+            *cur = order.encode(*cur);
+        }
+        std::sort(begin, end, [&](const Tuple& a, const Tuple& b) { return cmp.less(a, b); });
+
+        Hints hints;
+        std::size_t fresh = 0;
+        for (Tuple* cur = begin; cur != end; ++cur) {
+            bool added;
+            if constexpr (supports_hinted_insert<Data, Tuple>::value) {
+                added = data.insert(*cur, hints);
+            } else {
+                added = data.insert(*cur);
+            }
+            *cur = order.decode(*cur);
+            if (added) {
+                std::swap(*cur, begin[fresh++]);
+            }
+        }
+        return fresh;
+    }
+
     /**
      * Inserts all elements of the given index.
      */
@@ -304,6 +387,22 @@ public:
         return res;
     }
 
+    /**
+     * Returns the elements satisfying the given comparisons with constants.
+     * Only supported by column stores, which skip chunks by their zone maps.
+     */
+    auto filter(const std::vector<ColumnPredicate>& predicates) const {
+        return data.filter(predicates);
+    }
+
+    /**
+     * Returns the elements satisfying the given comparisons with constants,
+     * partitioned into ranges of whole chunks. Only supported by column stores.
+     */
+    auto partitionFilter(const std::vector<ColumnPredicate>& predicates, std::size_t partitionCount) const {
+        return data.partition(predicates, partitionCount);
+    }
+
     /**
      * Clears the content of this index, turning it empty.
      */
@@ -405,6 +504,13 @@ public:
         return data = true;
     }
 
+    std::size_t insert(Tuple* begin, Tuple* end) {
+        if (begin != end) {
+            data = true;
+        }
+        return end - begin;
+    }
+
     void insert(const Index& src) {
         data = src.data;
     }
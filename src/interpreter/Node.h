@@ -23,14 +23,18 @@
 
 #pragma once
 
+#include "FunctorOps.h"
 #include "interpreter/Util.h"
 #include "ram/Relation.h"
+#include "souffle/BinaryConstraintOps.h"
 #include "souffle/RamTypes.h"
+#include "souffle/datastructure/BloomFilter.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -70,12 +74,14 @@ struct RelationWrapper;
     FOR_EACH(Expand, RelationSize)\
     FOR_EACH(Expand, ExistenceCheck)\
     FOR_EACH_PROVENANCE(Expand, ProvenanceExistenceCheck)\
+    Forward(BloomFilterCheck)\
     Forward(Constraint)\
     Forward(TupleOperation)\
     FOR_EACH(Expand, Scan)\
     FOR_EACH(Expand, ParallelScan)\
     FOR_EACH(Expand, IndexScan)\
     FOR_EACH(Expand, ParallelIndexScan)\
+    Forward(LeapfrogScan)\
     FOR_EACH(Expand, Choice)\
     FOR_EACH(Expand, ParallelChoice)\
     FOR_EACH(Expand, IndexChoice)\
@@ -98,6 +104,7 @@ struct RelationWrapper;
     Forward(LogTimer)\
     Forward(DebugInfo)\
     FOR_EACH(Expand, Clear)\
+    Forward(BuildBloomFilter)\
     Forward(LogSize)\
     Forward(IO)\
     Forward(Query)\
@@ -129,10 +136,12 @@ enum NodeType {
 
 /**
  * Construct interpreterNodeType by looking at the representation and the arity of the given rel.
+ * The representation is the one selected by the index analysis for the relation.
  *
  * Add reflective from string to NodeType.
  */
-inline NodeType constructNodeType(std::string tokBase, const ram::Relation& rel) {
+inline NodeType constructNodeType(
+        std::string tokBase, const ram::Relation& rel, RelationRepresentation representation) {
     static bool isProvenance = Global::config().has("provenance");
 
     static const std::unordered_map<std::string, NodeType> map = {
@@ -140,10 +149,16 @@ inline NodeType constructNodeType(std::string tokBase, const ram::Relation& rel)
     };
 
     std::string arity = std::to_string(rel.getArity());
-    if (rel.getRepresentation() == RelationRepresentation::EQREL) {
+    if (representation == RelationRepresentation::EQREL) {
         return map.at("I_" + tokBase + "_Eqrel_" + arity);
     } else if (isProvenance) {
         return map.at("I_" + tokBase + "_Provenance_" + arity);
+    } else if (representation == RelationRepresentation::HASHSET) {
+        return map.at("I_" + tokBase + "_Hashset_" + arity);
+    } else if (representation == RelationRepresentation::COLUMNAR) {
+        return map.at("I_" + tokBase + "_Columnar_" + arity);
+    } else if (representation == RelationRepresentation::COMPRESSED) {
+        return map.at("I_" + tokBase + "_Compressed_" + arity);
     } else {
         return map.at("I_" + tokBase + "_Btree_" + arity);
     }
@@ -578,6 +593,22 @@ public:
               ViewOperation(viewId) {}
 };
 
+/**
+ * @class BloomFilterCheck
+ */
+class BloomFilterCheck : public CompoundNode {
+public:
+    BloomFilterCheck(enum NodeType ty, const ram::Node* sdw, VecOwn<Node> children, const BloomFilter& filter)
+            : CompoundNode(ty, sdw, std::move(children)), filter(filter) {}
+
+    const BloomFilter& getFilter() const {
+        return filter;
+    }
+
+private:
+    const BloomFilter& filter;
+};
+
 /**
  * @class Constraint
  */
@@ -585,11 +616,157 @@ class Constraint : public BinaryNode {
     using BinaryNode::BinaryNode;
 };
 
+/**
+ * @class ProfiledOperation
+ * @brief Encode the frequency counter of an operation for --profile-frequency
+ */
+class ProfiledOperation {
+public:
+    /** Counter of operations that are not counted */
+    static constexpr std::size_t NO_COUNTER = std::numeric_limits<std::size_t>::max();
+
+    ProfiledOperation(std::size_t counter) : counter(counter) {}
+
+    /** @brief whether the executions of the operation are counted */
+    inline bool isCounted() const {
+        return counter != NO_COUNTER;
+    }
+
+    /** @brief get the frequency counter of the operation */
+    inline std::size_t getCounter() const {
+        return counter;
+    }
+
+protected:
+    const std::size_t counter;
+};
+
 /**
  * @class TupleOperation
  */
-class TupleOperation : public UnaryNode {
-    using UnaryNode::UnaryNode;
+class TupleOperation : public UnaryNode, public ProfiledOperation {
+public:
+    TupleOperation(enum NodeType ty, const ram::Node* sdw, Own<Node> child, std::size_t counter)
+            : UnaryNode(ty, sdw, std::move(child)), ProfiledOperation(counter) {}
+};
+
+/**
+ * @class BatchFilter
+ * @brief Comparisons of the filter nested in an outer scan, which are evaluated over batches of tuples
+ *
+ * The comparisons only involve constants, columns of the scanned tuple and arithmetic on them. They
+ * are compiled to a list of instructions. A value instruction fills a register with a value for each
+ * tuple of the batch, and a comparison deselects the tuples for which it does not hold.
+ */
+class BatchFilter {
+public:
+    /** Number of scanned tuples evaluated together */
+    static constexpr std::size_t BATCH_SIZE = 1024;
+
+    enum class Kind { Column, Constant, Functor, Comparison };
+
+    struct Instruction {
+        Kind kind;
+        /** The column or the constant loaded by the instruction */
+        RamDomain value;
+        FunctorOp functor;
+        BinaryConstraintOp comparison;
+        /** The registers of the operands and of the result */
+        std::size_t lhs;
+        std::size_t rhs;
+        std::size_t target;
+    };
+
+    /** @brief load a column of the scanned tuples into a new register */
+    std::size_t addColumn(std::size_t column) {
+        return addValue({Kind::Column, static_cast<RamDomain>(column), {}, {}, 0, 0, 0});
+    }
+
+    /** @brief load a constant into a new register */
+    std::size_t addConstant(RamDomain value) {
+        return addValue({Kind::Constant, value, {}, {}, 0, 0, 0});
+    }
+
+    /** @brief apply an arithmetic operator to one or two registers; unary operators ignore rhs */
+    std::size_t addFunctor(FunctorOp op, std::size_t lhs, std::size_t rhs) {
+        return addValue({Kind::Functor, 0, op, {}, lhs, rhs, 0});
+    }
+
+    /** @brief deselect the tuples whose registers fail a comparison */
+    void addComparison(BinaryConstraintOp op, std::size_t lhs, std::size_t rhs) {
+        instructions.push_back({Kind::Comparison, 0, {}, op, lhs, rhs, 0});
+    }
+
+    inline const std::vector<Instruction>& getInstructions() const {
+        return instructions;
+    }
+
+    inline std::size_t getRegisterCount() const {
+        return registerCount;
+    }
+
+    inline bool empty() const {
+        return instructions.empty();
+    }
+
+    /** @brief whether an arithmetic operator can be evaluated over batches */
+    static bool supports(FunctorOp op) {
+        switch (op) {
+            case FunctorOp::NEG:
+            case FunctorOp::FNEG:
+            case FunctorOp::BNOT:
+            case FunctorOp::UBNOT:
+            case FunctorOp::ADD:
+            case FunctorOp::SUB:
+            case FunctorOp::MUL:
+            case FunctorOp::BAND:
+            case FunctorOp::BOR:
+            case FunctorOp::BXOR:
+            case FunctorOp::UADD:
+            case FunctorOp::USUB:
+            case FunctorOp::UMUL:
+            case FunctorOp::UBAND:
+            case FunctorOp::UBOR:
+            case FunctorOp::UBXOR:
+            case FunctorOp::FADD:
+            case FunctorOp::FSUB:
+            case FunctorOp::FMUL: return true;
+            default: return false;
+        }
+    }
+
+    /** @brief whether a comparison can be evaluated over batches */
+    static bool supports(BinaryConstraintOp op) {
+        switch (op) {
+            case BinaryConstraintOp::EQ:
+            case BinaryConstraintOp::FEQ:
+            case BinaryConstraintOp::NE:
+            case BinaryConstraintOp::FNE:
+            case BinaryConstraintOp::LT:
+            case BinaryConstraintOp::ULT:
+            case BinaryConstraintOp::FLT:
+            case BinaryConstraintOp::LE:
+            case BinaryConstraintOp::ULE:
+            case BinaryConstraintOp::FLE:
+            case BinaryConstraintOp::GT:
+            case BinaryConstraintOp::UGT:
+            case BinaryConstraintOp::FGT:
+            case BinaryConstraintOp::GE:
+            case BinaryConstraintOp::UGE:
+            case BinaryConstraintOp::FGE: return true;
+            default: return false;
+        }
+    }
+
+protected:
+    std::size_t addValue(Instruction instruction) {
+        instruction.target = registerCount++;
+        instructions.push_back(instruction);
+        return instruction.target;
+    }
+
+    std::vector<Instruction> instructions;
+    std::size_t registerCount = 0;
 };
 
 /**
@@ -597,8 +774,49 @@ class TupleOperation : public UnaryNode {
  */
 class Scan : public Node, public NestedOperation, public RelationalOperation {
 public:
+    /** Number of scanned tuples whose probes are prefetched together */
+    static constexpr std::size_t PROBE_GROUP_SIZE = 16;
+
+    /** Largest arity of a relation that is probed in groups */
+    static constexpr std::size_t MAX_PROBE_ARITY = 16;
+
     Scan(enum NodeType ty, const ram::Node* sdw, RelationHandle* relHandle, Own<Node> nested)
             : Node(ty, sdw), NestedOperation(std::move(nested)), RelationalOperation(relHandle) {}
+
+    /** @brief get the comparisons with constants a column store may evaluate while scanning */
+    inline const std::vector<ColumnPredicate>& getColumnPredicates() const {
+        return columnPredicates;
+    }
+
+    /** @brief set the comparisons with constants a column store may evaluate while scanning */
+    inline void setColumnPredicates(std::vector<ColumnPredicate> predicates) {
+        columnPredicates = std::move(predicates);
+    }
+
+    /** @brief get the existence checks of the nested filter whose keys depend only on the scanned tuple */
+    inline const std::vector<const ExistenceCheck*>& getProbes() const {
+        return probes;
+    }
+
+    /** @brief set the existence checks that are prefetched for groups of scanned tuples */
+    inline void setProbes(std::vector<const ExistenceCheck*> checks) {
+        probes = std::move(checks);
+    }
+
+    /** @brief get the comparisons evaluated over batches of scanned tuples, or null */
+    inline const BatchFilter* getBatchFilter() const {
+        return batchFilter.get();
+    }
+
+    /** @brief set the comparisons evaluated over batches of scanned tuples */
+    inline void setBatchFilter(Own<BatchFilter> filter) {
+        batchFilter = std::move(filter);
+    }
+
+protected:
+    std::vector<ColumnPredicate> columnPredicates;
+    std::vector<const ExistenceCheck*> probes;
+    Own<BatchFilter> batchFilter;
 };
 
 /**
@@ -627,6 +845,25 @@ public:
     using IndexScan::IndexScan;
 };
 
+/**
+ * @class LeapfrogScan
+ */
+class LeapfrogScan : public Node, public NestedOperation, public SuperOperation, public ViewOperation {
+public:
+    LeapfrogScan(enum NodeType ty, const ram::Node* sdw, Own<Node> nested, std::size_t viewId,
+            SuperInstruction superInst, VecOwn<ExistenceCheck> partners)
+            : Node(ty, sdw), NestedOperation(std::move(nested)), SuperOperation(std::move(superInst)),
+              ViewOperation(viewId), partners(std::move(partners)) {}
+
+    /** @brief get the existence checks whose ranges are intersected with the scanned one */
+    inline const VecOwn<ExistenceCheck>& getPartners() const {
+        return partners;
+    }
+
+protected:
+    VecOwn<ExistenceCheck> partners;
+};
+
 /**
  * @class Choice
  */
@@ -737,10 +974,11 @@ public:
 /**
  * @class Filter
  */
-class Filter : public Node, public ConditionalOperation, public NestedOperation {
+class Filter : public Node, public ConditionalOperation, public NestedOperation, public ProfiledOperation {
 public:
-    Filter(enum NodeType ty, const ram::Node* sdw, Own<Node> cond, Own<Node> nested)
-            : Node(ty, sdw), ConditionalOperation(std::move(cond)), NestedOperation(std::move(nested)) {}
+    Filter(enum NodeType ty, const ram::Node* sdw, Own<Node> cond, Own<Node> nested, std::size_t counter)
+            : Node(ty, sdw), ConditionalOperation(std::move(cond)), NestedOperation(std::move(nested)),
+              ProfiledOperation(counter) {}
 };
 
 /**
@@ -750,6 +988,24 @@ class Insert : public Node, public SuperOperation, public RelationalOperation {
 public:
     Insert(enum NodeType ty, const ram::Node* sdw, RelationHandle* relHandle, SuperInstruction superInst)
             : Node(ty, sdw), SuperOperation(std::move(superInst)), RelationalOperation(relHandle) {}
+
+    /** @brief Whether the tuples are collected in an insert buffer of the context */
+    bool isBuffered() const {
+        return buffered;
+    }
+
+    std::size_t getBufferId() const {
+        return bufferId;
+    }
+
+    void setBufferId(std::size_t id) {
+        buffered = true;
+        bufferId = id;
+    }
+
+private:
+    bool buffered = false;
+    std::size_t bufferId = 0;
 };
 
 /**
@@ -829,6 +1085,22 @@ public:
             : Node(ty, sdw), RelationalOperation(handle) {}
 };
 
+/**
+ * @class BuildBloomFilter
+ */
+class BuildBloomFilter : public Node, public RelationalOperation {
+public:
+    BuildBloomFilter(enum NodeType ty, const ram::Node* sdw, RelationHandle* handle, BloomFilter& filter)
+            : Node(ty, sdw), RelationalOperation(handle), filter(filter) {}
+
+    BloomFilter& getFilter() const {
+        return filter;
+    }
+
+private:
+    BloomFilter& filter;
+};
+
 /**
  * @class Call
  */
@@ -33,6 +33,16 @@
 
 namespace souffle::interpreter {
 
+/**
+ * A dummy wrapper for the insert buffers of relations.
+ */
+struct BufferWrapper {
+    virtual ~BufferWrapper() = default;
+
+    /** Adds the buffered tuples to the relation */
+    virtual void flush() = 0;
+};
+
 /**
  * Wrapper for InterpreterRelation.
  *
@@ -296,6 +306,46 @@ public:
         return true;
     }
 
+    /**
+     * Add a batch of tuples to this relation. The batch is reordered.
+     */
+    void insert(Tuple* begin, Tuple* end) {
+        Tuple* fresh = begin + main->insert(begin, end);
+        for (std::size_t i = 1; i < indexes.size(); ++i) {
+            indexes[i]->insert(begin, fresh);
+        }
+    }
+
+    /**
+     * Collects the tuples inserted into a relation by one thread, and adds them as a batch
+     * once it is full or flushed. A sorted batch is inserted close to the previous insertion,
+     * instead of contending with other threads on the shared index for every tuple.
+     */
+    class Buffer : public BufferWrapper {
+    public:
+        static constexpr std::size_t capacity = 4096;
+
+        Buffer(Relation& rel) : rel(rel) {
+            tuples.reserve(capacity);
+        }
+
+        void insert(const Tuple& tuple) {
+            tuples.push_back(tuple);
+            if (tuples.size() == capacity) {
+                flush();
+            }
+        }
+
+        void flush() override {
+            rel.insert(tuples.data(), tuples.data() + tuples.size());
+            tuples.clear();
+        }
+
+    private:
+        Relation& rel;
+        std::vector<Tuple> tuples;
+    };
+
     /**
      * Add all entries of the given relation to this relation.
      */
@@ -335,6 +385,21 @@ public:
         return main->partitionScan(partitionCount);
     }
 
+    /**
+     * Obtains the tuples satisfying the given comparisons with constants (column stores only).
+     */
+    auto filter(const std::vector<ColumnPredicate>& predicates) const {
+        return main->filter(predicates);
+    }
+
+    /**
+     * Returns a partitioned list of the tuples satisfying the given comparisons with
+     * constants for parallel computation (column stores only).
+     */
+    auto partitionFilter(const std::vector<ColumnPredicate>& predicates, std::size_t partitionCount) const {
+        return main->partitionFilter(predicates, partitionCount);
+    }
+
     /**
      * Obtains a pair of iterators covering the interval between the two given entries.
      */
@@ -431,4 +496,13 @@ Own<RelationWrapper> createBrieRelation(
 // A factory for Eqrel index.
 Own<RelationWrapper> createEqrelRelation(
         const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
+// A factory for HashSet based relation.
+Own<RelationWrapper> createHashsetRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
+// A factory for ColumnStore based relation.
+Own<RelationWrapper> createColumnarRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
+// A factory for compressed B-tree based relation.
+Own<RelationWrapper> createCompressedRelation(
+        const ram::Relation& id, const ram::analysis::IndexCluster& indexSelection);
 }  // namespace souffle::interpreter
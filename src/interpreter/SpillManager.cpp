@@ -0,0 +1,233 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillManager.cpp
+ *
+ * Define the spill manager of the interpreter.
+ ***********************************************************************/
+
+#include "interpreter/SpillManager.h"
+#include "ram/AbstractExistenceCheck.h"
+#include "ram/BinRelationStatement.h"
+#include "ram/Call.h"
+#include "ram/Clear.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/Insert.h"
+#include "ram/RelationOperation.h"
+#include "ram/RelationSize.h"
+#include "ram/RelationStatement.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/RamTypes.h"
+#include "souffle/utility/FileUtil.h"
+#include "souffle/utility/MemoryUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <tuple>
+
+namespace souffle::interpreter {
+
+namespace {
+// the number of tuples read from a spill file at once
+constexpr std::size_t READ_BLOCK_SIZE = 1024;
+}  // namespace
+
+SpillManager::SpillManager(std::size_t memoryLimit, const ram::Program& program,
+        ram::analysis::IndexAnalysis& isa, VecOwn<RelationHandle>& relations)
+        : memoryLimit(memoryLimit), isa(isa), relations(relations) {
+    // subroutine ids are assigned in the order of the subroutine map, as by the node generator
+    auto subs = program.getSubroutines();
+    visit(program.getMain(), [&](const ram::Call& call) {
+        schedule.push_back(std::distance(subs.begin(), subs.find(call.getName())));
+    });
+
+    // collect the relations used by each subroutine
+    uses.resize(subs.size());
+    clears.resize(subs.size());
+    std::size_t id = 0;
+    for (const auto& sub : subs) {
+        auto& used = uses[id];
+        visit(*sub.second, [&](const ram::Node& node) {
+            if (const auto* clear = as<ram::Clear>(node)) {
+                clears[id].insert(clear->getRelation());
+            } else if (const auto* stmt = as<ram::RelationStatement>(node)) {
+                used.insert(stmt->getRelation());
+            } else if (const auto* stmt = as<ram::BinRelationStatement>(node)) {
+                used.insert(stmt->getFirstRelation());
+                used.insert(stmt->getSecondRelation());
+            } else if (const auto* op = as<ram::RelationOperation>(node)) {
+                used.insert(op->getRelation());
+            } else if (const auto* insert = as<ram::Insert>(node)) {
+                used.insert(insert->getRelation());
+            } else if (const auto* exists = as<ram::AbstractExistenceCheck>(node)) {
+                used.insert(exists->getRelation());
+            } else if (const auto* emptiness = as<ram::EmptinessCheck>(node)) {
+                used.insert(emptiness->getRelation());
+            } else if (const auto* size = as<ram::RelationSize>(node)) {
+                used.insert(size->getRelation());
+            }
+        });
+        id++;
+    }
+}
+
+SpillManager::~SpillManager() {
+    for (const auto& cur : spilled) {
+        std::remove(cur.second.path.c_str());
+    }
+}
+
+void SpillManager::enterStratum(std::size_t subroutineId) {
+    // advance to the position of the stratum in the schedule
+    while (step < schedule.size() && schedule[step] != subroutineId) {
+        step++;
+    }
+
+    // relations that are only cleared by the stratum are empty after spilling already
+    for (const auto& name : clears[subroutineId]) {
+        auto pos = spilled.find(name);
+        if (pos != spilled.end() && uses[subroutineId].count(name) == 0) {
+            std::remove(pos->second.path.c_str());
+            spilled.erase(pos);
+        }
+    }
+
+    // page in the relations used by the stratum
+    for (const auto& name : uses[subroutineId]) {
+        if (spilled.count(name) != 0) {
+            if (RelationWrapper* rel = getRelation(name)) {
+                restore(*rel);
+            }
+        }
+    }
+
+    const std::size_t resident = getResidentMemory();
+    if (resident > memoryLimit) {
+        // spill the coldest relations first, and among equally cold ones the largest
+        std::vector<std::tuple<std::size_t, std::size_t, RelationWrapper*>> candidates;
+        for (const auto& handle : relations) {
+            if (handle == nullptr) {
+                continue;
+            }
+            RelationWrapper& rel = **handle;
+            const std::string& name = rel.getName();
+            if (rel.getArity() == 0 || rel.size() == 0 || uses[subroutineId].count(name) != 0 ||
+                    spilled.count(name) != 0) {
+                continue;
+            }
+            candidates.emplace_back(getDistanceToNextUse(name), getEstimatedMemory(rel), &rel);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                [](const auto& a, const auto& b) { return a > b; });
+
+        std::size_t freed = 0;
+        for (const auto& cur : candidates) {
+            if (resident - std::min(freed, resident) <= memoryLimit) {
+                break;
+            }
+            freed += std::get<1>(cur);
+            spill(*std::get<2>(cur));
+        }
+        releaseFreeMemory();
+    }
+
+    if (step < schedule.size()) {
+        step++;
+    }
+}
+
+void SpillManager::restoreAll() {
+    while (!spilled.empty()) {
+        const std::string name = spilled.begin()->first;
+        if (RelationWrapper* rel = getRelation(name)) {
+            restore(*rel);
+        } else {
+            std::remove(spilled.begin()->second.path.c_str());
+            spilled.erase(spilled.begin());
+        }
+    }
+}
+
+RelationWrapper* SpillManager::getRelation(const std::string& name) const {
+    for (const auto& handle : relations) {
+        if (handle != nullptr && (*handle)->getName() == name) {
+            return handle->get();
+        }
+    }
+    return nullptr;
+}
+
+std::size_t SpillManager::getDistanceToNextUse(const std::string& name) const {
+    for (std::size_t i = step; i < schedule.size(); i++) {
+        if (uses[schedule[i]].count(name) != 0) {
+            return i - step;
+        }
+        if (clears[schedule[i]].count(name) != 0) {
+            break;
+        }
+    }
+    return std::numeric_limits<std::size_t>::max();
+}
+
+std::size_t SpillManager::getEstimatedMemory(const RelationWrapper& rel) const {
+    std::size_t numIndexes = isa.getIndexSelection(rel.getName()).getAllOrders().size();
+    return rel.size() * rel.getArity() * sizeof(RamDomain) * std::max<std::size_t>(1, numIndexes);
+}
+
+void SpillManager::spill(RelationWrapper& rel) {
+    const std::size_t arity = rel.getArity();
+    SpillFile file{tempFile(), rel.size()};
+    std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+
+    // tuples are written in the order of the main index, hence the file is sorted
+    for (auto it = rel.begin(); it != rel.end(); ++it) {
+        out.write(reinterpret_cast<const char*>(*it), arity * sizeof(RamDomain));
+    }
+    out.close();
+    if (!out) {
+        fatal("cannot spill relation %s to %s", rel.getName(), file.path);
+    }
+
+    rel.purge();
+    spilled.emplace(rel.getName(), std::move(file));
+}
+
+void SpillManager::restore(RelationWrapper& rel) {
+    auto pos = spilled.find(rel.getName());
+    assert(pos != spilled.end() && "relation has not been spilled");
+    const SpillFile& file = pos->second;
+    const std::size_t arity = rel.getArity();
+
+    std::ifstream in(file.path, std::ios::binary);
+    if (!in) {
+        fatal("cannot restore relation %s from %s", rel.getName(), file.path);
+    }
+    std::vector<RamDomain> block(READ_BLOCK_SIZE * arity);
+    std::size_t remaining = file.size;
+    while (remaining > 0) {
+        const std::size_t count = std::min(remaining, READ_BLOCK_SIZE);
+        if (!in.read(reinterpret_cast<char*>(block.data()), count * arity * sizeof(RamDomain))) {
+            fatal("cannot restore relation %s from %s", rel.getName(), file.path);
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            rel.insert(&block[i * arity]);
+        }
+        remaining -= count;
+    }
+    in.close();
+
+    std::remove(file.path.c_str());
+    spilled.erase(pos);
+}
+
+}  // namespace souffle::interpreter
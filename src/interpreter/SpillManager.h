@@ -0,0 +1,98 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillManager.h
+ *
+ * Declares the spill manager of the interpreter, which keeps the memory
+ * usage below a given limit (--memory-limit) by moving relations that are
+ * not needed for a while to disk.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "interpreter/Relation.h"
+#include "ram/Program.h"
+#include "ram/analysis/Index.h"
+#include "souffle/utility/ContainerUtil.h"
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle::interpreter {
+
+/**
+ * Spills cold relations to disk while the interpreter exceeds its memory limit.
+ *
+ * The main program invokes the strata in a fixed order. Before a stratum is
+ * executed, all relations it uses are paged back in. If the resident memory
+ * exceeds the limit thereafter, relations that are not used by the stratum
+ * are written to a local file in the order of their main index and purged,
+ * starting with those whose next use is the furthest away. A spilled
+ * relation whose next use is a clear operation is never paged back in.
+ */
+class SpillManager {
+    using RelationHandle = Own<RelationWrapper>;
+
+public:
+    SpillManager(std::size_t memoryLimit, const ram::Program& program, ram::analysis::IndexAnalysis& isa,
+            VecOwn<RelationHandle>& relations);
+
+    ~SpillManager();
+
+    /** @brief Prepare the relations for the execution of the given stratum */
+    void enterStratum(std::size_t subroutineId);
+
+    /** @brief Page in all spilled relations */
+    void restoreAll();
+
+private:
+    /** A relation that has been written to disk */
+    struct SpillFile {
+        std::string path;
+        std::size_t size;
+    };
+
+    /** @brief Return the relation of the given name or nullptr if it does not exist */
+    RelationWrapper* getRelation(const std::string& name) const;
+
+    /** @brief Return the number of strata until the given relation is used next */
+    std::size_t getDistanceToNextUse(const std::string& name) const;
+
+    /** @brief Estimate the memory occupied by the given relation */
+    std::size_t getEstimatedMemory(const RelationWrapper& rel) const;
+
+    /** @brief Write the given relation to disk and purge it */
+    void spill(RelationWrapper& rel);
+
+    /** @brief Read the given relation back from disk */
+    void restore(RelationWrapper& rel);
+
+    /** Memory limit in bytes */
+    const std::size_t memoryLimit;
+    /** IndexAnalysis */
+    ram::analysis::IndexAnalysis& isa;
+    /** Relations of the engine */
+    VecOwn<RelationHandle>& relations;
+    /** Subroutine ids of the strata in the order of their invocation */
+    std::vector<std::size_t> schedule;
+    /** Position of the current stratum in the schedule */
+    std::size_t step = 0;
+    /** Relations used by each subroutine, excluding clear operations */
+    std::vector<std::set<std::string>> uses;
+    /** Relations cleared by each subroutine */
+    std::vector<std::set<std::string>> clears;
+    /** Spilled relations */
+    std::map<std::string, SpillFile> spilled;
+};
+
+}  // namespace souffle::interpreter
@@ -19,7 +19,10 @@
 #include "souffle/RamTypes.h"
 #include "souffle/datastructure/BTree.h"
 #include "souffle/datastructure/Brie.h"
+#include "souffle/datastructure/ColumnStore.h"
+#include "souffle/datastructure/CompressedBTree.h"
 #include "souffle/datastructure/EquivalenceRelation.h"
+#include "souffle/datastructure/HashSet.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 
@@ -105,6 +108,72 @@ namespace souffle::interpreter {
     /* func(Brie, 19, __VA_ARGS__) \ */
     /* func(Brie, 20, __VA_ARGS__)   */
 
+#define FOR_EACH_HASHSET(func, ...)\
+    func(Hashset, 1, __VA_ARGS__) \
+    func(Hashset, 2, __VA_ARGS__) \
+    func(Hashset, 3, __VA_ARGS__) \
+    func(Hashset, 4, __VA_ARGS__) \
+    func(Hashset, 5, __VA_ARGS__) \
+    func(Hashset, 6, __VA_ARGS__) \
+    func(Hashset, 7, __VA_ARGS__) \
+    func(Hashset, 8, __VA_ARGS__) \
+    func(Hashset, 9, __VA_ARGS__) \
+    func(Hashset, 10, __VA_ARGS__) \
+    func(Hashset, 11, __VA_ARGS__) \
+    func(Hashset, 12, __VA_ARGS__) \
+    func(Hashset, 13, __VA_ARGS__) \
+    func(Hashset, 14, __VA_ARGS__) \
+    func(Hashset, 15, __VA_ARGS__) \
+    func(Hashset, 16, __VA_ARGS__) \
+    func(Hashset, 17, __VA_ARGS__) \
+    func(Hashset, 18, __VA_ARGS__) \
+    func(Hashset, 19, __VA_ARGS__) \
+    func(Hashset, 20, __VA_ARGS__)
+
+#define FOR_EACH_COLUMNAR(func, ...)\
+    func(Columnar, 1, __VA_ARGS__) \
+    func(Columnar, 2, __VA_ARGS__) \
+    func(Columnar, 3, __VA_ARGS__) \
+    func(Columnar, 4, __VA_ARGS__) \
+    func(Columnar, 5, __VA_ARGS__) \
+    func(Columnar, 6, __VA_ARGS__) \
+    func(Columnar, 7, __VA_ARGS__) \
+    func(Columnar, 8, __VA_ARGS__) \
+    func(Columnar, 9, __VA_ARGS__) \
+    func(Columnar, 10, __VA_ARGS__) \
+    func(Columnar, 11, __VA_ARGS__) \
+    func(Columnar, 12, __VA_ARGS__) \
+    func(Columnar, 13, __VA_ARGS__) \
+    func(Columnar, 14, __VA_ARGS__) \
+    func(Columnar, 15, __VA_ARGS__) \
+    func(Columnar, 16, __VA_ARGS__) \
+    func(Columnar, 17, __VA_ARGS__) \
+    func(Columnar, 18, __VA_ARGS__) \
+    func(Columnar, 19, __VA_ARGS__) \
+    func(Columnar, 20, __VA_ARGS__)
+
+#define FOR_EACH_COMPRESSED(func, ...)\
+    func(Compressed, 1, __VA_ARGS__) \
+    func(Compressed, 2, __VA_ARGS__) \
+    func(Compressed, 3, __VA_ARGS__) \
+    func(Compressed, 4, __VA_ARGS__) \
+    func(Compressed, 5, __VA_ARGS__) \
+    func(Compressed, 6, __VA_ARGS__) \
+    func(Compressed, 7, __VA_ARGS__) \
+    func(Compressed, 8, __VA_ARGS__) \
+    func(Compressed, 9, __VA_ARGS__) \
+    func(Compressed, 10, __VA_ARGS__) \
+    func(Compressed, 11, __VA_ARGS__) \
+    func(Compressed, 12, __VA_ARGS__) \
+    func(Compressed, 13, __VA_ARGS__) \
+    func(Compressed, 14, __VA_ARGS__) \
+    func(Compressed, 15, __VA_ARGS__) \
+    func(Compressed, 16, __VA_ARGS__) \
+    func(Compressed, 17, __VA_ARGS__) \
+    func(Compressed, 18, __VA_ARGS__) \
+    func(Compressed, 19, __VA_ARGS__) \
+    func(Compressed, 20, __VA_ARGS__)
+
 #define FOR_EACH_EQREL(func, ...)\
     func(Eqrel, 2, __VA_ARGS__)
 
@@ -112,6 +181,9 @@ namespace souffle::interpreter {
     FOR_EACH_BTREE(func, __VA_ARGS__)       \
     FOR_EACH_BRIE(func, __VA_ARGS__)        \
     FOR_EACH_PROVENANCE(func, __VA_ARGS__)  \
+    FOR_EACH_HASHSET(func, __VA_ARGS__)     \
+    FOR_EACH_COLUMNAR(func, __VA_ARGS__)    \
+    FOR_EACH_COMPRESSED(func, __VA_ARGS__)  \
     FOR_EACH_EQREL(func, __VA_ARGS__)
 
 // clang-format on
@@ -233,6 +305,18 @@ using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - 2>,
         ProvenanceUpdater<Arity>>;
 
+// Alias for HashSet
+template <std::size_t Arity>
+using Hashset = HashSet<t_tuple<Arity>>;
+
+// Alias for ColumnStore
+template <std::size_t Arity>
+using Columnar = ColumnStore<Arity>;
+
+// Alias for compressed_btree_set
+template <std::size_t Arity>
+using Compressed = compressed_btree_set<t_tuple<Arity>, comparator<Arity>>;
+
 // Alias for Eqrel
 // Note: require Arity = 2.
 template <std::size_t Arity>
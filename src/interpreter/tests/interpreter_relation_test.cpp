@@ -287,4 +287,96 @@ TEST(Reordering, Iteration) {
     }
 }
 
+TEST(Buffer, Insertion) {
+    // create a relation with two indexes
+    SignatureOrderMap mapping;
+    SearchSignature existenceCheck = SearchSignature::getFullSearchSignature(2);
+    SearchSignature secondColumn(2);
+    secondColumn[1] = AttributeConstraint::Equal;
+    SearchSet searches = {existenceCheck, secondColumn};
+    LexOrder firstOrder = {0, 1};
+    LexOrder secondOrder = {1, 0};
+    OrderCollection orders = {firstOrder, secondOrder};
+    mapping.insert({existenceCheck, firstOrder});
+    mapping.insert({secondColumn, secondOrder});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    using Rel = Relation<2, interpreter::Btree>;
+    Rel rel(0, "test", indexSelection);
+    rel.insert(Rel::Tuple{7, 0});
+
+    // the buffer only adds the tuples once it is flushed, or full
+    Rel::Buffer buffer(rel);
+    for (RamDomain i = 0; i < 100; i++) {
+        buffer.insert({i % 10, i % 3});
+    }
+    EXPECT_EQ(1, rel.size());
+    buffer.flush();
+    EXPECT_EQ(30, rel.size());
+    for (RamDomain i = 0; i < 10; i++) {
+        for (RamDomain j = 0; j < 3; j++) {
+            Rel::Tuple tuple{i, j};
+            EXPECT_TRUE(rel.exists(tuple));
+        }
+    }
+
+    // the second index holds the encoded tuples as well
+    Rel::Tuple low{0, MIN_RAM_SIGNED};
+    Rel::Tuple high{0, MAX_RAM_SIGNED};
+    std::size_t count = 0;
+    for (const auto& tuple : rel.range(1, low, high)) {
+        EXPECT_EQ(0, tuple[0]);
+        count++;
+    }
+    EXPECT_EQ(10, count);
+
+    for (std::size_t i = 0; i < Rel::Buffer::capacity + 10; i++) {
+        buffer.insert({RamDomain(i), 5});
+    }
+    EXPECT_EQ(30 + Rel::Buffer::capacity, rel.size());
+    buffer.flush();
+    EXPECT_EQ(40 + Rel::Buffer::capacity, rel.size());
+}
+
+TEST(View, Seek) {
+    // create a relation with an index of order {1, 0}
+    SignatureOrderMap mapping;
+    SearchSignature secondColumn(2);
+    secondColumn[1] = AttributeConstraint::Equal;
+    SearchSet searches = {secondColumn};
+    LexOrder order = {1, 0};
+    OrderCollection orders = {order};
+    mapping.insert({secondColumn, order});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    using Rel = Relation<2, interpreter::Btree>;
+    Rel rel(0, "test", indexSelection);
+    for (RamDomain i = 0; i < 100; i += 10) {
+        rel.insert(Rel::Tuple{i, 1});
+        rel.insert(Rel::Tuple{i + 5, 2});
+    }
+
+    // seeks return the first encoded tuple within the bounds
+    auto view = rel.createView(0);
+    Rel::Tuple low{1, 15};
+    Rel::Tuple high{1, MAX_RAM_SIGNED};
+    const RamDomain* found = view->seek(low.data(), high.data());
+    EXPECT_TRUE(found != nullptr);
+    EXPECT_EQ(1, found[0]);
+    EXPECT_EQ(20, found[1]);
+
+    low[1] = 90;
+    found = view->seek(low.data(), high.data());
+    EXPECT_TRUE(found != nullptr);
+    EXPECT_EQ(90, found[1]);
+
+    low[1] = 91;
+    EXPECT_TRUE(view->seek(low.data(), high.data()) == nullptr);
+
+    // the seek does not leave the bounds
+    Rel::Tuple other{0, 0};
+    Rel::Tuple otherHigh{0, MAX_RAM_SIGNED};
+    EXPECT_TRUE(view->seek(other.data(), otherHigh.data()) == nullptr);
+}
+
 }  // namespace souffle::interpreter::test
@@ -0,0 +1,158 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_batch_test.cpp
+ *
+ * Tests the evaluation of filters over batches of scanned tuples by the Interpreter.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "FunctorOps.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "interpreter/Engine.h"
+#include "ram/Condition.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/IO.h"
+#include "ram/Insert.h"
+#include "ram/IntrinsicOperator.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/TranslationUnit.h"
+#include "ram/TupleElement.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include "souffle/utility/json11.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::interpreter::test {
+
+using namespace ram;
+
+using json11::Json;
+
+/** The number of tuples of the scanned relation, which spans several batches */
+const RamDomain N = 3000;
+
+/** Create the binary application of a functor */
+Own<Expression> apply(FunctorOp op, Own<Expression> lhs, Own<Expression> rhs) {
+    VecOwn<Expression> args;
+    args.push_back(std::move(lhs));
+    args.push_back(std::move(rhs));
+    return mk<ram::IntrinsicOperator>(op, std::move(args));
+}
+
+/** Create the value of the second column of A for x, i.e. (x * 7919) band 1023 */
+Own<Expression> second(Own<Expression> x) {
+    return apply(FunctorOp::BAND, apply(FunctorOp::MUL, std::move(x), mk<ram::SignedConstant>(7919)),
+            mk<ram::SignedConstant>(1023));
+}
+
+/**
+ * Fill A with (x, (x * 7919) band 1023) for x in [0, N), filter it by
+ * t0.0 + t0.1 > 1500, t0.0 != 2000, t0.1 - 900 <= 0 and t0.0 / 3 != 700, of
+ * which the division is not evaluated over batches, and output the results.
+ */
+std::string evalFilter(bool batch) {
+    Global::config().set("jobs", "1");
+    if (batch) {
+        Global::config().set("batch");
+    } else {
+        Global::config().unset("batch");
+    }
+
+    VecOwn<ram::Relation> rels;
+    for (const std::string name : {"A", "T"}) {
+        rels.push_back(mk<ram::Relation>(name, 2, 0, std::vector<std::string>{"x", "y"},
+                std::vector<std::string>{"i", "i"}, RelationRepresentation::BTREE));
+    }
+
+    VecOwn<Expression> range;
+    range.push_back(mk<ram::SignedConstant>(0));
+    range.push_back(mk<ram::SignedConstant>(N));
+    VecOwn<Expression> values;
+    values.push_back(mk<ram::TupleElement>(0, 0));
+    values.push_back(second(mk<ram::TupleElement>(0, 0)));
+    auto fill = mk<ram::Query>(mk<ram::NestedIntrinsicOperator>(
+            NestedIntrinsicOp::RANGE, std::move(range), mk<ram::Insert>("A", std::move(values)), 0));
+
+    auto x = [] { return mk<ram::TupleElement>(0, 0); };
+    auto y = [] { return mk<ram::TupleElement>(0, 1); };
+    auto num = [](RamDomain value) { return mk<ram::SignedConstant>(value); };
+    auto sum = mk<ram::Constraint>(BinaryConstraintOp::GT, apply(FunctorOp::ADD, x(), y()), num(1500));
+    auto excluded = mk<ram::Constraint>(BinaryConstraintOp::NE, x(), num(2000));
+    auto bound = mk<ram::Constraint>(BinaryConstraintOp::LE, apply(FunctorOp::SUB, y(), num(900)), num(0));
+    auto quotient = mk<ram::Constraint>(BinaryConstraintOp::NE, apply(FunctorOp::DIV, x(), num(3)), num(700));
+    auto condition = mk<ram::Conjunction>(mk<ram::Conjunction>(std::move(sum), std::move(excluded)),
+            mk<ram::Conjunction>(std::move(bound), std::move(quotient)));
+    VecOwn<Expression> results;
+    results.push_back(x());
+    results.push_back(apply(FunctorOp::MUL, y(), num(2)));
+    auto filter = mk<ram::Query>(mk<ram::Scan>(
+            "A", 0, mk<ram::Filter>(std::move(condition), mk<ram::Insert>("T", std::move(results)))));
+
+    Json types = Json::object{{"relation",
+            Json::object{{"arity", static_cast<long long>(2)}, {"types", Json::array{"i", "i"}}}}};
+    std::map<std::string, std::string> dirs = {{"operation", "output"}, {"IO", "stdout"},
+            {"attributeNames", "x\ty"}, {"name", "T"}, {"auxArity", "0"}, {"types", types.dump()}};
+
+    Own<Statement> main = mk<ram::Sequence>(std::move(fill), std::move(filter), mk<ram::IO>("T", dirs));
+    std::map<std::string, Own<Statement>> subs;
+    ErrorReport errReport;
+    DebugReport debugReport;
+    TranslationUnit translationUnit(
+            mk<Program>(std::move(rels), std::move(main), std::move(subs)), errReport, debugReport);
+    Own<Engine> interpreter = mk<Engine>(translationUnit);
+
+    std::streambuf* oldCoutStreambuf = std::cout.rdbuf();
+    std::ostringstream sout;
+    std::cout.rdbuf(sout.rdbuf());
+    interpreter->executeMain();
+    std::cout.rdbuf(oldCoutStreambuf);
+
+    Global::config().unset("batch");
+    return sout.str();
+}
+
+TEST(Batch, Filter) {
+    std::stringstream expected;
+    expected << "---------------\nT\n===============\n";
+    for (RamDomain x = 0; x < N; ++x) {
+        RamDomain y = (x * 7919) & 1023;
+        if (x + y > 1500 && x != 2000 && y - 900 <= 0 && x / 3 != 700) {
+            expected << x << "\t" << 2 * y << "\n";
+        }
+    }
+    expected << "===============\n";
+
+    EXPECT_EQ(expected.str(), evalFilter(false));
+    EXPECT_EQ(expected.str(), evalFilter(true));
+}
+
+}  // namespace souffle::interpreter::test
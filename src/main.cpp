@@ -19,12 +19,14 @@
 #include "ast/Program.h"
 #include "ast/TranslationUnit.h"
 #include "ast/analysis/PrecedenceGraph.h"
+#include "ast/analysis/ProfileUse.h"
 #include "ast/analysis/SCCGraph.h"
 #include "ast/analysis/Type.h"
 #include "ast/transform/AddNullariesToAtomlessAggregates.h"
 #include "ast/transform/ComponentChecker.h"
 #include "ast/transform/ComponentInstantiation.h"
 #include "ast/transform/Conditional.h"
+#include "ast/transform/EmbedFacts.h"
 #include "ast/transform/ExecutionPlanChecker.h"
 #include "ast/transform/ExpandEqrels.h"
 #include "ast/transform/Fixpoint.h"
@@ -63,6 +65,7 @@
 #include "ast2ram/seminaive/TranslationStrategy.h"
 #include "ast2ram/seminaive/UnitTranslator.h"
 #include "ast2ram/utility/TranslatorContext.h"
+#include "ast2ram/utility/Utils.h"
 #include "config.h"
 #include "interpreter/Engine.h"
 #include "interpreter/ProgInterface.h"
@@ -70,14 +73,17 @@
 #include "ram/Node.h"
 #include "ram/Program.h"
 #include "ram/TranslationUnit.h"
+#include "ram/transform/BloomFilter.h"
 #include "ram/transform/ChoiceConversion.h"
 #include "ram/transform/CollapseFilters.h"
 #include "ram/transform/Conditional.h"
 #include "ram/transform/EliminateDuplicates.h"
 #include "ram/transform/ExpandFilter.h"
+#include "ram/transform/ExpireRelations.h"
 #include "ram/transform/HoistAggregate.h"
 #include "ram/transform/HoistConditions.h"
 #include "ram/transform/IfConversion.h"
+#include "ram/transform/Leapfrog.h"
 #include "ram/transform/Loop.h"
 #include "ram/transform/MakeIndex.h"
 #include "ram/transform/Parallel.h"
@@ -87,6 +93,7 @@
 #include "ram/transform/Sequence.h"
 #include "ram/transform/Transformer.h"
 #include "ram/transform/TupleId.h"
+#include "ram/utility/Serialiser.h"
 #include "reports/DebugReport.h"
 #include "reports/ErrorReport.h"
 #include "souffle/RamTypes.h"
@@ -98,11 +105,15 @@
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include "synthesiser/Synthesiser.h"
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -187,6 +198,356 @@ void compileToBinary(std::string compileCmd, const std::string& sourceFilename)
     }
 }
 
+/**
+ * Closes the pipe of the pre-processor.
+ */
+void closePreprocessor(FILE* in) {
+    int preprocessor_status = pclose(in);
+    if (preprocessor_status == -1) {
+        perror(nullptr);
+        throw std::runtime_error("failed to close pre-processor pipe");
+    }
+}
+
+/**
+ * Returns the key of the RAM cache for the given pre-processed program, which is a hash
+ * of the program, of all options except the cache directory, and of the profile used
+ * for the optimisations.
+ */
+std::string getRamCacheKey(const std::string& code) {
+    std::uint64_t hash = 14695981039346656037ull;  // FNV-1a
+    auto update = [&](const std::string& str) {
+        for (char c : str) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        hash *= 1099511628211ull;  // separates consecutive strings
+    };
+    update(std::to_string(RAM_DOMAIN_SIZE));
+    update(code);
+    for (const auto& [option, value] : Global::config().data()) {
+        if (option != "ram-cache") {
+            update(option);
+            update(value);
+        }
+    }
+    // the profile may change while its file name stays the same
+    if (Global::config().has("profile-use")) {
+        std::ifstream profile(Global::config().get("profile-use"), std::ios::binary);
+        std::stringstream contents;
+        contents << profile.rdbuf();
+        update(contents.str());
+    }
+    std::stringstream key;
+    key << std::hex << hash;
+    return key.str();
+}
+
+/**
+ * Returns the file of the RAM cache that is addressed by the given key.
+ */
+std::string getRamCacheFile(const std::string& key) {
+    return absPath(Global::config().get("ram-cache")) + "/" + key + ".ram";
+}
+
+/**
+ * Loads a RAM program from the RAM cache, and sets the options of the pragmas of its
+ * Datalog program. Returns nullptr if the cache holds no valid program for the key.
+ */
+Own<ram::Program> loadRamCache(const std::string& fileName, const std::string& key) {
+    std::ifstream in(fileName);
+    if (!in) {
+        return nullptr;
+    }
+    std::map<std::string, std::string> pragmaOptions;
+    Own<ram::Program> program;
+    try {
+        std::string storedKey;
+        if (!(in >> storedKey) || storedKey != key) {
+            return nullptr;
+        }
+        std::size_t numOptions = 0;
+        in >> numOptions;
+        for (std::size_t i = 0; i < numOptions; i++) {
+            std::string option;
+            std::string value;
+            in >> std::quoted(option) >> std::quoted(value);
+            pragmaOptions[option] = value;
+        }
+        program = ram::readProgram(in);
+    } catch (std::invalid_argument&) {
+        return nullptr;
+    }
+    for (const auto& [option, value] : pragmaOptions) {
+        if (!Global::config().has(option)) {
+            Global::config().set(option, value);
+        }
+    }
+    return program;
+}
+
+/**
+ * Stores a RAM program in the RAM cache under the given key, with the options set by
+ * the pragmas of its Datalog program.
+ */
+void storeRamCache(const std::string& fileName, const std::string& key,
+        const std::map<std::string, std::string>& pragmaOptions, const ram::Program& program) {
+    // write to a temporary file first, as other runs may use the same cache
+    const std::string tmpName = fileName + "." + std::to_string(getpid());
+    {
+        std::ofstream out(tmpName);
+        out << key << "\n";
+        out << pragmaOptions.size() << "\n";
+        for (const auto& [option, value] : pragmaOptions) {
+            out << std::quoted(option) << " " << std::quoted(value) << "\n";
+        }
+        ram::writeProgram(out, program);
+        if (!out) {
+            remove(tmpName.c_str());
+            return;
+        }
+    }
+    rename(tmpName.c_str(), fileName.c_str());
+}
+
+/**
+ * Parses the pre-processed program and translates it into an optimised RAM program,
+ * which is stored in the RAM cache if one is used. Returns nullptr if souffle only
+ * shows the program, and sets the exit status for this case.
+ */
+Own<ram::TranslationUnit> buildRamTranslationUnit(FILE* in, const std::string& code,
+        const std::string& ramCacheFile, const std::string& ramCacheKey, ErrorReport& errReport,
+        DebugReport& debugReport, std::chrono::high_resolution_clock::time_point parser_start,
+        int& exitStatus) {
+    const bool useRamCache = !ramCacheFile.empty();
+
+    // ------- parse program -------------
+
+    // parse file
+    Own<ast::TranslationUnit> astTranslationUnit;
+    if (useRamCache) {
+        astTranslationUnit = ParserDriver::parseTranslationUnit(code, errReport, debugReport);
+    } else {
+        astTranslationUnit = ParserDriver::parseTranslationUnit("<stdin>", in, errReport, debugReport);
+        closePreprocessor(in);
+    }
+
+    /* Report run-time of the parser if verbose flag is set */
+    if (Global::config().has("verbose")) {
+        auto parser_end = std::chrono::high_resolution_clock::now();
+        std::cout << "Parse Time: " << std::chrono::duration<double>(parser_end - parser_start).count()
+                  << "sec\n";
+    }
+
+    if (Global::config().get("show") == "parse-errors") {
+        std::cout << astTranslationUnit->getErrorReport();
+        exitStatus = astTranslationUnit->getErrorReport().getNumErrors();
+        return nullptr;
+    }
+
+    // ------- check for parse errors -------------
+    astTranslationUnit->getErrorReport().exitIfErrors();
+
+    // ------- rewriting / optimizations -------------
+
+    /* set up additional global options based on pragma declaratives */
+    const std::map<std::string, std::string> givenOptions = Global::config().data();
+    (mk<ast::transform::PragmaChecker>())->apply(*astTranslationUnit);
+    std::map<std::string, std::string> pragmaOptions;
+    for (const auto& [option, value] : Global::config().data()) {
+        if (givenOptions.count(option) == 0) {
+            pragmaOptions[option] = value;
+        }
+    }
+
+    /* construct the transformation pipeline */
+
+    // Equivalence pipeline
+    auto equivalencePipeline =
+            mk<ast::transform::PipelineTransformer>(mk<ast::transform::NameUnnamedVariablesTransformer>(),
+                    mk<ast::transform::FixpointTransformer>(mk<ast::transform::MinimiseProgramTransformer>()),
+                    mk<ast::transform::ReplaceSingletonVariablesTransformer>(),
+                    mk<ast::transform::RemoveRelationCopiesTransformer>(),
+                    mk<ast::transform::RemoveEmptyRelationsTransformer>(),
+                    mk<ast::transform::RemoveRedundantRelationsTransformer>());
+
+    // Magic-Set pipeline
+    auto magicPipeline = mk<ast::transform::PipelineTransformer>(mk<ast::transform::MagicSetTransformer>(),
+            mk<ast::transform::ResolveAliasesTransformer>(),
+            mk<ast::transform::RemoveRelationCopiesTransformer>(),
+            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
+            mk<ast::transform::RemoveRedundantRelationsTransformer>(), souffle::clone(equivalencePipeline));
+
+    // Partitioning pipeline
+    auto partitionPipeline =
+            mk<ast::transform::PipelineTransformer>(mk<ast::transform::NameUnnamedVariablesTransformer>(),
+                    mk<ast::transform::PartitionBodyLiteralsTransformer>(),
+                    mk<ast::transform::ReplaceSingletonVariablesTransformer>());
+
+    // Provenance pipeline
+    auto provenancePipeline = mk<ast::transform::ConditionalTransformer>(Global::config().has("provenance"),
+            mk<ast::transform::PipelineTransformer>(mk<ast::transform::ExpandEqrelsTransformer>(),
+                    mk<ast::transform::NameUnnamedVariablesTransformer>()));
+
+    // Main pipeline
+    auto pipeline = mk<ast::transform::PipelineTransformer>(mk<ast::transform::ComponentChecker>(),
+            mk<ast::transform::ComponentInstantiationTransformer>(),
+            mk<ast::transform::EmbedFactsTransformer>(), mk<ast::transform::IODefaultsTransformer>(),
+            mk<ast::transform::SimplifyAggregateTargetExpressionTransformer>(),
+            mk<ast::transform::UniqueAggregationVariablesTransformer>(),
+            mk<ast::transform::FixpointTransformer>(mk<ast::transform::PipelineTransformer>(
+                    mk<ast::transform::ResolveAnonymousRecordAliasesTransformer>(),
+                    mk<ast::transform::FoldAnonymousRecords>())),
+            mk<ast::transform::SemanticChecker>(), mk<ast::transform::GroundWitnessesTransformer>(),
+            mk<ast::transform::UniqueAggregationVariablesTransformer>(),
+            mk<ast::transform::MaterializeSingletonAggregationTransformer>(),
+            mk<ast::transform::FixpointTransformer>(
+                    mk<ast::transform::MaterializeAggregationQueriesTransformer>()),
+            mk<ast::transform::RemoveRedundantSumsTransformer>(),
+            mk<ast::transform::NormaliseGeneratorsTransformer>(),
+            mk<ast::transform::ResolveAliasesTransformer>(),
+            mk<ast::transform::RemoveBooleanConstraintsTransformer>(),
+            mk<ast::transform::ResolveAliasesTransformer>(), mk<ast::transform::MinimiseProgramTransformer>(),
+            mk<ast::transform::InlineRelationsTransformer>(), mk<ast::transform::GroundedTermsChecker>(),
+            mk<ast::transform::ResolveAliasesTransformer>(),
+            mk<ast::transform::RemoveRedundantRelationsTransformer>(),
+            mk<ast::transform::RemoveRelationCopiesTransformer>(),
+            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
+            mk<ast::transform::ReplaceSingletonVariablesTransformer>(),
+            mk<ast::transform::FixpointTransformer>(mk<ast::transform::PipelineTransformer>(
+                    mk<ast::transform::ReduceExistentialsTransformer>(),
+                    mk<ast::transform::RemoveRedundantRelationsTransformer>())),
+            mk<ast::transform::RemoveRelationCopiesTransformer>(), std::move(partitionPipeline),
+            std::move(equivalencePipeline), mk<ast::transform::RemoveRelationCopiesTransformer>(),
+            std::move(magicPipeline), mk<ast::transform::ReorderLiteralsTransformer>(),
+            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
+            mk<ast::transform::AddNullariesToAtomlessAggregatesTransformer>(),
+            mk<ast::transform::ReorderLiteralsTransformer>(), mk<ast::transform::ExecutionPlanChecker>(),
+            std::move(provenancePipeline), mk<ast::transform::IOAttributesTransformer>());
+
+    // Disable unwanted transformations
+    if (Global::config().has("disable-transformers")) {
+        std::vector<std::string> givenTransformers =
+                splitString(Global::config().get("disable-transformers"), ',');
+        pipeline->disableTransformers(
+                std::set<std::string>(givenTransformers.begin(), givenTransformers.end()));
+    }
+
+    // Set up the debug report if necessary
+    if (Global::config().has("debug-report")) {
+        auto parser_end = std::chrono::high_resolution_clock::now();
+        std::stringstream ss;
+
+        // Add current time
+        std::time_t time = std::time(nullptr);
+        ss << "Executed at ";
+        ss << std::put_time(std::localtime(&time), "%F %T") << "\n";
+
+        // Add config
+        ss << "(\n";
+        ss << join(Global::config().data(), ",\n", [](std::ostream& out, const auto& arg) {
+            out << "  \"" << arg.first << "\" -> \"" << arg.second << '"';
+        });
+        ss << "\n)";
+
+        debugReport.addSection("Configuration", "Configuration", ss.str());
+
+        // Add parsing runtime
+        std::string runtimeStr =
+                "(" + std::to_string(std::chrono::duration<double>(parser_end - parser_start).count()) + "s)";
+        debugReport.addSection("Parsing", "Parsing " + runtimeStr, "");
+
+        pipeline->setDebugReport();
+    }
+
+    // Toggle pipeline verbosity
+    pipeline->setVerbosity(Global::config().has("verbose"));
+
+    // Apply all the transformations
+    pipeline->apply(*astTranslationUnit);
+
+    if (Global::config().has("show")) {
+        // Output the transformed datalog and return
+        if (Global::config().get("show") == "transformed-datalog") {
+            std::cout << astTranslationUnit->getProgram() << std::endl;
+            return nullptr;
+        }
+
+        // Output the precedence graph in graphviz dot format and return
+        if (Global::config().get("show") == "precedence-graph") {
+            astTranslationUnit->getAnalysis<ast::analysis::PrecedenceGraphAnalysis>()->print(std::cout);
+            std::cout << std::endl;
+            return nullptr;
+        }
+
+        // Output the scc graph in graphviz dot format and return
+        if (Global::config().get("show") == "scc-graph") {
+            astTranslationUnit->getAnalysis<ast::analysis::SCCGraphAnalysis>()->print(std::cout);
+            std::cout << std::endl;
+            return nullptr;
+        }
+
+        // Output the type analysis
+        if (Global::config().get("show") == "type-analysis") {
+            astTranslationUnit->getAnalysis<ast::analysis::TypeAnalysis>()->print(std::cout);
+            std::cout << std::endl;
+            return nullptr;
+        }
+    }
+
+    // ------- execution -------------
+    /* translate AST to RAM */
+    debugReport.startSection();
+    auto translationStrategy =
+            Global::config().has("provenance")
+                    ? mk<ast2ram::TranslationStrategy, ast2ram::provenance::TranslationStrategy>()
+                    : mk<ast2ram::TranslationStrategy, ast2ram::seminaive::TranslationStrategy>();
+    auto unitTranslator = Own<ast2ram::UnitTranslator>(translationStrategy->createUnitTranslator());
+    auto ramTranslationUnit = unitTranslator->translateUnit(*astTranslationUnit);
+    debugReport.endSection("ast-to-ram", "Translate AST to RAM");
+
+    // Profiled relation sizes, which decide on the Bloom filters guarding index scans
+    std::map<std::string, std::size_t> relationSizes;
+    if (Global::config().has("profile-use")) {
+        const auto* profileUse = astTranslationUnit->getAnalysis<ast::analysis::ProfileUseAnalysis>();
+        for (const auto* rel : astTranslationUnit->getProgram().getRelations()) {
+            if (profileUse->hasRelationSize(rel->getQualifiedName())) {
+                relationSizes[ast2ram::getConcreteRelationName(rel->getQualifiedName())] =
+                        profileUse->getRelationSize(rel->getQualifiedName());
+            }
+        }
+    }
+
+    // Apply RAM transforms
+    {
+        using namespace ram::transform;
+        Own<Transformer> ramTransform = mk<TransformerSequence>(
+                mk<LoopTransformer>(mk<TransformerSequence>(mk<ExpandFilterTransformer>(),
+                        mk<HoistConditionsTransformer>(), mk<MakeIndexTransformer>())),
+                mk<IfConversionTransformer>(), mk<ChoiceConversionTransformer>(),
+                mk<CollapseFiltersTransformer>(), mk<TupleIdTransformer>(),
+                mk<LoopTransformer>(
+                        mk<TransformerSequence>(mk<HoistAggregateTransformer>(), mk<TupleIdTransformer>())),
+                mk<ExpandFilterTransformer>(), mk<HoistConditionsTransformer>(),
+                mk<CollapseFiltersTransformer>(), mk<EliminateDuplicatesTransformer>(),
+                mk<ReorderConditionsTransformer>(), mk<LoopTransformer>(mk<ReorderFilterBreak>()),
+                mk<ExpireRelationsTransformer>(), mk<LeapfrogTransformer>(),
+                mk<BloomFilterTransformer>(std::move(relationSizes)),
+                mk<ConditionalTransformer>(
+                        // job count of 0 means all cores are used.
+                        []() -> bool { return std::stoi(Global::config().get("jobs")) != 1; },
+                        mk<ParallelTransformer>()),
+                mk<ReportIndexTransformer>());
+
+        ramTransform->apply(*ramTranslationUnit);
+    }
+
+    // Store the optimised RAM program for the next runs
+    if (useRamCache) {
+        storeRamCache(ramCacheFile, ramCacheKey, pragmaOptions, ramTranslationUnit->getProgram());
+    }
+    return ramTranslationUnit;
+}
+
 int main(int argc, char** argv) {
     /* Time taking for overall runtime */
     auto souffle_start = std::chrono::high_resolution_clock::now();
@@ -242,11 +603,29 @@ int main(int argc, char** argv) {
                 {"dl-program", 'o', "FILE", "", false,
                         "Generate C++ source code, written to <FILE>, and compile this to a "
                         "binary executable (without executing it)."},
+                {"compile-units", '\12', "N", "", false,
+                        "Split the generated C++ source into a header, a driver and N translation "
+                        "units of the strata, which are compiled in parallel."},
+                {"type-cache", '\13', "DIR", "", false,
+                        "Cache the relation types and a precompiled runtime header in <DIR>, to be "
+                        "reused by later compilations."},
+                {"ram-cache", '\14', "DIR", "", false,
+                        "Cache the optimised RAM program in <DIR>, keyed by the pre-processed program and "
+                        "the options, so that later runs of the same program skip its translation."},
                 {"live-profile", '\1', "", "", false, "Enable live profiling."},
                 {"profile", 'p', "FILE", "", false, "Enable profiling, and write profile data to <FILE>."},
                 {"profile-use", 'u', "FILE", "", false,
                         "Use profile log-file <FILE> for profile-guided optimization."},
                 {"profile-frequency", '\2', "", "", false, "Enable the frequency counter in the profiler."},
+                {"profile-counters", '\11', "", "", false,
+                        "Record hardware performance counters of rules and relations in the profiler."},
+                {"hash-index", '\7', "", "", false,
+                        "Use hash indexes for relations only searched by full equality."},
+                {"batch", '\15', "", "", false,
+                        "Evaluate the comparisons of outer scans over batches of tuples in the interpreter."},
+                {"memory-limit", '\10', "SIZE", "", false,
+                        "Spill relations not needed soon to disk when the interpreter uses more than "
+                        "<SIZE> bytes of memory; the suffixes K, M and G are supported."},
                 {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
                 {"pragma", 'P', "OPTIONS", "", false, "Set pragma options."},
                 {"provenance", 't', "[ none | explain | explore ]", "", false,
@@ -322,6 +701,47 @@ int main(int argc, char** argv) {
         }
 #endif
 
+        /* for the memory limit option, normalise the size to bytes */
+        if (Global::config().has("memory-limit")) {
+            std::string limit = Global::config().get("memory-limit");
+            std::size_t factor = 1;
+            switch (limit.empty() ? '\0' : std::toupper(limit.back())) {
+                case 'G': factor *= 1024; [[fallthrough]];
+                case 'M': factor *= 1024; [[fallthrough]];
+                case 'K':
+                    factor *= 1024;
+                    limit.pop_back();
+                    break;
+                default: break;
+            }
+            if (limit.empty() || !std::all_of(limit.begin(), limit.end(), ::isdigit) ||
+                    std::stoull(limit) == 0) {
+                throw std::runtime_error("--memory-limit may only be set to a positive size, "
+                                         "optionally followed by K, M or G.");
+            }
+            Global::config().set("memory-limit", std::to_string(std::stoull(limit) * factor));
+        }
+
+        /* the strata are distributed over at least one translation unit */
+        if (Global::config().has("compile-units")) {
+            if (!isNumber(Global::config().get("compile-units").c_str()) ||
+                    std::stoi(Global::config().get("compile-units")) < 1) {
+                throw std::runtime_error("--compile-units may only be set to a positive number.");
+            }
+        }
+
+        /* if a type cache is given, check it exists */
+        if (Global::config().has("type-cache") && !existDir(Global::config().get("type-cache"))) {
+            throw std::runtime_error(
+                    "type cache directory " + Global::config().get("type-cache") + " does not exists");
+        }
+
+        /* if a RAM cache is given, check it exists */
+        if (Global::config().has("ram-cache") && !existDir(Global::config().get("ram-cache"))) {
+            throw std::runtime_error(
+                    "RAM cache directory " + Global::config().get("ram-cache") + " does not exists");
+        }
+
         /* if an output directory is given, check it exists */
         if (Global::config().has("output-dir") && !Global::config().has("output-dir", "-") &&
                 !existDir(Global::config().get("output-dir")) &&
@@ -416,207 +836,49 @@ int main(int argc, char** argv) {
     /* Time taking for parsing */
     auto parser_start = std::chrono::high_resolution_clock::now();
 
-    // ------- parse program -------------
+    // ------- look up the RAM cache -------------
 
-    // parse file
     ErrorReport errReport(Global::config().has("no-warn"));
     DebugReport debugReport;
-    Own<ast::TranslationUnit> astTranslationUnit =
-            ParserDriver::parseTranslationUnit("<stdin>", in, errReport, debugReport);
-
-    // close input pipe
-    int preprocessor_status = pclose(in);
-    if (preprocessor_status == -1) {
-        perror(nullptr);
-        throw std::runtime_error("failed to close pre-processor pipe");
-    }
-
-    /* Report run-time of the parser if verbose flag is set */
-    if (Global::config().has("verbose")) {
-        auto parser_end = std::chrono::high_resolution_clock::now();
-        std::cout << "Parse Time: " << std::chrono::duration<double>(parser_end - parser_start).count()
-                  << "sec\n";
-    }
-
-    if (Global::config().get("show") == "parse-errors") {
-        std::cout << astTranslationUnit->getErrorReport();
-        return astTranslationUnit->getErrorReport().getNumErrors();
-    }
-
-    // ------- check for parse errors -------------
-    astTranslationUnit->getErrorReport().exitIfErrors();
-
-    // ------- rewriting / optimizations -------------
-
-    /* set up additional global options based on pragma declaratives */
-    (mk<ast::transform::PragmaChecker>())->apply(*astTranslationUnit);
-
-    /* construct the transformation pipeline */
-
-    // Equivalence pipeline
-    auto equivalencePipeline =
-            mk<ast::transform::PipelineTransformer>(mk<ast::transform::NameUnnamedVariablesTransformer>(),
-                    mk<ast::transform::FixpointTransformer>(mk<ast::transform::MinimiseProgramTransformer>()),
-                    mk<ast::transform::ReplaceSingletonVariablesTransformer>(),
-                    mk<ast::transform::RemoveRelationCopiesTransformer>(),
-                    mk<ast::transform::RemoveEmptyRelationsTransformer>(),
-                    mk<ast::transform::RemoveRedundantRelationsTransformer>());
-
-    // Magic-Set pipeline
-    auto magicPipeline = mk<ast::transform::PipelineTransformer>(mk<ast::transform::MagicSetTransformer>(),
-            mk<ast::transform::ResolveAliasesTransformer>(),
-            mk<ast::transform::RemoveRelationCopiesTransformer>(),
-            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
-            mk<ast::transform::RemoveRedundantRelationsTransformer>(), souffle::clone(equivalencePipeline));
-
-    // Partitioning pipeline
-    auto partitionPipeline =
-            mk<ast::transform::PipelineTransformer>(mk<ast::transform::NameUnnamedVariablesTransformer>(),
-                    mk<ast::transform::PartitionBodyLiteralsTransformer>(),
-                    mk<ast::transform::ReplaceSingletonVariablesTransformer>());
-
-    // Provenance pipeline
-    auto provenancePipeline = mk<ast::transform::ConditionalTransformer>(Global::config().has("provenance"),
-            mk<ast::transform::PipelineTransformer>(mk<ast::transform::ExpandEqrelsTransformer>(),
-                    mk<ast::transform::NameUnnamedVariablesTransformer>()));
-
-    // Main pipeline
-    auto pipeline = mk<ast::transform::PipelineTransformer>(mk<ast::transform::ComponentChecker>(),
-            mk<ast::transform::ComponentInstantiationTransformer>(),
-            mk<ast::transform::IODefaultsTransformer>(),
-            mk<ast::transform::SimplifyAggregateTargetExpressionTransformer>(),
-            mk<ast::transform::UniqueAggregationVariablesTransformer>(),
-            mk<ast::transform::FixpointTransformer>(mk<ast::transform::PipelineTransformer>(
-                    mk<ast::transform::ResolveAnonymousRecordAliasesTransformer>(),
-                    mk<ast::transform::FoldAnonymousRecords>())),
-            mk<ast::transform::SemanticChecker>(), mk<ast::transform::GroundWitnessesTransformer>(),
-            mk<ast::transform::UniqueAggregationVariablesTransformer>(),
-            mk<ast::transform::MaterializeSingletonAggregationTransformer>(),
-            mk<ast::transform::FixpointTransformer>(
-                    mk<ast::transform::MaterializeAggregationQueriesTransformer>()),
-            mk<ast::transform::RemoveRedundantSumsTransformer>(),
-            mk<ast::transform::NormaliseGeneratorsTransformer>(),
-            mk<ast::transform::ResolveAliasesTransformer>(),
-            mk<ast::transform::RemoveBooleanConstraintsTransformer>(),
-            mk<ast::transform::ResolveAliasesTransformer>(), mk<ast::transform::MinimiseProgramTransformer>(),
-            mk<ast::transform::InlineRelationsTransformer>(), mk<ast::transform::GroundedTermsChecker>(),
-            mk<ast::transform::ResolveAliasesTransformer>(),
-            mk<ast::transform::RemoveRedundantRelationsTransformer>(),
-            mk<ast::transform::RemoveRelationCopiesTransformer>(),
-            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
-            mk<ast::transform::ReplaceSingletonVariablesTransformer>(),
-            mk<ast::transform::FixpointTransformer>(mk<ast::transform::PipelineTransformer>(
-                    mk<ast::transform::ReduceExistentialsTransformer>(),
-                    mk<ast::transform::RemoveRedundantRelationsTransformer>())),
-            mk<ast::transform::RemoveRelationCopiesTransformer>(), std::move(partitionPipeline),
-            std::move(equivalencePipeline), mk<ast::transform::RemoveRelationCopiesTransformer>(),
-            std::move(magicPipeline), mk<ast::transform::ReorderLiteralsTransformer>(),
-            mk<ast::transform::RemoveEmptyRelationsTransformer>(),
-            mk<ast::transform::AddNullariesToAtomlessAggregatesTransformer>(),
-            mk<ast::transform::ReorderLiteralsTransformer>(), mk<ast::transform::ExecutionPlanChecker>(),
-            std::move(provenancePipeline), mk<ast::transform::IOAttributesTransformer>());
-
-    // Disable unwanted transformations
-    if (Global::config().has("disable-transformers")) {
-        std::vector<std::string> givenTransformers =
-                splitString(Global::config().get("disable-transformers"), ',');
-        pipeline->disableTransformers(
-                std::set<std::string>(givenTransformers.begin(), givenTransformers.end()));
-    }
-
-    // Set up the debug report if necessary
-    if (Global::config().has("debug-report")) {
-        auto parser_end = std::chrono::high_resolution_clock::now();
-        std::stringstream ss;
-
-        // Add current time
-        std::time_t time = std::time(nullptr);
-        ss << "Executed at ";
-        ss << std::put_time(std::localtime(&time), "%F %T") << "\n";
-
-        // Add config
-        ss << "(\n";
-        ss << join(Global::config().data(), ",\n", [](std::ostream& out, const auto& arg) {
-            out << "  \"" << arg.first << "\" -> \"" << arg.second << '"';
-        });
-        ss << "\n)";
-
-        debugReport.addSection("Configuration", "Configuration", ss.str());
-
-        // Add parsing runtime
-        std::string runtimeStr =
-                "(" + std::to_string(std::chrono::duration<double>(parser_end - parser_start).count()) + "s)";
-        debugReport.addSection("Parsing", "Parsing " + runtimeStr, "");
-
-        pipeline->setDebugReport();
-    }
-
-    // Toggle pipeline verbosity
-    pipeline->setVerbosity(Global::config().has("verbose"));
-
-    // Apply all the transformations
-    pipeline->apply(*astTranslationUnit);
-
-    if (Global::config().has("show")) {
-        // Output the transformed datalog and return
-        if (Global::config().get("show") == "transformed-datalog") {
-            std::cout << astTranslationUnit->getProgram() << std::endl;
-            return 0;
+    Own<ram::TranslationUnit> ramTranslationUnit;
+
+    // the cache is keyed by the pre-processed program, and is not used if the AST is inspected
+    const bool useRamCache = Global::config().has("ram-cache") && !Global::config().has("show") &&
+                             !Global::config().has("debug-report");
+    std::string code;
+    std::string ramCacheKey;
+    std::string ramCacheFile;
+    if (useRamCache) {
+        char buffer[4096];
+        std::size_t length;
+        while ((length = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+            code.append(buffer, length);
         }
-
-        // Output the precedence graph in graphviz dot format and return
-        if (Global::config().get("show") == "precedence-graph") {
-            astTranslationUnit->getAnalysis<ast::analysis::PrecedenceGraphAnalysis>()->print(std::cout);
-            std::cout << std::endl;
-            return 0;
-        }
-
-        // Output the scc graph in graphviz dot format and return
-        if (Global::config().get("show") == "scc-graph") {
-            astTranslationUnit->getAnalysis<ast::analysis::SCCGraphAnalysis>()->print(std::cout);
-            std::cout << std::endl;
-            return 0;
+        closePreprocessor(in);
+
+        ramCacheKey = getRamCacheKey(code);
+        ramCacheFile = getRamCacheFile(ramCacheKey);
+        if (Own<ram::Program> program = loadRamCache(ramCacheFile, ramCacheKey)) {
+            ramTranslationUnit = mk<ram::TranslationUnit>(std::move(program), errReport, debugReport);
+            if (Global::config().has("verbose")) {
+                std::cout << "Loaded RAM program from cache " << ramCacheFile << "\n";
+            }
         }
+    }
 
-        // Output the type analysis
-        if (Global::config().get("show") == "type-analysis") {
-            astTranslationUnit->getAnalysis<ast::analysis::TypeAnalysis>()->print(std::cout);
-            std::cout << std::endl;
-            return 0;
+    if (ramTranslationUnit == nullptr) {
+        int exitStatus = 0;
+        ramTranslationUnit = buildRamTranslationUnit(
+                in, code, ramCacheFile, ramCacheKey, errReport, debugReport, parser_start, exitStatus);
+        if (ramTranslationUnit == nullptr) {
+            return exitStatus;
         }
     }
 
-    // ------- execution -------------
-    /* translate AST to RAM */
-    debugReport.startSection();
-    auto translationStrategy =
-            Global::config().has("provenance")
-                    ? mk<ast2ram::TranslationStrategy, ast2ram::provenance::TranslationStrategy>()
-                    : mk<ast2ram::TranslationStrategy, ast2ram::seminaive::TranslationStrategy>();
-    auto unitTranslator = Own<ast2ram::UnitTranslator>(translationStrategy->createUnitTranslator());
-    auto ramTranslationUnit = unitTranslator->translateUnit(*astTranslationUnit);
-    debugReport.endSection("ast-to-ram", "Translate AST to RAM");
-
-    // Apply RAM transforms
-    {
-        using namespace ram::transform;
-        Own<Transformer> ramTransform = mk<TransformerSequence>(
-                mk<LoopTransformer>(mk<TransformerSequence>(mk<ExpandFilterTransformer>(),
-                        mk<HoistConditionsTransformer>(), mk<MakeIndexTransformer>())),
-                mk<IfConversionTransformer>(), mk<ChoiceConversionTransformer>(),
-                mk<CollapseFiltersTransformer>(), mk<TupleIdTransformer>(),
-                mk<LoopTransformer>(
-                        mk<TransformerSequence>(mk<HoistAggregateTransformer>(), mk<TupleIdTransformer>())),
-                mk<ExpandFilterTransformer>(), mk<HoistConditionsTransformer>(),
-                mk<CollapseFiltersTransformer>(), mk<EliminateDuplicatesTransformer>(),
-                mk<ReorderConditionsTransformer>(), mk<LoopTransformer>(mk<ReorderFilterBreak>()),
-                mk<ConditionalTransformer>(
-                        // job count of 0 means all cores are used.
-                        []() -> bool { return std::stoi(Global::config().get("jobs")) != 1; },
-                        mk<ParallelTransformer>()),
-                mk<ReportIndexTransformer>());
-
-        ramTransform->apply(*ramTranslationUnit);
+    /* hardware counters are recorded in the profile, which may also be set by a pragma */
+    if (Global::config().has("profile-counters") && !Global::config().has("profile")) {
+        std::cerr << "--profile-counters requires a profile log file given by -p/--profile." << std::endl;
+        return EXIT_FAILURE;
     }
 
     if (ramTranslationUnit->getErrorReport().getNumIssues() != 0) {
@@ -681,11 +943,31 @@ int main(int argc, char** argv) {
             std::string baseIdentifier = identifier(simpleName(baseFilename));
             std::string sourceFilename = baseFilename + ".cpp";
 
+            // translation units of the strata, which are compiled together with the driver in sourceFilename
+            std::string unitFilenames;
+
             bool withSharedLibrary;
             const bool emitToStdOut = Global::config().has("generate", "-");
+            const std::size_t numUnits = Global::config().has("compile-units")
+                                                 ? std::stoul(Global::config().get("compile-units"))
+                                                 : 1;
             if (emitToStdOut)
                 synthesiser->generateCode(std::cout, baseIdentifier, withSharedLibrary);
-            else {
+            else if (numUnits > 1 && !Global::config().has("swig")) {
+                std::string headerFilename = baseFilename + ".h";
+                std::ofstream header{headerFilename};
+                std::ofstream driver{sourceFilename};
+                VecOwn<std::ofstream> unitStreams;
+                std::vector<std::ostream*> units;
+                for (std::size_t i = 1; i <= numUnits; i++) {
+                    std::string unitFilename = baseFilename + "_" + std::to_string(i) + ".cpp";
+                    unitStreams.push_back(mk<std::ofstream>(unitFilename));
+                    units.push_back(unitStreams.back().get());
+                    unitFilenames += " " + unitFilename;
+                }
+                synthesiser->generateCode(
+                        header, baseName(headerFilename), driver, units, baseIdentifier, withSharedLibrary);
+            } else {
                 std::ofstream os{sourceFilename};
                 synthesiser->generateCode(os, baseIdentifier, withSharedLibrary);
             }
@@ -713,7 +995,12 @@ int main(int argc, char** argv) {
                 compileToBinary(compileCmd, sourceFilename);
             } else if (Global::config().has("compile")) {
                 auto start = std::chrono::high_resolution_clock::now();
-                compileToBinary(findCompileCmd(), sourceFilename);
+                auto compileCmd = findCompileCmd();
+                // the runtime header is precompiled without the statistics of verbose mode
+                if (Global::config().has("type-cache") && !Global::config().has("verbose")) {
+                    compileCmd += " -p " + Global::config().get("type-cache");
+                }
+                compileToBinary(compileCmd, sourceFilename + unitFilenames);
                 /* Report overall run-time in verbose mode */
                 if (Global::config().has("verbose")) {
                     auto end = std::chrono::high_resolution_clock::now();
@@ -225,6 +225,9 @@
 %token BRIE_QUALIFIER            "BRIE datastructure qualifier"
 %token BTREE_QUALIFIER           "BTREE datastructure qualifier"
 %token EQREL_QUALIFIER           "equivalence relation qualifier"
+%token HASHSET_QUALIFIER         "HASHSET datastructure qualifier"
+%token COLUMNAR_QUALIFIER        "COLUMNAR datastructure qualifier"
+%token COMPRESSED_QUALIFIER      "COMPRESSED datastructure qualifier"
 %token OVERRIDABLE_QUALIFIER     "relation qualifier overidable"
 %token INLINE_QUALIFIER          "relation qualifier inline"
 %token MAGIC_QUALIFIER           "relation qualifier magic"
@@ -528,6 +531,9 @@ relation_tags
   | relation_tags        BRIE_QUALIFIER { $$ = driver.addReprTag(RelationTag::BRIE    , @2, $1); }
   | relation_tags       BTREE_QUALIFIER { $$ = driver.addReprTag(RelationTag::BTREE   , @2, $1); }
   | relation_tags       EQREL_QUALIFIER { $$ = driver.addReprTag(RelationTag::EQREL   , @2, $1); }
+  | relation_tags     HASHSET_QUALIFIER { $$ = driver.addReprTag(RelationTag::HASHSET , @2, $1); }
+  | relation_tags    COLUMNAR_QUALIFIER { $$ = driver.addReprTag(RelationTag::COLUMNAR, @2, $1); }
+  | relation_tags  COMPRESSED_QUALIFIER { $$ = driver.addReprTag(RelationTag::COMPRESSED, @2, $1); }
   ;
 
   /* List of variables */
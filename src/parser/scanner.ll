@@ -119,6 +119,9 @@ WS [ \t\r\v\f]
 "magic"                               { return yy::parser::make_MAGIC_QUALIFIER(yylloc); }
 "brie"                                { return yy::parser::make_BRIE_QUALIFIER(yylloc); }
 "btree"                               { return yy::parser::make_BTREE_QUALIFIER(yylloc); }
+"hashset"                             { return yy::parser::make_HASHSET_QUALIFIER(yylloc); }
+"columnar"                            { return yy::parser::make_COLUMNAR_QUALIFIER(yylloc); }
+"compressed"                          { return yy::parser::make_COMPRESSED_QUALIFIER(yylloc); }
 "min"                                 { return yy::parser::make_MIN(yylloc); }
 "max"                                 { return yy::parser::make_MAX(yylloc); }
 "as"                                  { return yy::parser::make_AS(yylloc); }
@@ -0,0 +1,115 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilterCheck.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Condition.h"
+#include "ram/Expression.h"
+#include "ram/Node.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class BloomFilterCheck
+ * @brief Test a tuple pattern against the Bloom filter of a relation
+ *
+ * The filter covers the columns whose values are defined in the pattern,
+ * and has to be built before by a BuildBloomFilter statement. The check
+ * is false only if no tuple of the relation matches the pattern; if it is
+ * true, a matching tuple may or may not exist.
+ *
+ * The following condition is false if no tuple of relation A has the
+ * value of t0.1 in its first column:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * (t0.1,_) ∈ BLOOM FILTER A
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class BloomFilterCheck : public Condition {
+public:
+    BloomFilterCheck(std::string rel, VecOwn<Expression> vals)
+            : relation(std::move(rel)), values(std::move(vals)) {
+        for (const auto& v : values) {
+            assert(v != nullptr && "NULL value");
+        }
+    }
+
+    /** @brief Get relation */
+    const std::string& getRelation() const {
+        return relation;
+    }
+
+    /** @brief Get the pattern, whose undefined values mark columns not covered by the filter */
+    const std::vector<Expression*> getValues() const {
+        return toPtrVector(values);
+    }
+
+    /** @brief Get the columns covered by the filter in ascending order */
+    std::vector<std::size_t> getColumns() const {
+        std::vector<std::size_t> columns;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (!isUndefValue(values[i].get())) {
+                columns.push_back(i);
+            }
+        }
+        return columns;
+    }
+
+    std::vector<const Node*> getChildNodes() const override {
+        std::vector<const Node*> res;
+        for (const auto& cur : values) {
+            res.push_back(cur.get());
+        }
+        return res;
+    }
+
+    void apply(const NodeMapper& map) override {
+        for (auto& val : values) {
+            val = map(std::move(val));
+        }
+    }
+
+    BloomFilterCheck* clone() const override {
+        return new BloomFilterCheck(relation, souffle::clone(values));
+    }
+
+protected:
+    void print(std::ostream& os) const override {
+        os << "(" << join(values, ",") << ") ∈ BLOOM FILTER " << relation;
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<BloomFilterCheck>(node);
+        return relation == other.relation && equal_targets(values, other.values);
+    }
+
+    /** Relation */
+    const std::string relation;
+
+    /** Search pattern */
+    VecOwn<Expression> values;
+};
+
+}  // namespace souffle::ram
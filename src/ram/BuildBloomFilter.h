@@ -0,0 +1,72 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BuildBloomFilter.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Node.h"
+#include "ram/Relation.h"
+#include "ram/RelationStatement.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class BuildBloomFilter
+ * @brief Build the Bloom filter over the values of some columns of a relation
+ *
+ * The filter is built from the tuples that the relation holds when the
+ * statement is executed, and serves the bloom filter checks of the same
+ * relation and columns afterwards.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * BUILD BLOOM FILTER A ON COLUMNS 0,2
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class BuildBloomFilter : public RelationStatement {
+public:
+    BuildBloomFilter(std::string rel, std::vector<std::size_t> columns)
+            : RelationStatement(rel), columns(std::move(columns)) {}
+
+    /** @brief Get the filtered columns in ascending order */
+    const std::vector<std::size_t>& getColumns() const {
+        return columns;
+    }
+
+    BuildBloomFilter* clone() const override {
+        return new BuildBloomFilter(relation, columns);
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "BUILD BLOOM FILTER " << relation << " ON COLUMNS " << join(columns, ",") << std::endl;
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<BuildBloomFilter>(node);
+        return RelationStatement::equal(other) && columns == other.columns;
+    }
+
+    /** Filtered columns */
+    const std::vector<std::size_t> columns;
+};
+
+}  // namespace souffle::ram
@@ -0,0 +1,142 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2013, 2014, Oracle and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file LeapfrogScan.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/ExistenceCheck.h"
+#include "ram/Expression.h"
+#include "ram/IndexOperation.h"
+#include "ram/Node.h"
+#include "ram/Operation.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class LeapfrogScan
+ * @brief Search for tuples of a relation matching a criteria whose value in
+ * the only unbounded column is also found in the relations of partners
+ *
+ * Each partner is a pattern with exactly one unbounded column. The index range
+ * of the scan and the ranges of the partners are sorted by their unbounded
+ * column, and they are intersected by leapfrogging: the range that is behind
+ * seeks to the value of the range that is ahead, until all ranges agree. This
+ * bounds the work by the smallest of the ranges instead of the scanned one,
+ * which turns the last step of cyclic joins such as triangles into a merge.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *	 FOR t1 IN B ON INDEX t1.0 = t0.1 LEAPFROG WITH (t0.0,_) ∈ C
+ *	 ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class LeapfrogScan : public IndexOperation {
+public:
+    LeapfrogScan(std::string rel, int ident, RamPattern queryPattern, VecOwn<ExistenceCheck> partners,
+            Own<Operation> nested, std::string profileText = "")
+            : IndexOperation(rel, ident, std::move(queryPattern), std::move(nested), std::move(profileText)),
+              partners(std::move(partners)) {
+        assert(!this->partners.empty() && "no partners");
+        for (const auto& partner : this->partners) {
+            assert(partner != nullptr && "partner is a null-pointer");
+        }
+    }
+
+    /** @brief Get the patterns whose unbounded column is intersected with the scanned one */
+    std::vector<ExistenceCheck*> getPartners() const {
+        return toPtrVector(partners);
+    }
+
+    /** @brief Get the unbounded column of the scanned relation */
+    std::size_t getColumn() const {
+        for (std::size_t i = 0; i < queryPattern.first.size(); ++i) {
+            if (isUndefValue(queryPattern.first[i].get())) {
+                return i;
+            }
+        }
+        fatal("leapfrog scan without unbounded column");
+    }
+
+    /** @brief Get the unbounded column of a partner */
+    static std::size_t getColumn(const ExistenceCheck& partner) {
+        const auto values = partner.getValues();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (isUndefValue(values[i])) {
+                return i;
+            }
+        }
+        fatal("leapfrog partner without unbounded column");
+    }
+
+    std::vector<const Node*> getChildNodes() const override {
+        auto res = IndexOperation::getChildNodes();
+        for (const auto& partner : partners) {
+            res.push_back(partner.get());
+        }
+        return res;
+    }
+
+    void apply(const NodeMapper& map) override {
+        IndexOperation::apply(map);
+        for (auto& partner : partners) {
+            partner = map(std::move(partner));
+        }
+    }
+
+    LeapfrogScan* clone() const override {
+        RamPattern resQueryPattern;
+        for (const auto& i : queryPattern.first) {
+            resQueryPattern.first.emplace_back(i->clone());
+        }
+        for (const auto& i : queryPattern.second) {
+            resQueryPattern.second.emplace_back(i->clone());
+        }
+        return new LeapfrogScan(relation, getTupleId(), std::move(resQueryPattern), souffle::clone(partners),
+                souffle::clone(getOperation()), getProfileText());
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos);
+        os << "FOR t" << getTupleId() << " IN " << relation;
+        printIndex(os);
+        os << " LEAPFROG WITH " << join(partners, " AND ", print_deref<Own<ExistenceCheck>>());
+        os << std::endl;
+        IndexOperation::print(os, tabpos + 1);
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<LeapfrogScan>(node);
+        return IndexOperation::equal(other) && equal_targets(partners, other.partners);
+    }
+
+    /** Patterns intersected with the scanned relation */
+    VecOwn<ExistenceCheck> partners;
+};
+
+}  // namespace souffle::ram
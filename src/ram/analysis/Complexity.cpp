@@ -15,6 +15,7 @@
  ***********************************************************************/
 
 #include "ram/analysis/Complexity.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Condition.h"
 #include "ram/Conjunction.h"
 #include "ram/EmptinessCheck.h"
@@ -50,6 +51,11 @@ int ComplexityAnalysis::getComplexity(const Node* node) const {
             return 2;
         }
 
+        // bloom filter check, which tests a single word
+        int visit_(type_identity<BloomFilterCheck>, const BloomFilterCheck&) override {
+            return 1;
+        }
+
         // provenance existence check
         int visit_(type_identity<ProvenanceExistenceCheck>, const ProvenanceExistenceCheck&) override {
             return 2;
@@ -549,4 +549,35 @@ bool IndexAnalysis::isTotalSignature(const AbstractExistenceCheck* existCheck) c
     return true;
 }
 
+RelationRepresentation IndexAnalysis::getRepresentation(const Relation& ramRel) const {
+    RelationRepresentation representation = ramRel.getRepresentation();
+    if (representation == RelationRepresentation::COMPRESSED) {
+        bool isCompressible = !ramRel.isNullary() && !Global::config().has("provenance");
+        return isCompressible ? representation : RelationRepresentation::BTREE;
+    }
+
+    bool hashset = representation == RelationRepresentation::HASHSET ||
+                   (representation == RelationRepresentation::DEFAULT && Global::config().has("hash-index"));
+    bool columnar = representation == RelationRepresentation::COLUMNAR;
+    if (!hashset && !columnar) {
+        return representation;
+    }
+
+    // hash sets and column stores are neither used for nullary relations nor for provenance
+    bool isHashable = !ramRel.isNullary() && !Global::config().has("provenance");
+    for (const auto& search : indexCover.at(ramRel.getName()).getSearches()) {
+        for (std::size_t i = 0; i < search.arity(); i++) {
+            if (search[i] != AttributeConstraint::Equal) {
+                isHashable = false;
+            }
+        }
+    }
+
+    if (isHashable) {
+        return columnar ? RelationRepresentation::COLUMNAR : RelationRepresentation::HASHSET;
+    }
+    return (representation == RelationRepresentation::DEFAULT) ? representation
+                                                               : RelationRepresentation::BTREE;
+}
+
 }  // namespace souffle::ram::analysis
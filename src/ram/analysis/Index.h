@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "RelationTag.h"
 #include "ram/AbstractExistenceCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/IndexOperation.h"
@@ -535,6 +536,20 @@ public:
      */
     bool isTotalSignature(const AbstractExistenceCheck* existCheck) const;
 
+    /**
+     * @Brief Get the data-structure that realises a relation
+     * @param ramRel RAM-relation
+     *
+     * A hash set can only serve searches binding all attributes. Hence, a relation
+     * tagged as hashset falls back to a B-tree if it is searched otherwise, and a
+     * relation without representation is turned into a hashset if it is only
+     * searched by full equality and hash indexes are enabled (--hash-index).
+     * Column stores are subject to the same restriction as they rely on a hash
+     * table for lookups. Compressed B-trees fall back to B-trees for nullary
+     * relations and for provenance.
+     */
+    RelationRepresentation getRepresentation(const Relation& ramRel) const;
+
 private:
     /** relation analysis for looking up relations by name */
     RelationAnalysis* relAnalysis;
@@ -17,6 +17,7 @@
 #include "ram/analysis/Level.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Break.h"
 #include "ram/Choice.h"
 #include "ram/Condition.h"
@@ -32,6 +33,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/Negation.h"
 #include "ram/Node.h"
 #include "ram/NumericConstant.h"
@@ -102,6 +104,21 @@ int LevelAnalysis::getLevel(const Node* node) const {
             return level;
         }
 
+        // leapfrog scan
+        int visit_(type_identity<LeapfrogScan>, const LeapfrogScan& leapfrogScan) override {
+            int level = -1;
+            for (auto& index : leapfrogScan.getRangePattern().first) {
+                level = std::max(level, dispatch(*index));
+            }
+            for (auto& index : leapfrogScan.getRangePattern().second) {
+                level = std::max(level, dispatch(*index));
+            }
+            for (auto* partner : leapfrogScan.getPartners()) {
+                level = std::max(level, dispatch(*partner));
+            }
+            return level;
+        }
+
         // choice
         int visit_(type_identity<Choice>, const Choice& choice) override {
             return std::max(-1, dispatch(choice.getCondition()));
@@ -246,6 +263,15 @@ int LevelAnalysis::getLevel(const Node* node) const {
             return level;
         }
 
+        // bloom filter check
+        int visit_(type_identity<BloomFilterCheck>, const BloomFilterCheck& check) override {
+            int level = -1;
+            for (const auto& cur : check.getValues()) {
+                level = std::max(level, dispatch(*cur));
+            }
+            return level;
+        }
+
         // provenance existence check
         int visit_(type_identity<ProvenanceExistenceCheck>,
                 const ProvenanceExistenceCheck& provExists) override {
@@ -0,0 +1,133 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_bloom_filter_test.cpp
+ *
+ * Tests the guarding of index scans with Bloom filter checks.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "RelationTag.h"
+#include "ram/BloomFilterCheck.h"
+#include "ram/BuildBloomFilter.h"
+#include "ram/Call.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/IO.h"
+#include "ram/IndexScan.h"
+#include "ram/Insert.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/TranslationUnit.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/transform/BloomFilter.h"
+#include "ram/utility/Visitor.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+namespace test {
+
+/** Create the join query: FOR t0 IN A, FOR t1 IN B ON INDEX t1.0 = t0.1, INSERT (t0.0, t1.1) INTO T */
+Own<Statement> join() {
+    RamPattern pattern;
+    pattern.first.push_back(mk<TupleElement>(0, 1));
+    pattern.first.push_back(mk<UndefValue>());
+    pattern.second.push_back(mk<TupleElement>(0, 1));
+    pattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    values.push_back(mk<TupleElement>(1, 1));
+    return mk<Query>(mk<Scan>("A", 0,
+            mk<IndexScan>("B", 1, std::move(pattern), mk<Insert>("T", std::move(values)))));
+}
+
+/** Apply the Bloom filter transformer to a program loading B in stratum_0 and joining in stratum_1 */
+Own<Program> transform(std::map<std::string, std::size_t> sizes, bool sameStratum = false) {
+    VecOwn<Relation> rels;
+    for (const std::string name : {"A", "B", "T"}) {
+        rels.push_back(mk<Relation>(name, 2, 0, std::vector<std::string>{"x", "y"},
+                std::vector<std::string>{"i:number", "i:number"}, RelationRepresentation::BTREE));
+    }
+    auto load = mk<IO>("B", std::map<std::string, std::string>{{"operation", "input"}});
+    std::map<std::string, Own<Statement>> subs;
+    if (sameStratum) {
+        subs["stratum_0"] = mk<Sequence>(std::move(load), join());
+        subs["stratum_1"] = mk<Sequence>();
+    } else {
+        subs["stratum_0"] = mk<Sequence>(std::move(load));
+        subs["stratum_1"] = mk<Sequence>(join());
+    }
+    ErrorReport errorReport;
+    DebugReport debugReport;
+    auto main = mk<Sequence>(mk<Call>("stratum_0"), mk<Call>("stratum_1"));
+    TranslationUnit unit(
+            mk<Program>(std::move(rels), std::move(main), std::move(subs)), errorReport, debugReport);
+    transform::BloomFilterTransformer(std::move(sizes)).apply(unit);
+    return souffle::clone(unit.getProgram());
+}
+
+/** Collect the Bloom filter checks of a program */
+std::vector<const BloomFilterCheck*> getFilterChecks(const Program& program) {
+    std::vector<const BloomFilterCheck*> checks;
+    visit(program, [&](const BloomFilterCheck& check) { checks.push_back(&check); });
+    return checks;
+}
+
+TEST(BloomFilter, Guarded) {
+    auto program = transform({{"A", 1 << 20}, {"B", 1000}});
+    auto checks = getFilterChecks(*program);
+    EXPECT_EQ(1, checks.size());
+
+    // the check covers the bound first column
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 1));
+    values.push_back(mk<UndefValue>());
+    EXPECT_EQ(BloomFilterCheck("B", std::move(values)), *checks[0]);
+    EXPECT_EQ(std::vector<std::size_t>{0}, checks[0]->getColumns());
+
+    // the filter is built at the end of the stratum loading B
+    std::vector<const BuildBloomFilter*> builds;
+    visit(program->getSubroutine("stratum_0"),
+            [&](const BuildBloomFilter& build) { builds.push_back(&build); });
+    EXPECT_EQ(1, builds.size());
+    EXPECT_EQ(BuildBloomFilter("B", {0}), *builds[0]);
+}
+
+TEST(BloomFilter, Unchanged) {
+    // without profiled sizes
+    EXPECT_EQ(0, getFilterChecks(*transform({})).size());
+    EXPECT_EQ(0, getFilterChecks(*transform({{"A", 1 << 20}})).size());
+
+    // too few probes
+    EXPECT_EQ(0, getFilterChecks(*transform({{"A", 1000}, {"B", 10}})).size());
+
+    // too few probes per tuple of the probed relation
+    EXPECT_EQ(0, getFilterChecks(*transform({{"A", 1 << 20}, {"B", 1 << 18}})).size());
+
+    // the probed relation is not complete before the join
+    EXPECT_EQ(0, getFilterChecks(*transform({{"A", 1 << 20}, {"B", 1000}}, true)).size());
+}
+
+}  // end namespace test
+}  // namespace souffle::ram
@@ -0,0 +1,99 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_expire_relations_test.cpp
+ *
+ * Tests the placement of clear operations by the expire-relations transformer.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "ram/Call.h"
+#include "ram/Clear.h"
+#include "ram/Expression.h"
+#include "ram/IO.h"
+#include "ram/Insert.h"
+#include "ram/Loop.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/Statement.h"
+#include "ram/TupleElement.h"
+#include "ram/transform/ExpireRelations.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+namespace test {
+
+/** Create a query copying relation src into relation dest */
+Own<Statement> copy(const std::string& src, const std::string& dest) {
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    return mk<Query>(mk<Scan>(src, 0, mk<Insert>(dest, std::move(values))));
+}
+
+/** Return the statements of the given subroutine */
+std::vector<Statement*> getStatements(const Program& program, const std::string& name) {
+    return as<Sequence>(program.getSubroutine(name))->getStatements();
+}
+
+TEST(ExpireRelations, ClearAfterLastUse) {
+    // stratum_0: C := A; C := B; output C; clear A; clear B
+    std::map<std::string, Own<Statement>> subs;
+    subs["stratum_0"] = mk<Sequence>(
+            mk<Sequence>(copy("A", "C"), copy("B", "C"),
+                    mk<IO>("C", std::map<std::string, std::string>{{"operation", "output"}})),
+            mk<Sequence>(mk<Clear>("A"), mk<Clear>("B")));
+    Program program({}, mk<Sequence>(mk<Call>("stratum_0")), std::move(subs));
+
+    transform::ExpireRelationsTransformer transformer;
+    EXPECT_TRUE(transformer.expireRelations(program));
+
+    // stratum_0: C := A; clear A; C := B; clear B; output C
+    auto stmts = getStatements(program, "stratum_0");
+    EXPECT_EQ(5, stmts.size());
+    EXPECT_EQ(*copy("A", "C"), *stmts[0]);
+    EXPECT_EQ(Clear("A"), *stmts[1]);
+    EXPECT_EQ(*copy("B", "C"), *stmts[2]);
+    EXPECT_EQ(Clear("B"), *stmts[3]);
+    EXPECT_TRUE(isA<IO>(stmts[4]));
+
+    // clear operations already follow the last use of their relations
+    EXPECT_FALSE(transformer.expireRelations(program));
+}
+
+TEST(ExpireRelations, LoopIsAtomic) {
+    // stratum_0: loop { C := A }; C := B; clear A; clear D
+    std::map<std::string, Own<Statement>> subs;
+    subs["stratum_0"] = mk<Sequence>(
+            mk<Loop>(mk<Sequence>(copy("A", "C"))), copy("B", "C"), mk<Clear>("A"), mk<Clear>("D"));
+    Program program({}, mk<Sequence>(mk<Call>("stratum_0")), std::move(subs));
+
+    transform::ExpireRelationsTransformer transformer;
+    EXPECT_TRUE(transformer.expireRelations(program));
+
+    // A is cleared after the loop; D is not used, so its clear stays in place
+    auto stmts = getStatements(program, "stratum_0");
+    EXPECT_EQ(4, stmts.size());
+    EXPECT_TRUE(isA<Loop>(stmts[0]));
+    EXPECT_EQ(Clear("A"), *stmts[1]);
+    EXPECT_EQ(*copy("B", "C"), *stmts[2]);
+    EXPECT_EQ(Clear("D"), *stmts[3]);
+}
+
+}  // end namespace test
+}  // namespace souffle::ram
@@ -0,0 +1,143 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_leapfrog_test.cpp
+ *
+ * Tests the conversion of index scans closing cyclic joins to leapfrog scans.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "RelationTag.h"
+#include "ram/Call.h"
+#include "ram/Condition.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/IndexScan.h"
+#include "ram/Insert.h"
+#include "ram/LeapfrogScan.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/TranslationUnit.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/transform/Leapfrog.h"
+#include "ram/utility/Visitor.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/BinaryConstraintOps.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+namespace test {
+
+/** Create the triangle query: FOR t0 IN E, FOR t1 IN E ON INDEX t1.0 = t0.1, IF condition INSERT */
+Own<Statement> triangles(Own<Condition> condition) {
+    RamPattern pattern;
+    pattern.first.push_back(mk<TupleElement>(0, 1));
+    pattern.first.push_back(mk<UndefValue>());
+    pattern.second.push_back(mk<TupleElement>(0, 1));
+    pattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    values.push_back(mk<TupleElement>(0, 1));
+    values.push_back(mk<TupleElement>(1, 1));
+    return mk<Query>(mk<Scan>("E", 0,
+            mk<IndexScan>("E", 1, std::move(pattern),
+                    mk<Filter>(std::move(condition), mk<Insert>("T", std::move(values))))));
+}
+
+/** Create the existence check (t0.0, t1.column) ∈ E */
+Own<ExistenceCheck> closing(std::size_t column) {
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    values.push_back(mk<TupleElement>(1, column));
+    return mk<ExistenceCheck>("E", std::move(values));
+}
+
+/** Apply the leapfrog transformer to a program consisting of the given query */
+Own<Program> transform(Own<Statement> query, const std::string& type = "i:number") {
+    VecOwn<Relation> rels;
+    rels.push_back(mk<Relation>("E", 2, 0, std::vector<std::string>{"x", "y"},
+            std::vector<std::string>{type, type}, RelationRepresentation::BTREE));
+    rels.push_back(mk<Relation>("T", 3, 0, std::vector<std::string>{"x", "y", "z"},
+            std::vector<std::string>{type, type, type}, RelationRepresentation::BTREE));
+    std::map<std::string, Own<Statement>> subs;
+    subs["stratum_0"] = mk<Sequence>(std::move(query));
+    ErrorReport errorReport;
+    DebugReport debugReport;
+    TranslationUnit unit(
+            mk<Program>(std::move(rels), mk<Sequence>(mk<Call>("stratum_0")), std::move(subs)), errorReport,
+            debugReport);
+    transform::LeapfrogTransformer().apply(unit);
+    return souffle::clone(unit.getProgram());
+}
+
+/** Collect the leapfrog scans of a program */
+std::vector<const LeapfrogScan*> getLeapfrogScans(const Program& program) {
+    std::vector<const LeapfrogScan*> scans;
+    visit(program, [&](const LeapfrogScan& scan) { scans.push_back(&scan); });
+    return scans;
+}
+
+TEST(Leapfrog, Triangle) {
+    auto program = transform(triangles(closing(1)));
+    auto scans = getLeapfrogScans(*program);
+    EXPECT_EQ(1, scans.size());
+
+    // the existence check becomes a partner and the filter is dropped
+    const auto* scan = scans[0];
+    EXPECT_EQ(1, scan->getColumn());
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(0, 0));
+    values.push_back(mk<UndefValue>());
+    EXPECT_EQ(1, scan->getPartners().size());
+    EXPECT_EQ(ExistenceCheck("E", std::move(values)), *scan->getPartners()[0]);
+    EXPECT_TRUE(isA<Insert>(scan->getOperation()));
+}
+
+TEST(Leapfrog, KeepsOtherConditions) {
+    auto constraint = mk<Constraint>(BinaryConstraintOp::LT, mk<TupleElement>(0, 0), mk<TupleElement>(1, 1));
+    auto program = transform(triangles(mk<Conjunction>(closing(1), souffle::clone(constraint))));
+    auto scans = getLeapfrogScans(*program);
+    EXPECT_EQ(1, scans.size());
+
+    const auto* filter = as<Filter>(scans[0]->getOperation());
+    EXPECT_TRUE(filter != nullptr);
+    EXPECT_EQ(*constraint, filter->getCondition());
+}
+
+TEST(Leapfrog, Unchanged) {
+    // the existence check does not depend on the unbounded column
+    EXPECT_EQ(0, getLeapfrogScans(*transform(triangles(closing(0)))).size());
+
+    // floats cannot be stepped through
+    EXPECT_EQ(0, getLeapfrogScans(*transform(triangles(closing(1)), "f:float")).size());
+
+    // the condition is no existence check
+    auto constraint = mk<Constraint>(BinaryConstraintOp::EQ, mk<TupleElement>(1, 1), mk<SignedConstant>(1));
+    EXPECT_EQ(0, getLeapfrogScans(*transform(triangles(std::move(constraint)))).size());
+}
+
+}  // end namespace test
+}  // namespace souffle::ram
@@ -32,6 +32,7 @@
 #include "ram/IndexChoice.h"
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/Negation.h"
 #include "ram/Operation.h"
 #include "ram/PackRecord.h"
@@ -175,6 +176,45 @@ TEST(RamParallelIndexScan, CloneAndEquals) {
     delete c;
 }
 
+TEST(RamLeapfrogScan, CloneAndEquals) {
+    Relation edge("edge", 2, 1, {"x", "y"}, {"i", "i"}, RelationRepresentation::DEFAULT);
+    Relation triangle("triangle", 3, 1, {"x", "y", "z"}, {"i", "i", "i"}, RelationRepresentation::DEFAULT);
+    // close the triangles of the edges of t0
+    // FOR t1 IN edge ON INDEX t1.x = t0.1 LEAPFROG WITH (t0.0,_) ∈ edge
+    //  INSERT (t0.0, t0.1, t1.1) INTO triangle
+    auto makeScan = []() {
+        VecOwn<Expression> insertArgs;
+        insertArgs.emplace_back(new TupleElement(0, 0));
+        insertArgs.emplace_back(new TupleElement(0, 1));
+        insertArgs.emplace_back(new TupleElement(1, 1));
+        auto insert = mk<Insert>("triangle", std::move(insertArgs));
+        RamPattern criteria;
+        criteria.first.emplace_back(new TupleElement(0, 1));
+        criteria.first.emplace_back(new UndefValue);
+        criteria.second.emplace_back(new TupleElement(0, 1));
+        criteria.second.emplace_back(new UndefValue);
+        VecOwn<Expression> partnerArgs;
+        partnerArgs.emplace_back(new TupleElement(0, 0));
+        partnerArgs.emplace_back(new UndefValue);
+        VecOwn<ExistenceCheck> partners;
+        partners.push_back(mk<ExistenceCheck>("edge", std::move(partnerArgs)));
+        return mk<LeapfrogScan>("edge", 1, std::move(criteria), std::move(partners), std::move(insert),
+                "LeapfrogScan test");
+    };
+
+    auto a = makeScan();
+    auto b = makeScan();
+    EXPECT_EQ(*a, *b);
+    EXPECT_NE(a.get(), b.get());
+    EXPECT_EQ(1u, a->getColumn());
+    EXPECT_EQ(1u, LeapfrogScan::getColumn(*a->getPartners()[0]));
+
+    LeapfrogScan* c = a->clone();
+    EXPECT_EQ(*a, *c);
+    EXPECT_NE(a.get(), c);
+    delete c;
+}
+
 TEST(RamChoice, CloneAndEquals) {
     Relation edge("edge", 2, 1, {"x", "y"}, {"i", "i"}, RelationRepresentation::DEFAULT);
     // choose an edge not adjcent to vertex 5
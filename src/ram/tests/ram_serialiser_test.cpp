@@ -0,0 +1,179 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_serialiser_test.cpp
+ *
+ * Tests writing RAM programs and reading them back.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "RelationTag.h"
+#include "ram/Call.h"
+#include "ram/Constraint.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Exit.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/FloatConstant.h"
+#include "ram/IO.h"
+#include "ram/IndexAggregate.h"
+#include "ram/Insert.h"
+#include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
+#include "ram/LogRelationTimer.h"
+#include "ram/Loop.h"
+#include "ram/Negation.h"
+#include "ram/ParallelIndexScan.h"
+#include "ram/Program.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/StringConstant.h"
+#include "ram/Swap.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/Serialiser.h"
+#include "souffle/BinaryConstraintOps.h"
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+namespace test {
+
+/** Write a program and read it back */
+Own<Program> roundTrip(const Program& program) {
+    std::stringstream ss;
+    writeProgram(ss, program);
+    return readProgram(ss);
+}
+
+/** Check that reading the given text fails */
+bool isMalformed(const std::string& text) {
+    std::stringstream ss(text);
+    try {
+        readProgram(ss);
+    } catch (std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+TEST(Serialiser, RoundTrip) {
+    VecOwn<Relation> rels;
+    rels.push_back(mk<Relation>("A", 2, 0, std::vector<std::string>{"x", "y"},
+            std::vector<std::string>{"i:number", "s:a b"}, RelationRepresentation::BTREE));
+    rels.push_back(mk<Relation>("@delta_A", 2, 0, std::vector<std::string>{"x", "y"},
+            std::vector<std::string>{"i:number", "s:a b"}, RelationRepresentation::DEFAULT));
+
+    // FOR t0 IN A ON INDEX t0.0 = 1 IF t0.1 != "a \n b" INSERT (t0.0 + 1, 2.5) INTO @delta_A
+    VecOwn<Expression> args;
+    args.push_back(mk<TupleElement>(0, 0));
+    args.push_back(mk<SignedConstant>(1));
+    VecOwn<Expression> values;
+    values.push_back(mk<IntrinsicOperator>(FunctorOp::ADD, std::move(args)));
+    values.push_back(mk<FloatConstant>(2.5));
+    auto filter = mk<Filter>(mk<Constraint>(BinaryConstraintOp::NE, mk<TupleElement>(0, 1),
+                                     mk<StringConstant>("a \n b")),
+            mk<Insert>("@delta_A", std::move(values)), "profile A");
+    RamPattern pattern;
+    pattern.first.push_back(mk<SignedConstant>(1));
+    pattern.first.push_back(mk<UndefValue>());
+    pattern.second.push_back(mk<SignedConstant>(1));
+    pattern.second.push_back(mk<UndefValue>());
+    auto query = mk<Query>(mk<ParallelIndexScan>("A", 0, std::move(pattern), std::move(filter)));
+
+    // t1.0 = COUNT FOR ALL t1 IN A WHERE t1.0 = 1
+    RamPattern aggregatePattern;
+    aggregatePattern.first.push_back(mk<UndefValue>());
+    aggregatePattern.first.push_back(mk<UndefValue>());
+    aggregatePattern.second.push_back(mk<UndefValue>());
+    aggregatePattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> count;
+    count.push_back(mk<TupleElement>(1, 0));
+    count.push_back(mk<TupleElement>(1, 0));
+    auto condition = mk<Constraint>(BinaryConstraintOp::EQ, mk<TupleElement>(1, 0), mk<SignedConstant>(1));
+    auto aggregate = mk<Query>(mk<IndexAggregate>(mk<Insert>("A", std::move(count)), AggregateOp::COUNT, "A",
+            mk<UndefValue>(), std::move(condition), std::move(aggregatePattern), 1));
+
+    std::map<std::string, Own<Statement>> subs;
+    subs["stratum_0"] = mk<Sequence>(
+            mk<IO>("A", std::map<std::string, std::string>{{"operation", "input"}, {"name", "A"}}),
+            mk<Loop>(mk<Sequence>(mk<LogRelationTimer>(std::move(query), "@t-nonrecursive-rule;A;", "A"),
+                    mk<Exit>(mk<Negation>(mk<EmptinessCheck>("@delta_A"))), mk<Swap>("A", "@delta_A"))),
+            std::move(aggregate));
+    Program program(std::move(rels), mk<Sequence>(mk<Call>("stratum_0")), std::move(subs));
+
+    auto read = roundTrip(program);
+    EXPECT_EQ(program, *read);
+    EXPECT_EQ(toString(program), toString(*read));
+}
+
+TEST(Serialiser, LeapfrogScan) {
+    // FOR t0 IN A FOR t1 IN A ON INDEX t1.0 = t0.1 LEAPFROG WITH (t0.0,_) ∈ A INSERT (t1.1, t0.0) INTO A
+    RamPattern pattern;
+    pattern.first.push_back(mk<TupleElement>(0, 1));
+    pattern.first.push_back(mk<UndefValue>());
+    pattern.second.push_back(mk<TupleElement>(0, 1));
+    pattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> partnerValues;
+    partnerValues.push_back(mk<TupleElement>(0, 0));
+    partnerValues.push_back(mk<UndefValue>());
+    VecOwn<ExistenceCheck> partners;
+    partners.push_back(mk<ExistenceCheck>("A", std::move(partnerValues)));
+    VecOwn<Expression> values;
+    values.push_back(mk<TupleElement>(1, 1));
+    values.push_back(mk<TupleElement>(0, 0));
+    auto scan = mk<LeapfrogScan>("A", 1, std::move(pattern), std::move(partners),
+            mk<Insert>("A", std::move(values)), "profile A");
+
+    std::map<std::string, Own<Statement>> subs;
+    subs["stratum_0"] = mk<Sequence>(mk<Query>(mk<Scan>("A", 0, std::move(scan))));
+    Program program({}, mk<Sequence>(mk<Call>("stratum_0")), std::move(subs));
+
+    auto read = roundTrip(program);
+    EXPECT_EQ(program, *read);
+    EXPECT_EQ(toString(program), toString(*read));
+}
+
+TEST(Serialiser, EmptyStrings) {
+    std::map<std::string, Own<Statement>> subs;
+    subs[""] = mk<Sequence>(mk<Query>(mk<Scan>("", 0, mk<Insert>("", VecOwn<Expression>()))));
+    Program program({}, mk<Sequence>(mk<Call>("")), std::move(subs));
+
+    EXPECT_EQ(program, *roundTrip(program));
+}
+
+TEST(Serialiser, Malformed) {
+    EXPECT_FALSE(isMalformed("0 0 Sequence 1 Call 3:abc"));
+    EXPECT_TRUE(isMalformed("0 0 Sequence 1 Call 3:ab"));
+    EXPECT_TRUE(isMalformed("0 0 Sequence 2 Call 3:abc"));
+    EXPECT_TRUE(isMalformed("0 0 Sequence 1 Unknown"));
+
+    // the main program is a statement
+    EXPECT_TRUE(isMalformed("0 0 True"));
+}
+
+}  // end namespace test
+}  // namespace souffle::ram
@@ -0,0 +1,171 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilter.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/BloomFilter.h"
+#include "ram/BuildBloomFilter.h"
+#include "ram/Expression.h"
+#include "ram/Extend.h"
+#include "ram/Filter.h"
+#include "ram/IO.h"
+#include "ram/Insert.h"
+#include "ram/Node.h"
+#include "ram/ParallelIndexScan.h"
+#include "ram/Query.h"
+#include "ram/Sequence.h"
+#include "ram/Statement.h"
+#include "ram/Swap.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/LambdaNodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/utility/MiscUtil.h"
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+namespace {
+
+/** Collect the names of the relations to which a statement adds tuples */
+std::set<std::string> getWrittenRelations(const Statement& stmt) {
+    std::set<std::string> names;
+    visit(stmt, [&](const Node& node) {
+        if (const auto* insert = as<Insert>(node)) {
+            names.insert(insert->getRelation());
+        } else if (const auto* io = as<IO>(node)) {
+            if (io->get("operation") == "input") {
+                names.insert(io->getRelation());
+            }
+        } else if (const auto* swap = as<Swap>(node)) {
+            names.insert(swap->getFirstRelation());
+            names.insert(swap->getSecondRelation());
+        } else if (const auto* extend = as<Extend>(node)) {
+            names.insert(extend->getTargetRelation());
+        }
+    });
+    return names;
+}
+
+}  // namespace
+
+Own<BloomFilterCheck> BloomFilterTransformer::makeCheck(
+        const IndexScan& indexScan, const RelationOperation& outer) const {
+    // the filter pays off if it saves many probes and most of them are bound to miss
+    auto inner = relationSizes.find(indexScan.getRelation());
+    auto probes = relationSizes.find(outer.getRelation());
+    if (inner == relationSizes.end() || probes == relationSizes.end()) {
+        return nullptr;
+    }
+    if (probes->second < minProbes || probes->second / probesPerTuple < inner->second) {
+        return nullptr;
+    }
+
+    // the filter covers the columns bound to a single value
+    const auto pattern = indexScan.getRangePattern();
+    VecOwn<Expression> values;
+    bool bound = false;
+    for (std::size_t i = 0; i < pattern.first.size(); ++i) {
+        const Expression* low = pattern.first[i];
+        const Expression* high = pattern.second[i];
+        if (!isUndefValue(low) && !isUndefValue(high) && *low == *high) {
+            values.push_back(souffle::clone(low));
+            bound = true;
+        } else {
+            values.push_back(mk<UndefValue>());
+        }
+    }
+    if (!bound) {
+        return nullptr;
+    }
+    return mk<BloomFilterCheck>(indexScan.getRelation(), std::move(values));
+}
+
+bool BloomFilterTransformer::filterIndexScans(Program& program) {
+    // the subroutines adding tuples to each relation
+    std::map<std::string, std::set<std::string>> writers;
+    for (const auto& [name, sub] : program.getSubroutines()) {
+        for (const auto& rel : getWrittenRelations(*sub)) {
+            writers[rel].insert(name);
+        }
+    }
+
+    // the filters built at the end of each subroutine
+    std::map<std::string, std::set<std::pair<std::string, std::vector<std::size_t>>>> builds;
+    bool changed = false;
+    for (const auto& [name, sub] : program.getSubroutines()) {
+        visit(*sub, [&, name = name](const Query& query) {
+            // determine the checks guarding index scans, whose relations are complete before the stratum
+            std::map<const Node*, Own<BloomFilterCheck>> checks;
+            std::function<void(const Node&, const RelationOperation*)> collect =
+                    [&](const Node& node, const RelationOperation* outer) {
+                        const auto* indexScan = as<IndexScan>(node);
+                        if (indexScan != nullptr && !isA<ParallelIndexScan>(indexScan) && outer != nullptr) {
+                            auto pos = writers.find(indexScan->getRelation());
+                            if (pos != writers.end() && pos->second.size() == 1 &&
+                                    pos->second.count(name) == 0) {
+                                if (auto check = makeCheck(*indexScan, *outer)) {
+                                    builds[*pos->second.begin()].insert(
+                                            {check->getRelation(), check->getColumns()});
+                                    checks[indexScan] = std::move(check);
+                                }
+                            }
+                        }
+                        const auto* op = as<RelationOperation>(node);
+                        for (const Node* child : node.getChildNodes()) {
+                            collect(*child, op != nullptr ? op : outer);
+                        }
+                    };
+            collect(query, nullptr);
+            if (checks.empty()) {
+                return;
+            }
+
+            std::function<Own<Node>(Own<Node>)> guard = [&](Own<Node> node) -> Own<Node> {
+                node->apply(makeLambdaRamMapper(guard));
+                auto pos = checks.find(node.get());
+                if (pos != checks.end()) {
+                    return mk<Filter>(std::move(pos->second), souffle::clone(as<IndexScan>(node)));
+                }
+                return node;
+            };
+            const_cast<Query*>(&query)->apply(makeLambdaRamMapper(guard));
+            changed = true;
+        });
+    }
+    if (!changed) {
+        return false;
+    }
+
+    // build the filters once the strata computing their relations are finished
+    std::map<const Node*, std::string> subroutineNames;
+    for (const auto& [name, sub] : program.getSubroutines()) {
+        subroutineNames[sub] = name;
+    }
+    program.apply(makeLambdaRamMapper([&](Own<Node> node) -> Own<Node> {
+        auto pos = subroutineNames.find(node.get());
+        if (pos == subroutineNames.end() || builds.count(pos->second) == 0) {
+            return node;
+        }
+        VecOwn<Statement> stmts;
+        stmts.push_back(Own<Statement>(as<Statement>(node.release())));
+        for (const auto& [rel, columns] : builds[pos->second]) {
+            stmts.push_back(mk<BuildBloomFilter>(rel, columns));
+        }
+        return mk<Sequence>(std::move(stmts));
+    }));
+    return true;
+}
+
+}  // namespace souffle::ram::transform
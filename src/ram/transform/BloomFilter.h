@@ -0,0 +1,110 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilter.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/BloomFilterCheck.h"
+#include "ram/IndexScan.h"
+#include "ram/Program.h"
+#include "ram/RelationOperation.h"
+#include "ram/TranslationUnit.h"
+#include "ram/transform/Transformer.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class BloomFilterTransformer
+ * @brief Guard the index scans of relations computed by earlier strata with Bloom filter checks
+ *
+ * If an outer scan over a large relation feeds an index scan of a much
+ * smaller relation, most of the index scans come back empty after
+ * descending into the index. The relation is complete once the stratum
+ * computing it is finished, so a Bloom filter over the columns that the
+ * index scan binds by equality is built at the end of that stratum, and
+ * the index scan is only entered if the filter may contain its key.
+ *
+ * Building the filter costs a pass over the probed relation, while its
+ * savings grow with the number of probes, which is estimated by the size
+ * of the relation of the outer scan. Both sizes are taken from a profile
+ * of a previous run, and relations without a profiled size are left
+ * unchanged.
+ *
+ * For example,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    FOR t1 IN B ON INDEX t1.0 = t0.1
+ *     ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    IF (t0.1,_) ∈ BLOOM FILTER B
+ *     FOR t1 IN B ON INDEX t1.0 = t0.1
+ *      ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * and BUILD BLOOM FILTER B ON COLUMNS 0 is appended to the stratum of B.
+ */
+class BloomFilterTransformer : public Transformer {
+public:
+    /** The least number of probes for which a filter is built */
+    static constexpr std::size_t minProbes = 1 << 16;
+
+    /** The least number of probes per tuple of the probed relation for which a filter is built */
+    static constexpr std::size_t probesPerTuple = 8;
+
+    /**
+     * @param relationSizes The profiled sizes of relations
+     */
+    BloomFilterTransformer(std::map<std::string, std::size_t> relationSizes)
+            : relationSizes(std::move(relationSizes)) {}
+
+    std::string getName() const override {
+        return "BloomFilterTransformer";
+    }
+
+    /**
+     * @brief Guard index scans with bloom filter checks and build the filters
+     * @param program Program that is transformed
+     * @return Flag showing whether the program has been changed by the transformation
+     */
+    bool filterIndexScans(Program& program);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        return filterIndexScans(translationUnit.getProgram());
+    }
+
+    /**
+     * @brief Create the bloom filter check guarding an index scan, if a filter pays off
+     * @param indexScan The index scan
+     * @param outer The operation enclosing the index scan, whose tuples trigger it
+     * @result Null if the index scan is not guarded
+     */
+    Own<BloomFilterCheck> makeCheck(const IndexScan& indexScan, const RelationOperation& outer) const;
+
+    /** The profiled sizes of relations */
+    std::map<std::string, std::size_t> relationSizes;
+};
+
+}  // namespace souffle::ram::transform
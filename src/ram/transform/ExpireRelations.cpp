@@ -0,0 +1,136 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ExpireRelations.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/ExpireRelations.h"
+#include "ram/AbstractExistenceCheck.h"
+#include "ram/BinRelationStatement.h"
+#include "ram/Clear.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/Insert.h"
+#include "ram/Node.h"
+#include "ram/Program.h"
+#include "ram/RelationOperation.h"
+#include "ram/RelationSize.h"
+#include "ram/RelationStatement.h"
+#include "ram/Sequence.h"
+#include "ram/Statement.h"
+#include "ram/utility/LambdaNodeMapper.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+namespace {
+
+/** Collect the names of all relations referenced by a statement */
+std::set<std::string> getReferencedRelations(const Statement& stmt) {
+    std::set<std::string> names;
+    visit(stmt, [&](const Node& node) {
+        if (const auto* relStmt = as<RelationStatement>(node)) {
+            names.insert(relStmt->getRelation());
+        } else if (const auto* binStmt = as<BinRelationStatement>(node)) {
+            names.insert(binStmt->getFirstRelation());
+            names.insert(binStmt->getSecondRelation());
+        } else if (const auto* op = as<RelationOperation>(node)) {
+            names.insert(op->getRelation());
+        } else if (const auto* insert = as<Insert>(node)) {
+            names.insert(insert->getRelation());
+        } else if (const auto* exists = as<AbstractExistenceCheck>(node)) {
+            names.insert(exists->getRelation());
+        } else if (const auto* emptiness = as<EmptinessCheck>(node)) {
+            names.insert(emptiness->getRelation());
+        } else if (const auto* size = as<RelationSize>(node)) {
+            names.insert(size->getRelation());
+        }
+    });
+    return names;
+}
+
+/** Flatten nested sequences into a list of statements */
+void flatten(const Statement& stmt, std::vector<const Statement*>& stmts) {
+    if (const auto* sequence = as<Sequence>(stmt)) {
+        for (const auto* cur : sequence->getStatements()) {
+            flatten(*cur, stmts);
+        }
+    } else {
+        stmts.push_back(&stmt);
+    }
+}
+
+}  // namespace
+
+bool ExpireRelationsTransformer::expireRelations(Program& program) {
+    std::map<const Node*, Own<Statement>> replacements;
+    for (const auto& sub : program.getSubroutines()) {
+        std::vector<const Statement*> stmts;
+        flatten(*sub.second, stmts);
+
+        std::vector<std::set<std::string>> references;
+        for (const auto* stmt : stmts) {
+            references.push_back(getReferencedRelations(*stmt));
+        }
+
+        // determine for each clear operation the statement after which its relation is not used anymore
+        std::vector<std::vector<const Statement*>> clearsAfter(stmts.size());
+        std::set<const Statement*> moved;
+        for (std::size_t i = 0; i < stmts.size(); i++) {
+            const auto* clear = as<Clear>(stmts[i]);
+            if (clear == nullptr) {
+                continue;
+            }
+            std::size_t last = i;
+            while (last > 0 && references[last - 1].count(clear->getRelation()) == 0) {
+                last--;
+            }
+            if (last > 0 && last < i) {
+                clearsAfter[last - 1].push_back(clear);
+                moved.insert(clear);
+            }
+        }
+        if (moved.empty()) {
+            continue;
+        }
+
+        VecOwn<Statement> result;
+        for (std::size_t i = 0; i < stmts.size(); i++) {
+            if (moved.count(stmts[i]) == 0) {
+                result.push_back(souffle::clone(stmts[i]));
+            }
+            for (const auto* clear : clearsAfter[i]) {
+                result.push_back(souffle::clone(clear));
+            }
+        }
+        replacements[sub.second] = mk<Sequence>(std::move(result));
+    }
+
+    if (replacements.empty()) {
+        return false;
+    }
+    program.apply(makeLambdaRamMapper([&](Own<Node> node) -> Own<Node> {
+        auto pos = replacements.find(node.get());
+        if (pos != replacements.end()) {
+            return std::move(pos->second);
+        }
+        return node;
+    }));
+    return true;
+}
+
+}  // namespace souffle::ram::transform
@@ -0,0 +1,81 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ExpireRelations.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Program.h"
+#include "ram/TranslationUnit.h"
+#include "ram/transform/Transformer.h"
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class ExpireRelationsTransformer
+ * @brief Clears expired relations directly after their last use
+ *
+ * The relations expiring in a stratum are cleared at the end of its
+ * subroutine. A relation read by the first query of a stratum only
+ * remains alive while all other queries and the output of the stratum
+ * are evaluated.
+ *
+ * For example ..
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    INSERT (t0.0) INTO C
+ *  QUERY
+ *   FOR t0 IN B
+ *    INSERT (t0.0) INTO C
+ *  IO C (operation="output")
+ *  CLEAR A
+ *  CLEAR B
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    INSERT (t0.0) INTO C
+ *  CLEAR A
+ *  QUERY
+ *   FOR t0 IN B
+ *    INSERT (t0.0) INTO C
+ *  CLEAR B
+ *  IO C (operation="output")
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ */
+class ExpireRelationsTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "ExpireRelationsTransformer";
+    }
+
+    /**
+     * @brief Move the clear operations of subroutines after the last use of their relations
+     * @param program Program that is transformed
+     * @return Flag showing whether the program has been changed by the transformation
+     */
+    bool expireRelations(Program& program);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        return expireRelations(translationUnit.getProgram());
+    }
+};
+
+}  // namespace souffle::ram::transform
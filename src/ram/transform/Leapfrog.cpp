@@ -0,0 +1,175 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Leapfrog.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/Leapfrog.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "ram/Condition.h"
+#include "ram/Expression.h"
+#include "ram/Filter.h"
+#include "ram/LeapfrogScan.h"
+#include "ram/Node.h"
+#include "ram/ParallelIndexScan.h"
+#include "ram/Query.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/Utils.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/utility/MiscUtil.h"
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+bool LeapfrogTransformer::isSorted(const Relation& rel) const {
+    // a partner has to bind at least one column besides the intersected one
+    if (rel.getArity() < 2 || rel.getAuxiliaryArity() > 0) {
+        return false;
+    }
+    switch (rel.getRepresentation()) {
+        case RelationRepresentation::BTREE: return true;
+        // the synthesiser stores default relations of a larger arity indirectly, which cannot seek
+        case RelationRepresentation::DEFAULT:
+            return !Global::config().has("hash-index") && rel.getArity() <= 6;
+        default: return false;
+    }
+}
+
+Own<ExistenceCheck> LeapfrogTransformer::makePartner(
+        const IndexScan& indexScan, std::size_t column, const Condition& condition) const {
+    const auto* exists = as<ExistenceCheck>(condition);
+    if (exists == nullptr) {
+        return nullptr;
+    }
+    const Relation& rel = relAnalysis->lookup(exists->getRelation());
+    if (!isSorted(rel)) {
+        return nullptr;
+    }
+
+    // the scanned tuple may only occur as the intersected column of the pattern
+    VecOwn<Expression> values;
+    std::optional<std::size_t> partnerColumn;
+    for (const Expression* value : exists->getValues()) {
+        if (isUndefValue(value)) {
+            return nullptr;
+        }
+        const auto* element = as<TupleElement>(value);
+        if (element != nullptr && element->getTupleId() == indexScan.getTupleId()) {
+            if (element->getElement() != column || partnerColumn.has_value()) {
+                return nullptr;
+            }
+            partnerColumn = values.size();
+            values.push_back(mk<UndefValue>());
+            continue;
+        }
+        bool dependent = false;
+        visit(*value, [&](const TupleElement& other) {
+            if (other.getTupleId() == indexScan.getTupleId()) {
+                dependent = true;
+            }
+        });
+        if (dependent) {
+            return nullptr;
+        }
+        values.push_back(souffle::clone(value));
+    }
+    if (!partnerColumn.has_value()) {
+        return nullptr;
+    }
+
+    // both columns have to be sorted alike, i.e. compared as the same kind of number
+    const Relation& scanned = relAnalysis->lookup(indexScan.getRelation());
+    if (scanned.getAttributeTypes()[column][0] != rel.getAttributeTypes()[*partnerColumn][0]) {
+        return nullptr;
+    }
+    return mk<ExistenceCheck>(exists->getRelation(), std::move(values));
+}
+
+Own<Operation> LeapfrogTransformer::rewriteIndexScan(const IndexScan* indexScan) {
+    const Relation& rel = relAnalysis->lookup(indexScan->getRelation());
+    if (!isSorted(rel)) {
+        return nullptr;
+    }
+
+    // the range has to be sorted by the only unbounded column, which is the
+    // case if all the other columns are bound to a single value
+    const auto pattern = indexScan->getRangePattern();
+    std::optional<std::size_t> column;
+    for (std::size_t i = 0; i < pattern.first.size(); ++i) {
+        if (isUndefValue(pattern.first[i]) && isUndefValue(pattern.second[i])) {
+            if (column.has_value()) {
+                return nullptr;
+            }
+            column = i;
+        } else if (isUndefValue(pattern.first[i]) || *pattern.first[i] != *pattern.second[i]) {
+            return nullptr;
+        }
+    }
+    if (!column.has_value()) {
+        return nullptr;
+    }
+
+    // the scan steps through the values of the column, which floats have no successor for
+    if (rel.getAttributeTypes()[*column][0] == 'f') {
+        return nullptr;
+    }
+
+    // the existence checks closing the cycle follow the scan in a filter
+    const auto* filter = as<Filter>(indexScan->getOperation());
+    if (filter == nullptr) {
+        return nullptr;
+    }
+    VecOwn<ExistenceCheck> partners;
+    VecOwn<Condition> remaining;
+    for (auto& condition : toConjunctionList(&filter->getCondition())) {
+        if (auto partner = makePartner(*indexScan, *column, *condition)) {
+            partners.push_back(std::move(partner));
+        } else {
+            remaining.push_back(std::move(condition));
+        }
+    }
+    if (partners.empty()) {
+        return nullptr;
+    }
+
+    Own<Operation> nested = souffle::clone(filter->getOperation());
+    if (!remaining.empty()) {
+        nested = mk<Filter>(toCondition(remaining), std::move(nested), filter->getProfileText());
+    }
+    return mk<LeapfrogScan>(indexScan->getRelation(), indexScan->getTupleId(), souffle::clone(pattern),
+            std::move(partners), std::move(nested), indexScan->getProfileText());
+}
+
+bool LeapfrogTransformer::convertIndexScans(Program& program) {
+    bool changed = false;
+    visit(program, [&](const Query& query) {
+        std::function<Own<Node>(Own<Node>)> scanRewriter = [&](Own<Node> node) -> Own<Node> {
+            const auto* indexScan = as<IndexScan>(node);
+            if (indexScan != nullptr && !isA<ParallelIndexScan>(indexScan)) {
+                if (Own<Operation> op = rewriteIndexScan(indexScan)) {
+                    changed = true;
+                    node = std::move(op);
+                }
+            }
+            node->apply(makeLambdaRamMapper(scanRewriter));
+            return node;
+        };
+        const_cast<Query*>(&query)->apply(makeLambdaRamMapper(scanRewriter));
+    });
+    return changed;
+}
+
+}  // namespace souffle::ram::transform
@@ -0,0 +1,106 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Leapfrog.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Condition.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/IndexScan.h"
+#include "ram/Operation.h"
+#include "ram/Program.h"
+#include "ram/Relation.h"
+#include "ram/TranslationUnit.h"
+#include "ram/analysis/Relation.h"
+#include "ram/transform/Transformer.h"
+#include <cstddef>
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class LeapfrogTransformer
+ * @brief Convert IndexScan operations closing a cyclic join to LeapfrogScan operations
+ *
+ * A join is cyclic if the last variable it binds is constrained by more
+ * than one atom together with variables bound earlier, e.g. z in the
+ * triangle A(x,y), B(y,z), C(x,z). The nested-loop plan scans all of B's
+ * z values for each (x,y) and probes C for each of them. If the index
+ * scan binds only z, and the probes are total existence checks with z
+ * as the only column depending on the scan, the probes are turned into
+ * partners of a leapfrog scan that intersects the sorted z values of all
+ * of them instead.
+ *
+ * For example,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    FOR t1 IN B ON INDEX t1.0 = t0.1
+ *     IF (t0.0,t1.1) ∈ C
+ *      ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   FOR t0 IN A
+ *    FOR t1 IN B ON INDEX t1.0 = t0.1 LEAPFROG WITH (t0.0,_) ∈ C
+ *     ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Leapfrogging relies on the relations being sorted and able to seek, so
+ * only B-tree relations stored directly take part in it.
+ */
+class LeapfrogTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "LeapfrogTransformer";
+    }
+
+    /**
+     * @brief Rewrite IndexScan operations
+     * @param indexScan An index operation
+     * @result Null if the scan cannot leapfrog; otherwise the leapfrog scan
+     */
+    Own<Operation> rewriteIndexScan(const IndexScan* indexScan);
+
+    /**
+     * @brief Apply the leapfrog conversion to the whole program
+     * @param program RAM program
+     * @result A flag indicating whether the RAM program has been changed.
+     */
+    bool convertIndexScans(Program& program);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        relAnalysis = translationUnit.getAnalysis<analysis::RelationAnalysis>();
+        return convertIndexScans(translationUnit.getProgram());
+    }
+
+    /** @brief Whether the tuples of a relation are sorted the way leapfrogging requires */
+    bool isSorted(const Relation& rel) const;
+
+    /**
+     * @brief Turn a condition into a partner of a leapfrog scan
+     * @result Null if the condition is not an existence check whose only
+     * column depending on the scan is the given column
+     */
+    Own<ExistenceCheck> makePartner(
+            const IndexScan& indexScan, std::size_t column, const Condition& condition) const;
+
+    analysis::RelationAnalysis* relAnalysis{nullptr};
+};
+
+}  // namespace souffle::ram::transform
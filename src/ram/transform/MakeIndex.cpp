@@ -19,10 +19,12 @@
 #include "ram/Constraint.h"
 #include "ram/Expression.h"
 #include "ram/Node.h"
+#include "ram/NumericConstant.h"
 #include "ram/Operation.h"
 #include "ram/Program.h"
 #include "ram/Relation.h"
 #include "ram/Statement.h"
+#include "ram/StringConstant.h"
 #include "ram/utility/Utils.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/BinaryConstraintOps.h"
@@ -91,7 +93,8 @@ ExpressionPair MakeIndexTransformer::getLowerUpperExpression(
         bool interpreter = !Global::config().has("compile") && !Global::config().has("dl-program") &&
                            !Global::config().has("generate") && !Global::config().has("swig");
         bool provenance = Global::config().has("provenance");
-        bool btree = (rep == RelationRepresentation::BTREE || rep == RelationRepresentation::DEFAULT);
+        bool btree = (rep == RelationRepresentation::BTREE || rep == RelationRepresentation::DEFAULT ||
+                      rep == RelationRepresentation::COMPRESSED);
         auto op = binRelOp->getOperator();
 
         // don't index FEQ in interpreter mode
@@ -110,6 +113,14 @@ ExpressionPair MakeIndexTransformer::getLowerUpperExpression(
         if (isIneqConstraint(op) && !btree) {
             return {mk<UndefValue>(), mk<UndefValue>()};
         }
+        // don't index comparisons with constants on column stores; the scan evaluates them per chunk
+        auto isConstant = [](const Expression& expr) {
+            return isA<NumericConstant>(expr) || isA<StringConstant>(expr);
+        };
+        if (rep == RelationRepresentation::COLUMNAR &&
+                (isConstant(binRelOp->getLHS()) || isConstant(binRelOp->getRHS()))) {
+            return {mk<UndefValue>(), mk<UndefValue>()};
+        }
 
         if (isEqConstraint(op)) {
             if (const auto* lhs = as<TupleElement>(binRelOp->getLHS())) {
@@ -0,0 +1,890 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Serialiser.cpp
+ *
+ * Implementation of the writer and reader of RAM programs.
+ *
+ ***********************************************************************/
+
+#include "ram/utility/Serialiser.h"
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "RelationTag.h"
+#include "ram/Aggregate.h"
+#include "ram/AutoIncrement.h"
+#include "ram/BloomFilterCheck.h"
+#include "ram/Break.h"
+#include "ram/BuildBloomFilter.h"
+#include "ram/Call.h"
+#include "ram/Choice.h"
+#include "ram/Clear.h"
+#include "ram/Condition.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/DebugInfo.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Exit.h"
+#include "ram/Expression.h"
+#include "ram/Extend.h"
+#include "ram/False.h"
+#include "ram/Filter.h"
+#include "ram/FloatConstant.h"
+#include "ram/GuardedInsert.h"
+#include "ram/IO.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexChoice.h"
+#include "ram/IndexOperation.h"
+#include "ram/IndexScan.h"
+#include "ram/Insert.h"
+#include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
+#include "ram/LogRelationTimer.h"
+#include "ram/LogSize.h"
+#include "ram/LogTimer.h"
+#include "ram/Loop.h"
+#include "ram/Negation.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/Node.h"
+#include "ram/Operation.h"
+#include "ram/PackRecord.h"
+#include "ram/Parallel.h"
+#include "ram/ParallelAggregate.h"
+#include "ram/ParallelChoice.h"
+#include "ram/ParallelIndexAggregate.h"
+#include "ram/ParallelIndexChoice.h"
+#include "ram/ParallelIndexScan.h"
+#include "ram/ParallelScan.h"
+#include "ram/Program.h"
+#include "ram/ProvenanceExistenceCheck.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/RelationSize.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/Statement.h"
+#include "ram/StringConstant.h"
+#include "ram/SubroutineArgument.h"
+#include "ram/SubroutineReturn.h"
+#include "ram/Swap.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/UnpackRecord.h"
+#include "ram/UnsignedConstant.h"
+#include "ram/UserDefinedOperator.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include "souffle/TypeAttribute.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+namespace {
+
+/**
+ * Writes the nodes of a RAM program
+ */
+class ProgramWriter : public Visitor<void> {
+public:
+    ProgramWriter(std::ostream& os) : os(os) {}
+
+    void writeProgram(const Program& program) {
+        const auto relations = program.getRelations();
+        writeNumber(relations.size());
+        for (const Relation* rel : relations) {
+            writeRelation(*rel);
+        }
+        const auto subroutines = program.getSubroutines();
+        writeNumber(subroutines.size());
+        for (const auto& [name, stmt] : subroutines) {
+            writeString(name);
+            dispatch(*stmt);
+        }
+        dispatch(program.getMain());
+    }
+
+protected:
+    // -- expressions --
+
+    void visit_(type_identity<TupleElement>, const TupleElement& elem) override {
+        writeTag("TupleElement");
+        writeNumber(elem.getTupleId());
+        writeNumber(elem.getElement());
+    }
+
+    void visit_(type_identity<SignedConstant>, const SignedConstant& constant) override {
+        writeTag("SignedConstant");
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<UnsignedConstant>, const UnsignedConstant& constant) override {
+        // the bits of the constant are written, to keep the value exactly
+        writeTag("UnsignedConstant");
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<FloatConstant>, const FloatConstant& constant) override {
+        writeTag("FloatConstant");
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<StringConstant>, const StringConstant& constant) override {
+        writeTag("StringConstant");
+        writeString(constant.getConstant());
+    }
+
+    void visit_(type_identity<IntrinsicOperator>, const IntrinsicOperator& op) override {
+        writeTag("IntrinsicOperator");
+        writeEnum(op.getOperator());
+        writeNodes(op.getArguments());
+    }
+
+    void visit_(type_identity<UserDefinedOperator>, const UserDefinedOperator& op) override {
+        writeTag("UserDefinedOperator");
+        writeString(op.getName());
+        writeNumber(op.getArgsTypes().size());
+        for (TypeAttribute type : op.getArgsTypes()) {
+            writeEnum(type);
+        }
+        writeEnum(op.getReturnType());
+        writeNumber(op.isStateful() ? 1 : 0);
+        writeNodes(op.getArguments());
+    }
+
+    void visit_(type_identity<AutoIncrement>, const AutoIncrement&) override {
+        writeTag("AutoIncrement");
+    }
+
+    void visit_(type_identity<PackRecord>, const PackRecord& pack) override {
+        writeTag("PackRecord");
+        writeNodes(pack.getArguments());
+    }
+
+    void visit_(type_identity<SubroutineArgument>, const SubroutineArgument& arg) override {
+        writeTag("SubroutineArgument");
+        writeNumber(arg.getArgument());
+    }
+
+    void visit_(type_identity<UndefValue>, const UndefValue&) override {
+        writeTag("UndefValue");
+    }
+
+    void visit_(type_identity<RelationSize>, const RelationSize& size) override {
+        writeTag("RelationSize");
+        writeString(size.getRelation());
+    }
+
+    // -- conditions --
+
+    void visit_(type_identity<True>, const True&) override {
+        writeTag("True");
+    }
+
+    void visit_(type_identity<False>, const False&) override {
+        writeTag("False");
+    }
+
+    void visit_(type_identity<EmptinessCheck>, const EmptinessCheck& emptiness) override {
+        writeTag("EmptinessCheck");
+        writeString(emptiness.getRelation());
+    }
+
+    void visit_(type_identity<ProvenanceExistenceCheck>, const ProvenanceExistenceCheck& exists) override {
+        writeTag("ProvenanceExistenceCheck");
+        writeString(exists.getRelation());
+        writeNodes(exists.getValues());
+    }
+
+    void visit_(type_identity<ExistenceCheck>, const ExistenceCheck& exists) override {
+        writeTag("ExistenceCheck");
+        writeString(exists.getRelation());
+        writeNodes(exists.getValues());
+    }
+
+    void visit_(type_identity<BloomFilterCheck>, const BloomFilterCheck& check) override {
+        writeTag("BloomFilterCheck");
+        writeString(check.getRelation());
+        writeNodes(check.getValues());
+    }
+
+    void visit_(type_identity<Conjunction>, const Conjunction& conj) override {
+        writeTag("Conjunction");
+        dispatch(conj.getLHS());
+        dispatch(conj.getRHS());
+    }
+
+    void visit_(type_identity<Negation>, const Negation& neg) override {
+        writeTag("Negation");
+        dispatch(neg.getOperand());
+    }
+
+    void visit_(type_identity<Constraint>, const Constraint& constraint) override {
+        writeTag("Constraint");
+        writeEnum(constraint.getOperator());
+        dispatch(constraint.getLHS());
+        dispatch(constraint.getRHS());
+    }
+
+    // -- operations --
+
+    void visit_(type_identity<Filter>, const Filter& filter) override {
+        writeTag("Filter");
+        writeString(filter.getProfileText());
+        dispatch(filter.getCondition());
+        dispatch(filter.getOperation());
+    }
+
+    void visit_(type_identity<Break>, const Break& breakOp) override {
+        writeTag("Break");
+        writeString(breakOp.getProfileText());
+        dispatch(breakOp.getCondition());
+        dispatch(breakOp.getOperation());
+    }
+
+    void visit_(type_identity<GuardedInsert>, const GuardedInsert& insert) override {
+        writeTag("GuardedInsert");
+        writeString(insert.getRelation());
+        writeNodes(insert.getValues());
+        dispatch(*insert.getCondition());
+    }
+
+    void visit_(type_identity<Insert>, const Insert& insert) override {
+        writeTag("Insert");
+        writeString(insert.getRelation());
+        writeNodes(insert.getValues());
+    }
+
+    void visit_(type_identity<SubroutineReturn>, const SubroutineReturn& ret) override {
+        writeTag("SubroutineReturn");
+        writeNodes(ret.getValues());
+    }
+
+    void visit_(type_identity<UnpackRecord>, const UnpackRecord& unpack) override {
+        writeTag("UnpackRecord");
+        writeNumber(unpack.getTupleId());
+        writeNumber(unpack.getArity());
+        dispatch(unpack.getExpression());
+        dispatch(unpack.getOperation());
+    }
+
+    void visit_(type_identity<NestedIntrinsicOperator>, const NestedIntrinsicOperator& op) override {
+        writeTag("NestedIntrinsicOperator");
+        writeEnum(op.getFunction());
+        writeNumber(op.getTupleId());
+        writeNodes(op.getArguments());
+        dispatch(op.getOperation());
+    }
+
+    void visit_(type_identity<ParallelScan>, const ParallelScan& scan) override {
+        writeTag("ParallelScan");
+        writeRelationOperation(scan);
+        dispatch(scan.getOperation());
+    }
+
+    void visit_(type_identity<Scan>, const Scan& scan) override {
+        writeTag("Scan");
+        writeRelationOperation(scan);
+        dispatch(scan.getOperation());
+    }
+
+    void visit_(type_identity<ParallelIndexScan>, const ParallelIndexScan& scan) override {
+        writeTag("ParallelIndexScan");
+        writeRelationOperation(scan);
+        writePattern(scan);
+        dispatch(scan.getOperation());
+    }
+
+    void visit_(type_identity<IndexScan>, const IndexScan& scan) override {
+        writeTag("IndexScan");
+        writeRelationOperation(scan);
+        writePattern(scan);
+        dispatch(scan.getOperation());
+    }
+
+    void visit_(type_identity<LeapfrogScan>, const LeapfrogScan& scan) override {
+        writeTag("LeapfrogScan");
+        writeRelationOperation(scan);
+        writePattern(scan);
+        writeNodes(scan.getPartners());
+        dispatch(scan.getOperation());
+    }
+
+    void visit_(type_identity<ParallelChoice>, const ParallelChoice& choice) override {
+        writeTag("ParallelChoice");
+        writeRelationOperation(choice);
+        dispatch(choice.getCondition());
+        dispatch(choice.getOperation());
+    }
+
+    void visit_(type_identity<Choice>, const Choice& choice) override {
+        writeTag("Choice");
+        writeRelationOperation(choice);
+        dispatch(choice.getCondition());
+        dispatch(choice.getOperation());
+    }
+
+    void visit_(type_identity<ParallelIndexChoice>, const ParallelIndexChoice& choice) override {
+        writeTag("ParallelIndexChoice");
+        writeRelationOperation(choice);
+        writePattern(choice);
+        dispatch(choice.getCondition());
+        dispatch(choice.getOperation());
+    }
+
+    void visit_(type_identity<IndexChoice>, const IndexChoice& choice) override {
+        writeTag("IndexChoice");
+        writeRelationOperation(choice);
+        writePattern(choice);
+        dispatch(choice.getCondition());
+        dispatch(choice.getOperation());
+    }
+
+    void visit_(type_identity<ParallelAggregate>, const ParallelAggregate& aggregate) override {
+        writeTag("ParallelAggregate");
+        writeAggregate(aggregate, aggregate);
+        dispatch(aggregate.getOperation());
+    }
+
+    void visit_(type_identity<Aggregate>, const Aggregate& aggregate) override {
+        writeTag("Aggregate");
+        writeAggregate(aggregate, aggregate);
+        dispatch(aggregate.getOperation());
+    }
+
+    void visit_(type_identity<ParallelIndexAggregate>, const ParallelIndexAggregate& aggregate) override {
+        writeTag("ParallelIndexAggregate");
+        writeAggregate(aggregate, aggregate);
+        writePattern(aggregate);
+        dispatch(aggregate.getOperation());
+    }
+
+    void visit_(type_identity<IndexAggregate>, const IndexAggregate& aggregate) override {
+        writeTag("IndexAggregate");
+        writeAggregate(aggregate, aggregate);
+        writePattern(aggregate);
+        dispatch(aggregate.getOperation());
+    }
+
+    // -- statements --
+
+    void visit_(type_identity<IO>, const IO& io) override {
+        writeTag("IO");
+        writeString(io.getRelation());
+        writeNumber(io.getDirectives().size());
+        for (const auto& [key, value] : io.getDirectives()) {
+            writeString(key);
+            writeString(value);
+        }
+    }
+
+    void visit_(type_identity<Query>, const Query& query) override {
+        writeTag("Query");
+        dispatch(query.getOperation());
+    }
+
+    void visit_(type_identity<Clear>, const Clear& clear) override {
+        writeTag("Clear");
+        writeString(clear.getRelation());
+    }
+
+    void visit_(type_identity<BuildBloomFilter>, const BuildBloomFilter& build) override {
+        writeTag("BuildBloomFilter");
+        writeString(build.getRelation());
+        writeNumber(build.getColumns().size());
+        for (std::size_t column : build.getColumns()) {
+            writeNumber(column);
+        }
+    }
+
+    void visit_(type_identity<LogSize>, const LogSize& size) override {
+        writeTag("LogSize");
+        writeString(size.getRelation());
+        writeString(size.getMessage());
+    }
+
+    void visit_(type_identity<Swap>, const Swap& swap) override {
+        writeTag("Swap");
+        writeString(swap.getFirstRelation());
+        writeString(swap.getSecondRelation());
+    }
+
+    void visit_(type_identity<Extend>, const Extend& extend) override {
+        writeTag("Extend");
+        writeString(extend.getTargetRelation());
+        writeString(extend.getSourceRelation());
+    }
+
+    void visit_(type_identity<Sequence>, const Sequence& seq) override {
+        writeTag("Sequence");
+        writeNodes(seq.getStatements());
+    }
+
+    void visit_(type_identity<Loop>, const Loop& loop) override {
+        writeTag("Loop");
+        dispatch(loop.getBody());
+    }
+
+    void visit_(type_identity<Parallel>, const Parallel& parallel) override {
+        writeTag("Parallel");
+        writeNodes(parallel.getStatements());
+    }
+
+    void visit_(type_identity<Exit>, const Exit& exit) override {
+        writeTag("Exit");
+        dispatch(exit.getCondition());
+    }
+
+    void visit_(type_identity<LogTimer>, const LogTimer& timer) override {
+        writeTag("LogTimer");
+        writeString(timer.getMessage());
+        dispatch(timer.getStatement());
+    }
+
+    void visit_(type_identity<LogRelationTimer>, const LogRelationTimer& timer) override {
+        writeTag("LogRelationTimer");
+        writeString(timer.getRelation());
+        writeString(timer.getMessage());
+        dispatch(timer.getStatement());
+    }
+
+    void visit_(type_identity<DebugInfo>, const DebugInfo& dbg) override {
+        writeTag("DebugInfo");
+        writeString(dbg.getMessage());
+        dispatch(dbg.getStatement());
+    }
+
+    void visit_(type_identity<Call>, const Call& call) override {
+        writeTag("Call");
+        writeString(call.getName());
+    }
+
+    void visit_(type_identity<Node>, const Node& node) override {
+        fatal("cannot write RAM node %s", toString(node));
+    }
+
+private:
+    void writeTag(const char* tag) {
+        os << tag << ' ';
+    }
+
+    template <typename T>
+    void writeNumber(T value) {
+        os << value << ' ';
+    }
+
+    template <typename E>
+    void writeEnum(E value) {
+        writeNumber(static_cast<int>(value));
+    }
+
+    void writeString(const std::string& str) {
+        os << str.size() << ':' << str << ' ';
+    }
+
+    template <typename T>
+    void writeNodes(const std::vector<T*>& nodes) {
+        writeNumber(nodes.size());
+        for (const T* node : nodes) {
+            dispatch(*node);
+        }
+    }
+
+    void writeRelation(const Relation& rel) {
+        writeString(rel.getName());
+        writeNumber(rel.getArity());
+        writeNumber(rel.getAuxiliaryArity());
+        for (std::size_t i = 0; i < rel.getArity(); i++) {
+            writeString(rel.getAttributeNames()[i]);
+            writeString(rel.getAttributeTypes()[i]);
+        }
+        writeEnum(rel.getRepresentation());
+    }
+
+    void writeRelationOperation(const RelationOperation& op) {
+        writeString(op.getRelation());
+        writeNumber(op.getTupleId());
+        writeString(op.getProfileText());
+    }
+
+    void writeAggregate(const RelationOperation& op, const AbstractAggregate& aggregate) {
+        writeString(op.getRelation());
+        writeNumber(op.getTupleId());
+        writeEnum(aggregate.getFunction());
+        dispatch(aggregate.getExpression());
+        dispatch(aggregate.getCondition());
+    }
+
+    void writePattern(const IndexOperation& op) {
+        const auto pattern = op.getRangePattern();
+        writeNodes(pattern.first);
+        writeNodes(pattern.second);
+    }
+
+    std::ostream& os;
+};
+
+/**
+ * Reads the nodes of a RAM program written by a ProgramWriter
+ */
+class ProgramReader {
+public:
+    ProgramReader(std::istream& is) : is(is) {}
+
+    Own<Program> readProgram() {
+        VecOwn<Relation> relations;
+        for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+            relations.push_back(readRelation());
+        }
+        std::map<std::string, Own<Statement>> subroutines;
+        for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+            std::string name = readString();
+            subroutines[name] = read<Statement>();
+        }
+        auto main = read<Statement>();
+        return mk<Program>(std::move(relations), std::move(main), std::move(subroutines));
+    }
+
+private:
+    /** Read a node of the given kind */
+    template <typename T>
+    Own<T> read() {
+        Own<Node> node = readNode();
+        if (!isA<T>(node)) {
+            throw std::invalid_argument("Unexpected RAM node " + toString(*node));
+        }
+        return Own<T>(static_cast<T*>(node.release()));
+    }
+
+    template <typename T>
+    VecOwn<T> readNodes() {
+        VecOwn<T> nodes;
+        for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+            nodes.push_back(read<T>());
+        }
+        return nodes;
+    }
+
+    Own<Node> readNode() {
+        std::string tag;
+        if (!(is >> tag)) {
+            throw std::invalid_argument("Truncated RAM program");
+        }
+
+        // -- expressions --
+        if (tag == "TupleElement") {
+            auto ident = readNumber<std::size_t>();
+            auto elem = readNumber<std::size_t>();
+            return mk<TupleElement>(ident, elem);
+        } else if (tag == "SignedConstant") {
+            return mk<SignedConstant>(readNumber<RamDomain>());
+        } else if (tag == "UnsignedConstant") {
+            return mk<UnsignedConstant>(ramBitCast<RamUnsigned>(readNumber<RamDomain>()));
+        } else if (tag == "FloatConstant") {
+            return mk<FloatConstant>(ramBitCast<RamFloat>(readNumber<RamDomain>()));
+        } else if (tag == "StringConstant") {
+            return mk<StringConstant>(readString());
+        } else if (tag == "IntrinsicOperator") {
+            auto op = readEnum<FunctorOp>();
+            return mk<IntrinsicOperator>(op, readNodes<Expression>());
+        } else if (tag == "UserDefinedOperator") {
+            std::string name = readString();
+            std::vector<TypeAttribute> argsTypes;
+            for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+                argsTypes.push_back(readEnum<TypeAttribute>());
+            }
+            auto returnType = readEnum<TypeAttribute>();
+            bool stateful = readNumber<int>() != 0;
+            auto args = readNodes<Expression>();
+            return mk<UserDefinedOperator>(name, argsTypes, returnType, stateful, std::move(args));
+        } else if (tag == "AutoIncrement") {
+            return mk<AutoIncrement>();
+        } else if (tag == "PackRecord") {
+            return mk<PackRecord>(readNodes<Expression>());
+        } else if (tag == "SubroutineArgument") {
+            return mk<SubroutineArgument>(readNumber<std::size_t>());
+        } else if (tag == "UndefValue") {
+            return mk<UndefValue>();
+        } else if (tag == "RelationSize") {
+            return mk<RelationSize>(readString());
+        }
+
+        // -- conditions --
+        if (tag == "True") {
+            return mk<True>();
+        } else if (tag == "False") {
+            return mk<False>();
+        } else if (tag == "EmptinessCheck") {
+            return mk<EmptinessCheck>(readString());
+        } else if (tag == "ProvenanceExistenceCheck") {
+            std::string rel = readString();
+            return mk<ProvenanceExistenceCheck>(rel, readNodes<Expression>());
+        } else if (tag == "ExistenceCheck") {
+            std::string rel = readString();
+            return mk<ExistenceCheck>(rel, readNodes<Expression>());
+        } else if (tag == "BloomFilterCheck") {
+            std::string rel = readString();
+            return mk<BloomFilterCheck>(rel, readNodes<Expression>());
+        } else if (tag == "Conjunction") {
+            auto lhs = read<Condition>();
+            auto rhs = read<Condition>();
+            return mk<Conjunction>(std::move(lhs), std::move(rhs));
+        } else if (tag == "Negation") {
+            return mk<Negation>(read<Condition>());
+        } else if (tag == "Constraint") {
+            auto op = readEnum<BinaryConstraintOp>();
+            auto lhs = read<Expression>();
+            auto rhs = read<Expression>();
+            return mk<Constraint>(op, std::move(lhs), std::move(rhs));
+        }
+
+        // -- operations --
+        if (tag == "Filter" || tag == "Break") {
+            std::string profileText = readString();
+            auto cond = read<Condition>();
+            auto nested = read<Operation>();
+            if (tag == "Filter") {
+                return mk<Filter>(std::move(cond), std::move(nested), profileText);
+            }
+            return mk<Break>(std::move(cond), std::move(nested), profileText);
+        } else if (tag == "GuardedInsert") {
+            std::string rel = readString();
+            auto values = readNodes<Expression>();
+            auto cond = read<Condition>();
+            return mk<GuardedInsert>(rel, std::move(values), std::move(cond));
+        } else if (tag == "Insert") {
+            std::string rel = readString();
+            return mk<Insert>(rel, readNodes<Expression>());
+        } else if (tag == "SubroutineReturn") {
+            return mk<SubroutineReturn>(readNodes<Expression>());
+        } else if (tag == "UnpackRecord") {
+            auto ident = readNumber<int>();
+            auto arity = readNumber<std::size_t>();
+            auto expr = read<Expression>();
+            auto nested = read<Operation>();
+            return mk<UnpackRecord>(std::move(nested), ident, std::move(expr), arity);
+        } else if (tag == "NestedIntrinsicOperator") {
+            auto op = readEnum<NestedIntrinsicOp>();
+            auto ident = readNumber<int>();
+            auto args = readNodes<Expression>();
+            auto nested = read<Operation>();
+            return mk<NestedIntrinsicOperator>(op, std::move(args), std::move(nested), ident);
+        } else if (tag == "ParallelScan" || tag == "Scan") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            std::string profileText = readString();
+            auto nested = read<Operation>();
+            if (tag == "ParallelScan") {
+                return mk<ParallelScan>(rel, ident, std::move(nested), profileText);
+            }
+            return mk<Scan>(rel, ident, std::move(nested), profileText);
+        } else if (tag == "ParallelIndexScan" || tag == "IndexScan") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            std::string profileText = readString();
+            auto pattern = readPattern();
+            auto nested = read<Operation>();
+            if (tag == "ParallelIndexScan") {
+                return mk<ParallelIndexScan>(rel, ident, std::move(pattern), std::move(nested), profileText);
+            }
+            return mk<IndexScan>(rel, ident, std::move(pattern), std::move(nested), profileText);
+        } else if (tag == "LeapfrogScan") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            std::string profileText = readString();
+            auto pattern = readPattern();
+            auto partners = readNodes<ExistenceCheck>();
+            auto nested = read<Operation>();
+            return mk<LeapfrogScan>(
+                    rel, ident, std::move(pattern), std::move(partners), std::move(nested), profileText);
+        } else if (tag == "ParallelChoice" || tag == "Choice") {
+            std::string rel = readString();
+            auto ident = readNumber<std::size_t>();
+            std::string profileText = readString();
+            auto cond = read<Condition>();
+            auto nested = read<Operation>();
+            if (tag == "ParallelChoice") {
+                return mk<ParallelChoice>(rel, ident, std::move(cond), std::move(nested), profileText);
+            }
+            return mk<Choice>(rel, ident, std::move(cond), std::move(nested), profileText);
+        } else if (tag == "ParallelIndexChoice" || tag == "IndexChoice") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            std::string profileText = readString();
+            auto pattern = readPattern();
+            auto cond = read<Condition>();
+            auto nested = read<Operation>();
+            if (tag == "ParallelIndexChoice") {
+                return mk<ParallelIndexChoice>(
+                        rel, ident, std::move(cond), std::move(pattern), std::move(nested), profileText);
+            }
+            return mk<IndexChoice>(
+                    rel, ident, std::move(cond), std::move(pattern), std::move(nested), profileText);
+        } else if (tag == "ParallelAggregate" || tag == "Aggregate") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            auto fun = readEnum<AggregateOp>();
+            auto expr = read<Expression>();
+            auto cond = read<Condition>();
+            auto nested = read<Operation>();
+            if (tag == "ParallelAggregate") {
+                return mk<ParallelAggregate>(
+                        std::move(nested), fun, rel, std::move(expr), std::move(cond), ident);
+            }
+            return mk<Aggregate>(std::move(nested), fun, rel, std::move(expr), std::move(cond), ident);
+        } else if (tag == "ParallelIndexAggregate" || tag == "IndexAggregate") {
+            std::string rel = readString();
+            auto ident = readNumber<int>();
+            auto fun = readEnum<AggregateOp>();
+            auto expr = read<Expression>();
+            auto cond = read<Condition>();
+            auto pattern = readPattern();
+            auto nested = read<Operation>();
+            if (tag == "ParallelIndexAggregate") {
+                return mk<ParallelIndexAggregate>(std::move(nested), fun, rel, std::move(expr),
+                        std::move(cond), std::move(pattern), ident);
+            }
+            return mk<IndexAggregate>(std::move(nested), fun, rel, std::move(expr), std::move(cond),
+                    std::move(pattern), ident);
+        }
+
+        // -- statements --
+        if (tag == "IO") {
+            std::string rel = readString();
+            std::map<std::string, std::string> directives;
+            for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+                std::string key = readString();
+                directives[key] = readString();
+            }
+            return mk<IO>(rel, std::move(directives));
+        } else if (tag == "Query") {
+            return mk<Query>(read<Operation>());
+        } else if (tag == "Clear") {
+            return mk<Clear>(readString());
+        } else if (tag == "BuildBloomFilter") {
+            std::string rel = readString();
+            std::vector<std::size_t> columns;
+            for (std::size_t n = readNumber<std::size_t>(); n > 0; n--) {
+                columns.push_back(readNumber<std::size_t>());
+            }
+            return mk<BuildBloomFilter>(rel, std::move(columns));
+        } else if (tag == "LogSize") {
+            std::string rel = readString();
+            std::string message = readString();
+            return mk<LogSize>(rel, message);
+        } else if (tag == "Swap") {
+            std::string first = readString();
+            std::string second = readString();
+            return mk<Swap>(first, second);
+        } else if (tag == "Extend") {
+            std::string target = readString();
+            std::string source = readString();
+            return mk<Extend>(target, source);
+        } else if (tag == "Sequence") {
+            return mk<Sequence>(readNodes<Statement>());
+        } else if (tag == "Loop") {
+            return mk<Loop>(read<Statement>());
+        } else if (tag == "Parallel") {
+            return mk<Parallel>(readNodes<Statement>());
+        } else if (tag == "Exit") {
+            return mk<Exit>(read<Condition>());
+        } else if (tag == "LogTimer") {
+            std::string message = readString();
+            return mk<LogTimer>(read<Statement>(), message);
+        } else if (tag == "LogRelationTimer") {
+            std::string rel = readString();
+            std::string message = readString();
+            return mk<LogRelationTimer>(read<Statement>(), message, rel);
+        } else if (tag == "DebugInfo") {
+            std::string message = readString();
+            return mk<DebugInfo>(read<Statement>(), message);
+        } else if (tag == "Call") {
+            return mk<Call>(readString());
+        }
+
+        throw std::invalid_argument("Unknown RAM node " + tag);
+    }
+
+    Own<Relation> readRelation() {
+        std::string name = readString();
+        auto arity = readNumber<std::size_t>();
+        auto auxiliaryArity = readNumber<std::size_t>();
+        std::vector<std::string> attributeNames;
+        std::vector<std::string> attributeTypes;
+        for (std::size_t i = 0; i < arity; i++) {
+            attributeNames.push_back(readString());
+            attributeTypes.push_back(readString());
+        }
+        auto representation = readEnum<RelationRepresentation>();
+        return mk<Relation>(name, arity, auxiliaryArity, std::move(attributeNames), std::move(attributeTypes),
+                representation);
+    }
+
+    RamPattern readPattern() {
+        RamPattern pattern;
+        pattern.first = readNodes<Expression>();
+        pattern.second = readNodes<Expression>();
+        if (pattern.first.size() != pattern.second.size()) {
+            throw std::invalid_argument("Mismatching bounds of RAM index operation");
+        }
+        return pattern;
+    }
+
+    template <typename T>
+    T readNumber() {
+        T value;
+        if (!(is >> value)) {
+            throw std::invalid_argument("Malformed number in RAM program");
+        }
+        return value;
+    }
+
+    template <typename E>
+    E readEnum() {
+        return static_cast<E>(readNumber<int>());
+    }
+
+    std::string readString() {
+        auto length = readNumber<std::size_t>();
+        if (is.get() != ':') {
+            throw std::invalid_argument("Malformed string in RAM program");
+        }
+        std::string str(length, '\0');
+        if (!is.read(&str[0], length)) {
+            throw std::invalid_argument("Truncated string in RAM program");
+        }
+        return str;
+    }
+
+    std::istream& is;
+};
+
+}  // namespace
+
+void writeProgram(std::ostream& os, const Program& program) {
+    ProgramWriter(os).writeProgram(program);
+}
+
+Own<Program> readProgram(std::istream& is) {
+    return ProgramReader(is).readProgram();
+}
+
+}  // namespace souffle::ram
@@ -0,0 +1,41 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Serialiser.h
+ *
+ * Writes RAM programs to streams and reads them back.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Program.h"
+#include "souffle/utility/ContainerUtil.h"
+#include <iosfwd>
+
+namespace souffle::ram {
+
+/**
+ * @brief Write a RAM program to a stream
+ *
+ * Nodes are written in prefix order as their kind followed by their
+ * attributes, strings are prefixed by their length. The program read back
+ * by readProgram is equal to the written program.
+ */
+void writeProgram(std::ostream& os, const Program& program);
+
+/**
+ * @brief Read a RAM program that was written by writeProgram
+ *
+ * Throws std::invalid_argument if the stream does not hold a RAM program.
+ */
+Own<Program> readProgram(std::istream& is);
+
+}  // namespace souffle::ram
@@ -23,7 +23,9 @@
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
 #include "ram/BinRelationStatement.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Break.h"
+#include "ram/BuildBloomFilter.h"
 #include "ram/Call.h"
 #include "ram/Choice.h"
 #include "ram/Clear.h"
@@ -47,6 +49,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/ListStatement.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
@@ -133,6 +136,7 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(EmptinessCheck);
         SOUFFLE_VISITOR_FORWARD(ProvenanceExistenceCheck);
         SOUFFLE_VISITOR_FORWARD(ExistenceCheck);
+        SOUFFLE_VISITOR_FORWARD(BloomFilterCheck);
         SOUFFLE_VISITOR_FORWARD(Conjunction);
         SOUFFLE_VISITOR_FORWARD(Negation);
         SOUFFLE_VISITOR_FORWARD(Constraint);
@@ -149,6 +153,7 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(Scan);
         SOUFFLE_VISITOR_FORWARD(ParallelIndexScan);
         SOUFFLE_VISITOR_FORWARD(IndexScan);
+        SOUFFLE_VISITOR_FORWARD(LeapfrogScan);
         SOUFFLE_VISITOR_FORWARD(ParallelChoice);
         SOUFFLE_VISITOR_FORWARD(Choice);
         SOUFFLE_VISITOR_FORWARD(ParallelIndexChoice);
@@ -162,6 +167,7 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(IO);
         SOUFFLE_VISITOR_FORWARD(Query);
         SOUFFLE_VISITOR_FORWARD(Clear);
+        SOUFFLE_VISITOR_FORWARD(BuildBloomFilter);
         SOUFFLE_VISITOR_FORWARD(LogSize);
 
         SOUFFLE_VISITOR_FORWARD(Swap);
@@ -187,6 +193,7 @@ protected:
     SOUFFLE_VISITOR_LINK(IO, RelationStatement);
     SOUFFLE_VISITOR_LINK(Query, Statement);
     SOUFFLE_VISITOR_LINK(Clear, RelationStatement);
+    SOUFFLE_VISITOR_LINK(BuildBloomFilter, RelationStatement);
     SOUFFLE_VISITOR_LINK(LogSize, RelationStatement);
 
     SOUFFLE_VISITOR_LINK(RelationStatement, Statement);
@@ -217,6 +224,7 @@ protected:
     SOUFFLE_VISITOR_LINK(ParallelScan, Scan);
     SOUFFLE_VISITOR_LINK(IndexScan, IndexOperation);
     SOUFFLE_VISITOR_LINK(ParallelIndexScan, IndexScan);
+    SOUFFLE_VISITOR_LINK(LeapfrogScan, IndexOperation);
     SOUFFLE_VISITOR_LINK(Choice, RelationOperation);
     SOUFFLE_VISITOR_LINK(ParallelChoice, Choice);
     SOUFFLE_VISITOR_LINK(IndexChoice, IndexOperation);
@@ -241,6 +249,7 @@ protected:
     SOUFFLE_VISITOR_LINK(Conjunction, Condition);
     SOUFFLE_VISITOR_LINK(Negation, Condition);
     SOUFFLE_VISITOR_LINK(Constraint, Condition);
+    SOUFFLE_VISITOR_LINK(BloomFilterCheck, Condition);
     SOUFFLE_VISITOR_LINK(ProvenanceExistenceCheck, AbstractExistenceCheck);
     SOUFFLE_VISITOR_LINK(ExistenceCheck, AbstractExistenceCheck);
     SOUFFLE_VISITOR_LINK(EmptinessCheck, Condition);
@@ -43,8 +43,9 @@ std::string Relation::getTypeAttributeString(const std::vector<std::string>& att
     return type.str();
 }
 
-Own<Relation> Relation::getSynthesiserRelation(
-        const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance) {
+Own<Relation> Relation::getSynthesiserRelation(const ram::Relation& ramRel,
+        const ram::analysis::IndexCluster& indexSelection, RelationRepresentation representation,
+        bool isProvenance) {
     Relation* rel;
 
     // Handle the qualifier in souffle code
@@ -52,13 +53,19 @@ Own<Relation> Relation::getSynthesiserRelation(
         rel = new DirectRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.isNullary()) {
         rel = new NullaryRelation(ramRel, indexSelection, isProvenance);
-    } else if (ramRel.getRepresentation() == RelationRepresentation::BTREE) {
+    } else if (representation == RelationRepresentation::BTREE) {
         rel = new DirectRelation(ramRel, indexSelection, isProvenance);
-    } else if (ramRel.getRepresentation() == RelationRepresentation::BRIE) {
+    } else if (representation == RelationRepresentation::BRIE) {
         rel = new BrieRelation(ramRel, indexSelection, isProvenance);
-    } else if (ramRel.getRepresentation() == RelationRepresentation::EQREL) {
+    } else if (representation == RelationRepresentation::EQREL) {
         rel = new EqrelRelation(ramRel, indexSelection, isProvenance);
-    } else if (ramRel.getRepresentation() == RelationRepresentation::INFO) {
+    } else if (representation == RelationRepresentation::HASHSET) {
+        rel = new HashsetRelation(ramRel, indexSelection, isProvenance);
+    } else if (representation == RelationRepresentation::COLUMNAR) {
+        rel = new ColumnarRelation(ramRel, indexSelection, isProvenance);
+    } else if (representation == RelationRepresentation::COMPRESSED) {
+        rel = new DirectRelation(ramRel, indexSelection, isProvenance, true);
+    } else if (representation == RelationRepresentation::INFO) {
         rel = new InfoRelation(ramRel, indexSelection, isProvenance);
     } else {
         // Handle the data structure command line flag
@@ -172,7 +179,8 @@ std::string DirectRelation::getTypeName() {
     }
 
     std::stringstream res;
-    res << "t_btree_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+    res << (isCompressed ? "t_compressed_" : "t_btree_")
+        << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
 
     for (auto& ind : getIndices()) {
         res << "__" << join(ind, "_");
@@ -307,11 +315,13 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
                    "souffle::detail::default_strategy<t_tuple>::type,"
                 << comparator_aux << ",updater_" << getTypeName() << ">;\n";
         } else {
+            std::string prefix = isCompressed ? "compressed_" : "";
             if (ind.size() == arity) {
-                out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator << ">;\n";
+                out << "using t_ind_" << i << " = " << prefix << "btree_set<t_tuple," << comparator << ">;\n";
             } else {
                 // without provenance, some indices may be not full, so we use btree_multiset for those
-                out << "using t_ind_" << i << " = btree_multiset<t_tuple," << comparator << ">;\n";
+                out << "using t_ind_" << i << " = " << prefix << "btree_multiset<t_tuple," << comparator
+                    << ">;\n";
             }
         }
         out << "t_ind_" << i << " ind_" << i << ";\n";
@@ -369,6 +379,32 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
     out << "return insert(data);\n";
     out << "}\n";  // end of insert(RamDomain x1, RamDomain x2, ...)
 
+    // batch insert method, which inserts the tuples in the order of each index
+    if (supportsBatchInsert()) {
+        auto sortBatch = [&](std::size_t i, const std::string& end) {
+            out << "std::sort(batch.begin(), " << end << ", [](const t_tuple& a, const t_tuple& b) {\n";
+            out << "return t_comparator_" << i << "().less(a, b);\n";
+            out << "});\n";
+        };
+        out << "void insertBatch(std::vector<t_tuple>& batch, context& h) {\n";
+        sortBatch(masterIndex, "batch.end()");
+        out << "std::size_t fresh = 0;\n";
+        out << "for (const auto& t : batch) {\n";
+        out << "if (ind_" << masterIndex << ".insert(t, h.hints_" << masterIndex << "_lower)) {\n";
+        out << "batch[fresh++] = t;\n";
+        out << "}\n";
+        out << "}\n";
+        for (std::size_t i = 0; i < numIndexes; i++) {
+            if (i != masterIndex) {
+                sortBatch(i, "batch.begin() + fresh");
+                out << "for (std::size_t i = 0; i < fresh; ++i) {\n";
+                out << "ind_" << i << ".insert(batch[i], h.hints_" << i << "_lower);\n";
+                out << "}\n";
+            }
+        }
+        out << "}\n";  // end of insertBatch(std::vector<t_tuple>&, context&)
+    }
+
     // contains methods
     out << "bool contains(const t_tuple& t, context& h) const {\n";
     out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex << "_lower"
@@ -458,6 +494,47 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
         out << "}\n";
     }
 
+    // prefetch methods warming up the paths of a batch of probes
+    if (supportsPrefetch()) {
+        out << "void prefetch(const t_tuple* keys, std::size_t count) const {\n";
+        out << "ind_" << masterIndex << ".prefetch(keys, count);\n";
+        out << "}\n";
+
+        for (auto search : indexSelection.getSearches()) {
+            std::size_t indNum = indexToNumMap[indexSelection.getLexOrder(search)];
+            out << "void prefetch_" << search << "(const t_tuple* keys, std::size_t count) const {\n";
+            out << "ind_" << indNum << ".prefetch(keys, count);\n";
+            out << "}\n";
+        }
+    }
+
+    // seek methods for the searches of leapfrog scans, which bind all columns but one
+    if (supportsSeek()) {
+        for (auto search : indexSelection.getSearches()) {
+            std::size_t unbound = 0;
+            for (std::size_t column = 0; column < arity; column++) {
+                if (search[column] == analysis::AttributeConstraint::None) {
+                    unbound++;
+                } else if (search[column] != analysis::AttributeConstraint::Equal) {
+                    unbound = arity;
+                }
+            }
+            if (unbound != 1) {
+                continue;
+            }
+            std::size_t indNum = indexToNumMap[indexSelection.getLexOrder(search)];
+            out << "const t_tuple* seek_" << search;
+            out << "(const t_tuple& lower, const t_tuple& upper, context& h) const {\n";
+            out << "auto pos = ind_" << indNum << ".lower_bound(lower, h.hints_" << indNum << "_lower);\n";
+            out << "if (pos == ind_" << indNum << ".end() || t_comparator_" << indNum
+                << "()(*pos, upper) > 0) {\n";
+            out << "    return nullptr;\n";
+            out << "}\n";
+            out << "return &*pos;\n";
+            out << "}\n";
+        }
+    }
+
     // empty method
     out << "bool empty() const {\n";
     out << "return ind_" << masterIndex << ".empty();\n";
@@ -498,8 +575,8 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
     // printStatistics method
     out << "void printStatistics(std::ostream& o) const {\n";
     for (std::size_t i = 0; i < numIndexes; i++) {
-        out << "o << \" arity " << arity << " direct b-tree index " << i << " lex-order " << inds[i]
-            << "\\n\";\n";
+        out << "o << \" arity " << arity << " direct " << (isCompressed ? "compressed " : "")
+            << "b-tree index " << i << " lex-order " << inds[i] << "\\n\";\n";
         out << "ind_" << i << ".printStats(o);\n";
     }
     out << "}\n";
@@ -1138,6 +1215,333 @@ void BrieRelation::generateTypeStruct(std::ostream& out) {
     out << "};\n";
 }
 
+// -------- Hashset Relation --------
+
+/** Generate index set for a hashset relation */
+void HashsetRelation::computeIndices() {
+    assert(!isProvenance && "hashsets cannot be used with provenance");
+
+    // a hashset is only selected if all searches are full, hence a single full index suffices
+    auto inds = indexSelection.getAllOrders();
+    assert(inds.size() == 1 && inds[0].size() == getArity() && "hashset requires a single full index");
+    masterIndex = 0;
+
+    computedIndices = inds;
+}
+
+/** Generate type name of a hashset relation */
+std::string HashsetRelation::getTypeName() {
+    // elements are hashed and compared as a whole, i.e., all attributes are used
+    std::unordered_set<uint32_t> attributesUsed;
+    for (std::size_t i = 0; i < getArity(); i++) {
+        attributesUsed.insert(i);
+    }
+
+    std::stringstream res;
+    res << "t_hashset_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+    return res.str();
+}
+
+/** Generate type struct of a hashset relation */
+void HashsetRelation::generateTypeStruct(std::ostream& out) {
+    std::size_t arity = getArity();
+
+    // struct definition
+    out << "struct " << getTypeName() << " {\n";
+    out << "static constexpr Relation::arity_type Arity = " << arity << ";\n";
+
+    // stored tuple type
+    out << "using t_tuple = Tuple<RamDomain, " << arity << ">;\n";
+    out << "using t_ind_" << masterIndex << " = HashSet<t_tuple>;\n";
+    out << "t_ind_" << masterIndex << " ind_" << masterIndex << ";\n";
+    out << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
+
+    // hash sets do not require hints, the context is kept for a uniform interface
+    out << "struct context {\n";
+    out << "t_ind_" << masterIndex << "::operation_hints hints_" << masterIndex << ";\n";
+    out << "};\n";
+    out << "context createContext() { return context(); }\n";
+
+    // insert methods
+    out << "bool insert(const t_tuple& t) {\n";
+    out << "return ind_" << masterIndex << ".insert(t);\n";
+    out << "}\n";
+
+    out << "bool insert(const t_tuple& t, context& h) {\n";
+    out << "return ind_" << masterIndex << ".insert(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "bool insert(const RamDomain* ramDomain) {\n";
+    out << "RamDomain data[" << arity << "];\n";
+    out << "std::copy(ramDomain, ramDomain + " << arity << ", data);\n";
+    out << "const t_tuple& tuple = reinterpret_cast<const t_tuple&>(data);\n";
+    out << "return insert(tuple);\n";
+    out << "}\n";
+
+    std::vector<std::string> decls;
+    std::vector<std::string> params;
+    for (std::size_t i = 0; i < arity; i++) {
+        decls.push_back("RamDomain a" + std::to_string(i));
+        params.push_back("a" + std::to_string(i));
+    }
+    out << "bool insert(" << join(decls, ",") << ") {\n";
+    out << "RamDomain data[" << arity << "] = {" << join(params, ",") << "};\n";
+    out << "return insert(data);\n";
+    out << "}\n";
+
+    // contains methods
+    out << "bool contains(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "bool contains(const t_tuple& t) const {\n";
+    out << "return ind_" << masterIndex << ".contains(t);\n";
+    out << "}\n";
+
+    // size method
+    out << "std::size_t size() const {\n";
+    out << "return ind_" << masterIndex << ".size();\n";
+    out << "}\n";
+
+    // find methods
+    out << "iterator find(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".find(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "iterator find(const t_tuple& t) const {\n";
+    out << "return ind_" << masterIndex << ".find(t);\n";
+    out << "}\n";
+
+    // empty lowerUpperRange method
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    // lowerUpperRange method for the full search, the only search served by a hashset
+    auto search = SearchSignature::getFullSearchSignature(arity);
+    out << "range<iterator> lowerUpperRange_" << search;
+    out << "(const t_tuple& lower, const t_tuple& /* upper */, context& h) const {\n";
+    out << "auto pos = ind_" << masterIndex << ".find(lower, h.hints_" << masterIndex << ");\n";
+    out << "auto fin = ind_" << masterIndex << ".end();\n";
+    out << "if (pos != fin) {fin = pos; ++fin;}\n";
+    out << "return make_range(pos, fin);\n";
+    out << "}\n";
+
+    out << "range<iterator> lowerUpperRange_" << search;
+    out << "(const t_tuple& lower, const t_tuple& upper) const {\n";
+    out << "context h;\n";
+    out << "return lowerUpperRange_" << search << "(lower,upper,h);\n";
+    out << "}\n";
+
+    // empty method
+    out << "bool empty() const {\n";
+    out << "return ind_" << masterIndex << ".empty();\n";
+    out << "}\n";
+
+    // partition method for parallelism
+    out << "std::vector<range<iterator>> partition() const {\n";
+    out << "return ind_" << masterIndex << ".partition(400);\n";
+    out << "}\n";
+
+    // purge method
+    out << "void purge() {\n";
+    out << "ind_" << masterIndex << ".clear();\n";
+    out << "}\n";
+
+    // begin and end iterators
+    out << "iterator begin() const {\n";
+    out << "return ind_" << masterIndex << ".begin();\n";
+    out << "}\n";
+
+    out << "iterator end() const {\n";
+    out << "return ind_" << masterIndex << ".end();\n";
+    out << "}\n";
+
+    // printStatistics method
+    out << "void printStatistics(std::ostream& o) const {\n";
+    out << "o << \" arity " << arity << " hashset index\\n\";\n";
+    out << "ind_" << masterIndex << ".printStats(o);\n";
+    out << "}\n";
+
+    // end struct
+    out << "};\n";
+}
+
+// -------- Columnar Relation --------
+
+/** Generate index set for a columnar relation */
+void ColumnarRelation::computeIndices() {
+    assert(!isProvenance && "column stores cannot be used with provenance");
+
+    // a column store is only selected if all searches are full, hence a single full index suffices
+    auto inds = indexSelection.getAllOrders();
+    assert(inds.size() == 1 && inds[0].size() == getArity() && "column store requires a single full index");
+    masterIndex = 0;
+
+    computedIndices = inds;
+}
+
+/** Generate type name of a columnar relation */
+std::string ColumnarRelation::getTypeName() {
+    // tuples are stored column by column, i.e., all attributes are used
+    std::unordered_set<uint32_t> attributesUsed;
+    for (std::size_t i = 0; i < getArity(); i++) {
+        attributesUsed.insert(i);
+    }
+
+    std::stringstream res;
+    res << "t_columnar_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+    return res.str();
+}
+
+/** Generate type struct of a columnar relation */
+void ColumnarRelation::generateTypeStruct(std::ostream& out) {
+    std::size_t arity = getArity();
+
+    // struct definition
+    out << "struct " << getTypeName() << " {\n";
+    out << "static constexpr Relation::arity_type Arity = " << arity << ";\n";
+
+    // stored tuple type
+    out << "using t_tuple = Tuple<RamDomain, " << arity << ">;\n";
+    out << "using t_ind_" << masterIndex << " = ColumnStore<" << arity << ">;\n";
+    out << "t_ind_" << masterIndex << " ind_" << masterIndex << ";\n";
+    out << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
+
+    // column stores do not require hints, the context is kept for a uniform interface
+    out << "struct context {\n";
+    out << "t_ind_" << masterIndex << "::operation_hints hints_" << masterIndex << ";\n";
+    out << "};\n";
+    out << "context createContext() { return context(); }\n";
+
+    // insert methods
+    out << "bool insert(const t_tuple& t) {\n";
+    out << "return ind_" << masterIndex << ".insert(t);\n";
+    out << "}\n";
+
+    out << "bool insert(const t_tuple& t, context& h) {\n";
+    out << "return ind_" << masterIndex << ".insert(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "bool insert(const RamDomain* ramDomain) {\n";
+    out << "RamDomain data[" << arity << "];\n";
+    out << "std::copy(ramDomain, ramDomain + " << arity << ", data);\n";
+    out << "const t_tuple& tuple = reinterpret_cast<const t_tuple&>(data);\n";
+    out << "return insert(tuple);\n";
+    out << "}\n";
+
+    std::vector<std::string> decls;
+    std::vector<std::string> params;
+    for (std::size_t i = 0; i < arity; i++) {
+        decls.push_back("RamDomain a" + std::to_string(i));
+        params.push_back("a" + std::to_string(i));
+    }
+    out << "bool insert(" << join(decls, ",") << ") {\n";
+    out << "RamDomain data[" << arity << "] = {" << join(params, ",") << "};\n";
+    out << "return insert(data);\n";
+    out << "}\n";
+
+    // contains methods
+    out << "bool contains(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "bool contains(const t_tuple& t) const {\n";
+    out << "return ind_" << masterIndex << ".contains(t);\n";
+    out << "}\n";
+
+    // size method
+    out << "std::size_t size() const {\n";
+    out << "return ind_" << masterIndex << ".size();\n";
+    out << "}\n";
+
+    // find methods
+    out << "iterator find(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".find(t, h.hints_" << masterIndex << ");\n";
+    out << "}\n";
+
+    out << "iterator find(const t_tuple& t) const {\n";
+    out << "return ind_" << masterIndex << ".find(t);\n";
+    out << "}\n";
+
+    // empty lowerUpperRange method
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    // lowerUpperRange method for the full search, served by the hash table of the column store
+    auto search = SearchSignature::getFullSearchSignature(arity);
+    out << "range<iterator> lowerUpperRange_" << search;
+    out << "(const t_tuple& lower, const t_tuple& /* upper */, context& h) const {\n";
+    out << "auto pos = ind_" << masterIndex << ".find(lower, h.hints_" << masterIndex << ");\n";
+    out << "auto fin = ind_" << masterIndex << ".end();\n";
+    out << "if (pos != fin) {fin = pos; ++fin;}\n";
+    out << "return make_range(pos, fin);\n";
+    out << "}\n";
+
+    out << "range<iterator> lowerUpperRange_" << search;
+    out << "(const t_tuple& lower, const t_tuple& upper) const {\n";
+    out << "context h;\n";
+    out << "return lowerUpperRange_" << search << "(lower,upper,h);\n";
+    out << "}\n";
+
+    // empty method
+    out << "bool empty() const {\n";
+    out << "return ind_" << masterIndex << ".empty();\n";
+    out << "}\n";
+
+    // partition method for parallelism
+    out << "std::vector<range<iterator>> partition() const {\n";
+    out << "return ind_" << masterIndex << ".partition(400);\n";
+    out << "}\n";
+
+    // filtered scans skipping chunks by their zone maps
+    out << "range<t_ind_" << masterIndex << "::filter_iterator> filter(const t_ind_" << masterIndex
+        << "::predicates& preds) const {\n";
+    out << "return ind_" << masterIndex << ".filter(preds);\n";
+    out << "}\n";
+
+    out << "std::vector<range<t_ind_" << masterIndex << "::filter_iterator>> partition(const t_ind_"
+        << masterIndex << "::predicates& preds) const {\n";
+    out << "return ind_" << masterIndex << ".partition(preds, 400);\n";
+    out << "}\n";
+
+    // purge method
+    out << "void purge() {\n";
+    out << "ind_" << masterIndex << ".clear();\n";
+    out << "}\n";
+
+    // begin and end iterators
+    out << "iterator begin() const {\n";
+    out << "return ind_" << masterIndex << ".begin();\n";
+    out << "}\n";
+
+    out << "iterator end() const {\n";
+    out << "return ind_" << masterIndex << ".end();\n";
+    out << "}\n";
+
+    // printStatistics method
+    out << "void printStatistics(std::ostream& o) const {\n";
+    out << "o << \" arity " << arity << " columnar index\\n\";\n";
+    out << "ind_" << masterIndex << ".printStats(o);\n";
+    out << "}\n";
+
+    // end struct
+    out << "};\n";
+}
+
 // -------- Eqrel Relation --------
 
 /** Generate index set for a eqrel relation */
@@ -68,9 +68,25 @@ public:
     /** Generate relation type struct */
     virtual void generateTypeStruct(std::ostream& out) = 0;
 
+    /** Whether the type struct has prefetch methods for batches of probes */
+    virtual bool supportsPrefetch() const {
+        return false;
+    }
+
+    /** Whether the type struct can insert a batch of tuples */
+    virtual bool supportsBatchInsert() const {
+        return false;
+    }
+
+    /** Whether the type struct can seek the first tuple within bounds for leapfrog scans */
+    virtual bool supportsSeek() const {
+        return false;
+    }
+
     /** Factory method to generate a SynthesiserRelation */
     static Own<Relation> getSynthesiserRelation(const ram::Relation& ramRel,
-            const ram::analysis::IndexCluster& indexSelection, bool isProvenance);
+            const ram::analysis::IndexCluster& indexSelection, RelationRepresentation representation,
+            bool isProvenance);
 
 protected:
     /** Ram relation referred to by this */
@@ -119,13 +135,29 @@ public:
 
 class DirectRelation : public Relation {
 public:
-    DirectRelation(
-            const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance)
-            : Relation(ramRel, indexSelection, isProvenance) {}
+    DirectRelation(const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection,
+            bool isProvenance, bool isCompressed = false)
+            : Relation(ramRel, indexSelection, isProvenance), isCompressed(isCompressed) {}
 
     void computeIndices() override;
     std::string getTypeName() override;
     void generateTypeStruct(std::ostream& out) override;
+
+    bool supportsPrefetch() const override {
+        return !isCompressed;
+    }
+
+    bool supportsBatchInsert() const override {
+        return !isProvenance;
+    }
+
+    bool supportsSeek() const override {
+        return !isCompressed && !isProvenance;
+    }
+
+protected:
+    /** Whether the indexes are compressed B-trees */
+    const bool isCompressed;
 };
 
 class IndirectRelation : public Relation {
@@ -150,6 +182,28 @@ public:
     void generateTypeStruct(std::ostream& out) override;
 };
 
+class HashsetRelation : public Relation {
+public:
+    HashsetRelation(
+            const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance)
+            : Relation(ramRel, indexSelection, isProvenance) {}
+
+    void computeIndices() override;
+    std::string getTypeName() override;
+    void generateTypeStruct(std::ostream& out) override;
+};
+
+class ColumnarRelation : public Relation {
+public:
+    ColumnarRelation(
+            const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance)
+            : Relation(ramRel, indexSelection, isProvenance) {}
+
+    void computeIndices() override;
+    std::string getTypeName() override;
+    void generateTypeStruct(std::ostream& out) override;
+};
+
 class EqrelRelation : public Relation {
 public:
     EqrelRelation(
@@ -19,10 +19,13 @@
 #include "FunctorOps.h"
 #include "Global.h"
 #include "RelationTag.h"
+#include "ram/AbstractExistenceCheck.h"
 #include "ram/AbstractParallel.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
+#include "ram/BloomFilterCheck.h"
 #include "ram/Break.h"
+#include "ram/BuildBloomFilter.h"
 #include "ram/Call.h"
 #include "ram/Choice.h"
 #include "ram/Clear.h"
@@ -44,6 +47,7 @@
 #include "ram/IndexScan.h"
 #include "ram/Insert.h"
 #include "ram/IntrinsicOperator.h"
+#include "ram/LeapfrogScan.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
 #include "ram/LogTimer.h"
@@ -52,6 +56,7 @@
 #include "ram/NestedIntrinsicOperator.h"
 #include "ram/NestedOperation.h"
 #include "ram/Node.h"
+#include "ram/NumericConstant.h"
 #include "ram/Operation.h"
 #include "ram/PackRecord.h"
 #include "ram/Parallel.h"
@@ -71,6 +76,7 @@
 #include "ram/Sequence.h"
 #include "ram/SignedConstant.h"
 #include "ram/Statement.h"
+#include "ram/StringConstant.h"
 #include "ram/SubroutineArgument.h"
 #include "ram/SubroutineReturn.h"
 #include "ram/Swap.h"
@@ -88,6 +94,7 @@
 #include "souffle/BinaryConstraintOps.h"
 #include "souffle/RamTypes.h"
 #include "souffle/TypeAttribute.h"
+#include "souffle/datastructure/ColumnStore.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/FileUtil.h"
 #include "souffle/utility/MiscUtil.h"
@@ -99,11 +106,16 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <numeric>
+#include <set>
 #include <sstream>
 #include <tuple>
 #include <type_traits>
@@ -118,6 +130,9 @@ using ram::analysis::IndexAnalysis;
 using namespace ram;
 using namespace stream_write_qualified_char_as_number;
 
+/** Number of tuples of a scan whose probes are prefetched together */
+constexpr std::size_t PROBE_GROUP_SIZE = 16;
+
 /** Lookup frequency counter */
 unsigned Synthesiser::lookupFreqIdx(const std::string& txt) {
     static unsigned ctr;
@@ -189,6 +204,17 @@ const std::string Synthesiser::getOpContextName(const ram::Relation& rel) {
     return getRelationName(rel) + "_op_ctxt";
 }
 
+/** Get insert buffer name */
+const std::string Synthesiser::getInsertBufferName(const ram::Relation& rel) {
+    return getRelationName(rel) + "_insert_buffer";
+}
+
+/** Get Bloom filter name */
+const std::string Synthesiser::getBloomFilterName(
+        const ram::Relation& rel, const std::vector<std::size_t>& columns) {
+    return "bloom_" + convertRamIdent(rel.getName()) + "_" + toString(join(columns, "_"));
+}
+
 /** Get relation type struct */
 void Synthesiser::generateRelationTypeStruct(std::ostream& out, Own<Relation> relationType) {
     // If this type has been generated already, use the cached version
@@ -197,8 +223,38 @@ void Synthesiser::generateRelationTypeStruct(std::ostream& out, Own<Relation> re
     }
     typeCache.insert(relationType->getTypeName());
 
-    // Generate the type struct for the relation
-    relationType->generateTypeStruct(out);
+    if (!Global::config().has("type-cache")) {
+        // Generate the type struct for the relation
+        relationType->generateTypeStruct(out);
+        return;
+    }
+
+    // Generate the type struct into a header of the type cache that is addressed by its content,
+    // so that it is shared by all programs with a relation of the same shape
+    std::stringstream typeStruct;
+    relationType->generateTypeStruct(typeStruct);
+    const std::string code = typeStruct.str();
+    std::uint64_t hash = 14695981039346656037ull;  // FNV-1a
+    for (char c : code) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    std::stringstream fileName;
+    fileName << absPath(Global::config().get("type-cache")) << "/" << relationType->getTypeName() << "_"
+             << std::hex << hash << ".h";
+    if (!existFile(fileName.str())) {
+        // write to a temporary file first, as other compilations may use the same cache
+        const std::string tmpName = fileName.str() + "." + std::to_string(getpid());
+        {
+            std::ofstream header(tmpName);
+            header << "#pragma once\n";
+            header << "#include \"souffle/CompiledSouffle.h\"\n";
+            header << "namespace souffle {\n";
+            header << code;
+            header << "}  // namespace souffle\n";
+        }
+        std::rename(tmpName.c_str(), fileName.str().c_str());
+    }
+    out << "#include \"" << fileName.str() << "\"\n";
 }
 
 /** Get referenced relations */
@@ -220,6 +276,17 @@ std::set<const ram::Relation*> Synthesiser::getReferencedRelations(const Operati
     return res;
 }
 
+Relation& Synthesiser::getSynthesiserRelation(const ram::Relation& rel) {
+    auto& relationType = synthesiserRelations[rel.getName()];
+    if (!relationType) {
+        auto* idxAnalysis = translationUnit.getAnalysis<IndexAnalysis>();
+        bool isProvInfo = rel.getRepresentation() == RelationRepresentation::INFO;
+        relationType = Relation::getSynthesiserRelation(rel, idxAnalysis->getIndexSelection(rel.getName()),
+                idxAnalysis->getRepresentation(rel), Global::config().has("provenance") && !isProvInfo);
+    }
+    return *relationType;
+}
+
 void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
     class CodeEmitter : public ram::Visitor<void, Node const, std::ostream&> {
     private:
@@ -246,6 +313,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         std::ostringstream preamble;
         bool preambleIssued = false;
 
+        /** Relations whose insertions are collected in a buffer of each thread */
+        std::set<std::string> bufferedRelations;
+
     public:
         CodeEmitter(Synthesiser& syn) : synthesiser(syn) {
             rec = [&](auto& out, const auto* value) {
@@ -262,6 +332,170 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             };
         }
 
+        /**
+         * Obtains the comparisons of the scanned tuple with constants within a filter directly
+         * nested in a scan of a column store, formatted as a list of column predicates. The list
+         * is empty if the relation is not a column store or there are no such comparisons.
+         */
+        std::vector<std::string> getColumnPredicates(const RelationOperation& scan) {
+            std::vector<std::string> res;
+            const auto* filter = as<Filter>(scan.getOperation());
+            if (filter == nullptr || isa->getRepresentation(*synthesiser.lookup(scan.getRelation())) !=
+                                             RelationRepresentation::COLUMNAR) {
+                return res;
+            }
+
+            auto getConstant = [&](const Expression& expr, RamDomain& value) {
+                if (const auto* num = as<NumericConstant>(expr)) {
+                    value = num->getConstant();
+                    return true;
+                }
+                if (const auto* str = as<StringConstant>(expr)) {
+                    value = static_cast<RamDomain>(synthesiser.convertSymbol2Idx(str->getConstant()));
+                    return true;
+                }
+                return false;
+            };
+
+            for (const auto& cond : toConjunctionList(&filter->getCondition())) {
+                const auto* constraint = as<Constraint>(cond);
+                if (constraint == nullptr) {
+                    continue;
+                }
+                BinaryConstraintOp op = constraint->getOperator();
+                const Expression* lhs = &constraint->getLHS();
+                const Expression* rhs = &constraint->getRHS();
+                if (!isA<TupleElement>(lhs)) {
+                    std::swap(lhs, rhs);
+                    if (!isColumnPredicateOp(op)) {
+                        continue;
+                    }
+                    op = swappedConstraintOp(op);
+                }
+                const auto* element = as<TupleElement>(lhs);
+                RamDomain value;
+                if (element == nullptr || element->getTupleId() != scan.getTupleId() ||
+                        !isColumnPredicateOp(op) || !getConstant(*rhs, value)) {
+                    continue;
+                }
+                std::stringstream pred;
+                pred << "{" << element->getElement() << ", static_cast<BinaryConstraintOp>("
+                     << static_cast<int>(op) << "), RamDomain(" << value << ")}";
+                res.push_back(pred.str());
+            }
+            return res;
+        }
+
+        /**
+         * Obtains the existence checks within a filter directly nested in a scan whose keys only
+         * depend on the scanned tuple, and whose relations can prefetch a batch of probes. The
+         * list is empty if the nested operation contains a break, which has to leave the scan.
+         */
+        std::vector<const ExistenceCheck*> getProbes(const TupleOperation& scan) {
+            std::vector<const ExistenceCheck*> res;
+            const auto* filter = as<Filter>(scan.getOperation());
+            if (filter == nullptr) {
+                return res;
+            }
+            bool hasBreak = false;
+            visit(*filter, [&](const Break&) { hasBreak = true; });
+            if (hasBreak) {
+                return res;
+            }
+
+            std::function<void(const Condition&)> collect = [&](const Condition& cond) {
+                if (const auto* conj = as<Conjunction>(cond)) {
+                    collect(conj->getLHS());
+                    collect(conj->getRHS());
+                    return;
+                }
+                const auto* neg = as<Negation>(cond);
+                const auto* exists = as<ExistenceCheck>(neg != nullptr ? neg->getOperand() : cond);
+                if (exists == nullptr ||
+                        !synthesiser.getSynthesiserRelation(*synthesiser.lookup(exists->getRelation()))
+                                 .supportsPrefetch()) {
+                    return;
+                }
+                bool local = all_of(exists->getValues(), [&](const Expression* value) {
+                    const auto* element = as<TupleElement>(value);
+                    return isUndefValue(value) || isA<NumericConstant>(value) ||
+                           (element != nullptr && element->getTupleId() == scan.getTupleId());
+                });
+                if (local) {
+                    res.push_back(exists);
+                }
+            };
+            collect(filter->getCondition());
+            return res;
+        }
+
+        /**
+         * Emits the loop of a scan over the given range. If the scan has probes, the tuples are
+         * taken in groups, and the paths of the probes of a group are prefetched before the
+         * nested operation is executed for each tuple of the group.
+         */
+        void emitScanLoop(const TupleOperation& scan, const std::string& range, std::ostream& out) {
+            auto id = std::to_string(scan.getTupleId());
+            auto probes = getProbes(scan);
+            if (probes.empty()) {
+                out << "for(const auto& env" << id << " : " << range << ") {\n";
+                visit_(type_identity<TupleOperation>(), scan, out);
+                out << "}\n";
+                return;
+            }
+
+            out << "{\n";
+            out << "auto pos" << id << " = (" << range << ").begin();\n";
+            out << "auto end" << id << " = (" << range << ").end();\n";
+            out << "std::decay_t<decltype(*pos" << id << ")> group" << id << "[" << PROBE_GROUP_SIZE
+                << "];\n";
+            out << "while (pos" << id << " != end" << id << ") {\n";
+            out << "std::size_t size" << id << " = 0;\n";
+            out << "for (; pos" << id << " != end" << id << " && size" << id << " < " << PROBE_GROUP_SIZE
+                << "; ++pos" << id << ") {\n";
+            out << "group" << id << "[size" << id << "++] = *pos" << id << ";\n";
+            out << "}\n";
+
+            for (std::size_t i = 0; i < probes.size(); i++) {
+                const auto* exists = probes[i];
+                const auto* rel = synthesiser.lookup(exists->getRelation());
+                auto relName = synthesiser.getRelationName(rel);
+                auto keys = "keys" + id + "_" + std::to_string(i);
+
+                // total checks look up the master index, partial checks the lower bound of a range
+                std::string key;
+                std::string method = "prefetch";
+                if (isa->isTotalSignature(exists)) {
+                    std::stringstream tuple;
+                    tuple << "Tuple<RamDomain," << rel->getArity() << ">{{"
+                          << join(exists->getValues(), ",", rec) << "}}";
+                    key = tuple.str();
+                } else {
+                    auto values = exists->getValues();
+                    key = getPaddedRangeBounds(*rel, values, values).first.str();
+                    method += "_" + toString(isa->getSearchSignature(exists));
+                }
+
+                out << "{\n";
+                out << "Tuple<RamDomain," << rel->getArity() << "> " << keys << "[" << PROBE_GROUP_SIZE
+                    << "];\n";
+                out << "for (std::size_t i = 0; i < size" << id << "; ++i) {\n";
+                out << "const auto& env" << id << " = group" << id << "[i];\n";
+                out << keys << "[i] = " << key << ";\n";
+                out << "}\n";
+                out << relName << "->" << method << "(" << keys << ", size" << id << ");\n";
+                out << "}\n";
+            }
+
+            out << "for (std::size_t i" << id << " = 0; i" << id << " < size" << id << "; ++i" << id
+                << ") {\n";
+            out << "const auto& env" << id << " = group" << id << "[i" << id << "];\n";
+            visit_(type_identity<TupleOperation>(), scan, out);
+            out << "}\n";
+            out << "}\n";
+            out << "}\n";
+        }
+
         std::pair<std::stringstream, std::stringstream> getPaddedRangeBounds(const ram::Relation& rel,
                 const std::vector<Expression*>& rangePatternLower,
                 const std::vector<Expression*>& rangePatternUpper) {
@@ -342,10 +576,16 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             const auto& directives = io.getDirectives();
             const std::string& op = io.get("operation");
-            out << "if (performIO) {\n";
+            // embedded facts are part of the program and are loaded without performing IO
+            out << (io.get("IO") == "facts" ? "{\n" : "if (performIO) {\n");
+            if (Global::config().has("profile")) {
+                out << "TraceSpan span(R\"_(@io;" << io.getRelation() << ";" << op << ")_\");\n";
+            }
 
             // get some table details
             if (op == "input") {
+                out << "writers.wait(" << synthesiser.getRelationName(synthesiser.lookup(io.getRelation()))
+                    << ".get());\n";
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 printDirectives(directives);
@@ -353,6 +593,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 out << R"_(if (!inputDirectory.empty()) {)_";
                 out << R"_(directiveMap["fact-dir"] = inputDirectory;)_";
                 out << "}\n";
+                out << R"_(directiveMap["jobs"] = std::to_string(writers.getNumThreads());)_";
                 out << "IOSystem::getInstance().getReader(";
                 out << "directiveMap, symTable, recordTable";
                 out << ")->readAll(*" << synthesiser.getRelationName(synthesiser.lookup(io.getRelation()));
@@ -361,18 +602,22 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                        "<< "
                        "'\\n';}\n";
             } else if (op == "output" || op == "printsize") {
-                out << "try {";
+                // the relation is written while evaluation continues, until it is modified again
+                const std::string relName = synthesiser.getRelationName(synthesiser.lookup(io.getRelation()));
                 out << "std::map<std::string, std::string> directiveMap(";
                 printDirectives(directives);
                 out << ");\n";
                 out << R"_(if (!outputDirectory.empty()) {)_";
                 out << R"_(directiveMap["output-dir"] = outputDirectory;)_";
                 out << "}\n";
+                out << R"_(directiveMap["jobs"] = std::to_string(writers.getNumThreads());)_";
+                out << "auto* relation = " << relName << ".get();\n";
+                out << "writers.write(relation, directiveMap, "
+                       "[this, directiveMap, relation](bool concurrent) {";
                 out << "IOSystem::getInstance().getWriter(";
                 out << "directiveMap, symTable, recordTable";
-                out << ")->writeAll(*" << synthesiser.getRelationName(synthesiser.lookup(io.getRelation()))
-                    << ");\n";
-                out << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+                out << ")->writeAll(*relation, concurrent);\n";
+                out << "});\n";
             } else {
                 assert("Wrong i/o operation");
             }
@@ -426,6 +671,14 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             preamble.clear();
             preambleIssued = false;
 
+            // record the spans of the query and of the share of each thread in a parallel loop
+            if (Global::config().has("profile")) {
+                out << "TraceSpan span(\"@query\");\n";
+                if (isParallel) {
+                    preamble << "TraceSpan threadSpan(\"@parallel\");\n";
+                }
+            }
+
             // create operation contexts for this operation
             for (const ram::Relation* rel : synthesiser.getReferencedRelations(query.getOperation())) {
                 preamble << "CREATE_OP_CONTEXT(" << synthesiser.getOpContextName(*rel);
@@ -433,6 +686,37 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 preamble << "->createContext());\n";
             }
 
+            // each thread collects the tuples inserted into relations the query does not read
+            bufferedRelations.clear();
+            if (isParallel) {
+                std::set<std::string> reads;
+                std::set<const ram::Relation*> inserts;
+                visit(*next, [&](const Node& node) {
+                    if (const auto* op = as<RelationOperation>(node)) {
+                        reads.insert(op->getRelation());
+                    } else if (const auto* exists = as<AbstractExistenceCheck>(node)) {
+                        reads.insert(exists->getRelation());
+                    } else if (const auto* emptiness = as<EmptinessCheck>(node)) {
+                        reads.insert(emptiness->getRelation());
+                    } else if (const auto* size = as<RelationSize>(node)) {
+                        reads.insert(size->getRelation());
+                    } else if (const auto* insert = as<Insert>(node)) {
+                        inserts.insert(synthesiser.lookup(insert->getRelation()));
+                    }
+                });
+                for (const ram::Relation* rel : inserts) {
+                    auto& relationType = synthesiser.getSynthesiserRelation(*rel);
+                    if (reads.count(rel->getName()) > 0 || !relationType.supportsBatchInsert()) {
+                        continue;
+                    }
+                    bufferedRelations.insert(rel->getName());
+                    preamble << "InsertBuffer<" << relationType.getTypeName() << "> "
+                             << synthesiser.getInsertBufferName(*rel) << "(*"
+                             << synthesiser.getRelationName(*rel) << ", READ_OP_CONTEXT("
+                             << synthesiser.getOpContextName(*rel) << "));\n";
+                }
+            }
+
             // discharge conditions that require a context
             if (isParallel) {
                 if (requireCtx.size() > 0) {
@@ -474,11 +758,37 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         void visit_(type_identity<Clear>, const Clear& clear, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
 
-            if (!synthesiser.lookup(clear.getRelation())->isTemp()) {
+            const auto* rel = synthesiser.lookup(clear.getRelation());
+            const std::string relName = synthesiser.getRelationName(rel);
+            if (!rel->isTemp()) {
+                // the relation may still be written
+                out << "writers.wait(" << relName << ".get());\n";
                 out << "if (performIO) ";
             }
-            out << synthesiser.getRelationName(synthesiser.lookup(clear.getRelation())) << "->"
+            out << "{\n";
+            out << "clearedMemory += " << relName << "->size() * " << rel->getArity()
+                << " * sizeof(RamDomain);\n";
+            out << relName << "->"
                 << "purge();\n";
+            out << "}\n";
+
+            PRINT_END_COMMENT(out);
+        }
+
+        void visit_(
+                type_identity<BuildBloomFilter>, const BuildBloomFilter& build, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+
+            const auto* rel = synthesiser.lookup(build.getRelation());
+            const std::string relName = synthesiser.getRelationName(rel);
+            const std::string filterName = synthesiser.getBloomFilterName(*rel, build.getColumns());
+            out << filterName << ".reset(" << relName << "->size());\n";
+            out << "for (const auto& env : *" << relName << ") {\n";
+            auto printElement = [](auto& os, std::size_t column) { os << "env[" << column << "]"; };
+            out << filterName << ".insert(souffle::BloomFilter::hash(std::array<RamDomain,"
+                << build.getColumns().size() << ">{{" << join(build.getColumns(), ",", printElement)
+                << "}}));\n";
+            out << "}\n";
 
             PRINT_END_COMMENT(out);
         }
@@ -539,6 +849,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
             out << "iter = 0;\n";
             out << "for(;;) {\n";
+            if (Global::config().has("profile")) {
+                out << "TraceSpan span(\"@iteration;iteration \" + std::to_string(iter));\n";
+            }
             dispatch(loop.getBody(), out);
             out << "iter++;\n";
             out << "}\n";
@@ -553,12 +866,24 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             const std::string& newKnowledge =
                     synthesiser.getRelationName(synthesiser.lookup(swap.getSecondRelation()));
 
+            for (const auto& rel : {swap.getFirstRelation(), swap.getSecondRelation()}) {
+                if (!synthesiser.lookup(rel)->isTemp()) {
+                    out << "writers.wait(" << synthesiser.getRelationName(synthesiser.lookup(rel))
+                        << ".get());\n";
+                }
+            }
             out << "std::swap(" << deltaKnowledge << ", " << newKnowledge << ");\n";
             PRINT_END_COMMENT(out);
         }
 
         void visit_(type_identity<Extend>, const Extend& extend, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
+            for (const auto& rel : {extend.getSourceRelation(), extend.getTargetRelation()}) {
+                if (!synthesiser.lookup(rel)->isTemp()) {
+                    out << "writers.wait(" << synthesiser.getRelationName(synthesiser.lookup(rel))
+                        << ".get());\n";
+                }
+            }
             out << synthesiser.getRelationName(synthesiser.lookup(extend.getSourceRelation())) << "->"
                 << "extend("
                 << "*" << synthesiser.getRelationName(synthesiser.lookup(extend.getTargetRelation()))
@@ -580,7 +905,19 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             const auto& subs = prog.getSubroutines();
             out << "{\n";
             out << " std::vector<RamDomain> args, ret;\n";
+            if (Global::config().has("profile")) {
+                out << "TraceSpan span(R\"_(@stratum;" << call.getName() << ")_\");\n";
+            }
             out << "subroutine_" << distance(subs.begin(), subs.find(call.getName())) << "(args, ret);\n";
+            // hand the memory of cleared relations back to the operating system once enough has accumulated
+            bool clears = false;
+            visit(*subs.at(call.getName()), [&](const Clear&) { clears = true; });
+            if (clears) {
+                out << "if (clearedMemory >= MEMORY_RELEASE_THRESHOLD) {\n";
+                out << "releaseFreeMemory();\n";
+                out << "clearedMemory = 0;\n";
+                out << "}\n";
+            }
             out << "}\n";
             PRINT_END_COMMENT(out);
         }
@@ -664,16 +1001,22 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             PRINT_BEGIN_COMMENT(out);
 
-            out << "auto part = " << relName << "->partition();\n";
+            // column stores skip the chunks ruled out by comparisons with constants
+            auto preds = getColumnPredicates(pscan);
+            if (!preds.empty()) {
+                out << "static const ColumnStore<" << rel->getArity() << ">::predicates preds0 = {"
+                    << join(preds, ",") << "};\n";
+                out << "auto part = " << relName << "->partition(preds0);\n";
+            } else {
+                out << "auto part = " << relName << "->partition();\n";
+            }
             out << "PARALLEL_START\n";
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end();++it){\n";
             out << "try{\n";
-            out << "for(const auto& env0 : *it) {\n";
 
-            visit_(type_identity<TupleOperation>(), pscan, out);
+            emitScanLoop(pscan, "*it", out);
 
-            out << "}\n";
             out << "} catch(std::exception &e) { signalHandler->error(e.what());}\n";
             out << "}\n";
 
@@ -689,12 +1032,19 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             assert(rel->getArity() > 0 && "AstToRamTranslator failed/no scans for nullaries");
 
-            out << "for(const auto& env" << id << " : "
-                << "*" << relName << ") {\n";
-
-            visit_(type_identity<TupleOperation>(), scan, out);
-
-            out << "}\n";
+            // column stores skip the chunks ruled out by comparisons with constants
+            auto preds = getColumnPredicates(scan);
+            if (!preds.empty()) {
+                out << "{\n";
+                out << "static const ColumnStore<" << rel->getArity() << ">::predicates preds" << id << " = {"
+                    << join(preds, ",") << "};\n";
+                out << "for(const auto& env" << id << " : " << relName << "->filter(preds" << id << ")) {\n";
+                visit_(type_identity<TupleOperation>(), scan, out);
+                out << "}\n";
+                out << "}\n";
+            } else {
+                emitScanLoop(scan, "*" + relName, out);
+            }
 
             PRINT_END_COMMENT(out);
         }
@@ -765,7 +1115,6 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         void visit_(type_identity<IndexScan>, const IndexScan& iscan, std::ostream& out) override {
             const auto* rel = synthesiser.lookup(iscan.getRelation());
             auto relName = synthesiser.getRelationName(rel);
-            auto identifier = iscan.getTupleId();
             auto keys = isa->getSearchSignature(&iscan);
             auto arity = rel->getArity();
 
@@ -781,10 +1130,71 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             out << "auto range = " << relName << "->"
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << "," << ctxName << ");\n";
-            out << "for(const auto& env" << identifier << " : range) {\n";
+            emitScanLoop(iscan, "range", out);
+
+            PRINT_END_COMMENT(out);
+        }
 
-            visit_(type_identity<TupleOperation>(), iscan, out);
+        void visit_(type_identity<LeapfrogScan>, const LeapfrogScan& lscan, std::ostream& out) override {
+            const auto* rel = synthesiser.lookup(lscan.getRelation());
+            auto relName = synthesiser.getRelationName(rel);
+            auto keys = isa->getSearchSignature(&lscan);
+            auto id = std::to_string(lscan.getTupleId());
+            auto column = lscan.getColumn();
+            const auto partners = lscan.getPartners();
+
+            assert(synthesiser.getSynthesiserRelation(*rel).supportsSeek() && "leapfrog scan cannot seek");
+
+            PRINT_BEGIN_COMMENT(out);
+            auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*rel) + ")";
+            auto rangeBounds =
+                    getPaddedRangeBounds(*rel, lscan.getRangePattern().first, lscan.getRangePattern().second);
+            out << "{\n";
+            out << "auto lower" << id << " = " << rangeBounds.first.str() << ";\n";
+            out << "auto upper" << id << " = " << rangeBounds.second.str() << ";\n";
+            for (std::size_t i = 0; i < partners.size(); i++) {
+                const auto* partnerRel = synthesiser.lookup(partners[i]->getRelation());
+                auto partnerBounds =
+                        getPaddedRangeBounds(*partnerRel, partners[i]->getValues(), partners[i]->getValues());
+                out << "auto lower" << id << "_" << i << " = " << partnerBounds.first.str() << ";\n";
+                out << "auto upper" << id << "_" << i << " = " << partnerBounds.second.str() << ";\n";
+            }
 
+            // the scan seeks the next value of the column, and the partners seek the value of the
+            // scan; a partner that is ahead of the scan makes it seek the value of the partner
+            std::string value = "value" + id;
+            out << "for (RamDomain " << value << " = lower" << id << "[" << column << "];;) {\n";
+            out << "lower" << id << "[" << column << "] = " << value << ";\n";
+            out << "const auto* pos" << id << " = " << relName << "->seek_" << keys << "(lower" << id
+                << ",upper" << id << "," << ctxName << ");\n";
+            out << "if (pos" << id << " == nullptr) break;\n";
+            out << value << " = (*pos" << id << ")[" << column << "];\n";
+            for (std::size_t i = 0; i < partners.size(); i++) {
+                const auto* partnerRel = synthesiser.lookup(partners[i]->getRelation());
+                auto partnerKeys = isa->getSearchSignature(partners[i]);
+                auto partnerColumn = LeapfrogScan::getColumn(*partners[i]);
+                auto partnerId = id + "_" + std::to_string(i);
+                auto partnerCtxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*partnerRel) + ")";
+                out << "lower" << partnerId << "[" << partnerColumn << "] = " << value << ";\n";
+                out << "const auto* pos" << partnerId << " = " << synthesiser.getRelationName(partnerRel)
+                    << "->seek_" << partnerKeys << "(lower" << partnerId << ",upper" << partnerId << ","
+                    << partnerCtxName << ");\n";
+                out << "if (pos" << partnerId << " == nullptr) break;\n";
+                out << "if ((*pos" << partnerId << ")[" << partnerColumn << "] != " << value << ") {\n";
+                out << value << " = (*pos" << partnerId << ")[" << partnerColumn << "];\n";
+                out << "continue;\n";
+                out << "}\n";
+            }
+            out << "const auto& env" << id << " = *pos" << id << ";\n";
+            visit_(type_identity<TupleOperation>(), lscan, out);
+
+            // step to the next value in the order of the column's type
+            bool isUnsigned = rel->getAttributeTypes()[column][0] == 'u';
+            std::string type = isUnsigned ? "RamUnsigned" : "RamSigned";
+            std::string maximum = isUnsigned ? "MAX_RAM_UNSIGNED" : "MAX_RAM_SIGNED";
+            out << "if (ramBitCast<" << type << ">(" << value << ") == " << maximum << ") break;\n";
+            out << value << " = ramBitCast(ramBitCast<" << type << ">(" << value << ") + 1);\n";
+            out << "}\n";
             out << "}\n";
             PRINT_END_COMMENT(out);
         }
@@ -818,11 +1228,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             out << preamble.str();
             out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
             out << "try{\n";
-            out << "for(const auto& env0 : *it) {\n";
 
-            visit_(type_identity<TupleOperation>(), piscan, out);
+            emitScanLoop(piscan, "*it", out);
 
-            out << "}\n";
             out << "} catch(std::exception &e) { signalHandler->error(e.what());}\n";
             out << "}\n";
 
@@ -1148,7 +1556,8 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             const auto* tupleElem = as<TupleElement>(aggregate.getExpression());
             return tupleElem && tupleElem->getTupleId() == identifier &&
                    keys[tupleElem->getElement()] != ram::analysis::AttributeConstraint::None &&
-                   (repr == RelationRepresentation::BTREE || repr == RelationRepresentation::DEFAULT);
+                   (repr == RelationRepresentation::BTREE || repr == RelationRepresentation::DEFAULT ||
+                           repr == RelationRepresentation::COMPRESSED);
         }
 
         void visit_(
@@ -1650,9 +2059,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             out << "Tuple<RamDomain," << arity << "> tuple{{" << join(guardedInsert.getValues(), ",", rec)
                 << "}};\n";
 
-            // insert tuple
-            out << relName << "->"
-                << "insert(tuple," << ctxName << ");\n";
+            // insert tuple, or collect it in the buffer of the thread
+            if (bufferedRelations.count(rel->getName()) > 0) {
+                out << synthesiser.getInsertBufferName(*rel) << ".insert(tuple);\n";
+            } else {
+                out << relName << "->"
+                    << "insert(tuple," << ctxName << ");\n";
+            }
 
             // end of conseq body.
             out << "}\n";
@@ -1671,9 +2084,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             out << "Tuple<RamDomain," << arity << "> tuple{{" << join(insert.getValues(), ",", rec)
                 << "}};\n";
 
-            // insert tuple
-            out << relName << "->"
-                << "insert(tuple," << ctxName << ");\n";
+            // insert tuple, or collect it in the buffer of the thread
+            if (bufferedRelations.count(rel->getName()) > 0) {
+                out << synthesiser.getInsertBufferName(*rel) << ".insert(tuple);\n";
+            } else {
+                out << relName << "->"
+                    << "insert(tuple," << ctxName << ");\n";
+            }
 
             PRINT_END_COMMENT(out);
         }
@@ -1846,6 +2263,27 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visit_(
+                type_identity<BloomFilterCheck>, const BloomFilterCheck& check, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            const auto* rel = synthesiser.lookup(check.getRelation());
+            std::vector<const Expression*> values;
+            for (const auto* value : check.getValues()) {
+                if (!isUndefValue(value)) {
+                    values.push_back(value);
+                }
+            }
+            out << synthesiser.getBloomFilterName(*rel, check.getColumns())
+                << ".mayContain(souffle::BloomFilter::hash(std::array<RamDomain," << values.size() << ">{{";
+            out << join(values, ",", [&](auto& os, const Expression* value) {
+                os << "ramBitCast(";
+                dispatch(*value, os);
+                os << ")";
+            });
+            out << "}}))";
+            PRINT_END_COMMENT(out);
+        }
+
         void visit_(type_identity<ProvenanceExistenceCheck>, const ProvenanceExistenceCheck& provExists,
                 std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
@@ -2314,6 +2752,15 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 }
 
 void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary) {
+    // a single translation unit following the class declaration in the same stream
+    generateCode(os, "", os, {&os}, id, withSharedLibrary);
+}
+
+void Synthesiser::generateCode(std::ostream& os, const std::string& headerName, std::ostream& driver,
+        const std::vector<std::ostream*>& units, const std::string& id, bool& withSharedLibrary) {
+    assert(!units.empty() && "no translation unit for the subroutines");
+    const bool split = !headerName.empty();
+
     // ---------------------------------------------------------------
     //                      Auto-Index Generation
     // ---------------------------------------------------------------
@@ -2329,6 +2776,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
 
     // generate C++ program
 
+    if (split) {
+        os << "#pragma once\n";
+    }
     if (Global::config().has("verbose")) {
         os << "#define _SOUFFLE_STATS\n";
     }
@@ -2387,17 +2837,26 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     }
     os << "}\n";
     os << "\n";
-    os << "namespace souffle {\n";
-    os << "static const RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;\n";
 
     // synthesise data-structures for relations
+    std::stringstream relationTypes;
     for (auto rel : prog.getRelations()) {
         bool isProvInfo = rel->getRepresentation() == RelationRepresentation::INFO;
-        auto relationType =
-                Relation::getSynthesiserRelation(*rel, idxAnalysis->getIndexSelection(rel->getName()),
-                        Global::config().has("provenance") && !isProvInfo);
+        auto relationType = Relation::getSynthesiserRelation(*rel,
+                idxAnalysis->getIndexSelection(rel->getName()), idxAnalysis->getRepresentation(*rel),
+                Global::config().has("provenance") && !isProvInfo);
 
-        generateRelationTypeStruct(os, std::move(relationType));
+        generateRelationTypeStruct(relationTypes, std::move(relationType));
+    }
+    // cached types are included as headers, which open the namespace themselves
+    if (Global::config().has("type-cache")) {
+        os << relationTypes.str();
+    }
+
+    os << "namespace souffle {\n";
+    os << "static const RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;\n";
+    if (!Global::config().has("type-cache")) {
+        os << relationTypes.str();
     }
     os << '\n';
 
@@ -2506,9 +2965,9 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         const std::string& cppName = getRelationName(*rel);
 
         bool isProvInfo = rel->getRepresentation() == RelationRepresentation::INFO;
-        auto relationType =
-                Relation::getSynthesiserRelation(*rel, idxAnalysis->getIndexSelection(datalogName),
-                        Global::config().has("provenance") && !isProvInfo);
+        auto relationType = Relation::getSynthesiserRelation(*rel,
+                idxAnalysis->getIndexSelection(datalogName), idxAnalysis->getRepresentation(*rel),
+                Global::config().has("provenance") && !isProvInfo);
         const std::string& type = relationType->getTypeName();
 
         // defining table
@@ -2534,6 +2993,14 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
                     foundIn(loadRelations), foundIn(storeRelations));
         }
     }
+    // declare the Bloom filters built by the strata of their relations
+    std::set<std::string> bloomFilters;
+    visit(prog, [&](const BuildBloomFilter& build) {
+        bloomFilters.insert(getBloomFilterName(*lookup(build.getRelation()), build.getColumns()));
+    });
+    for (const auto& name : bloomFilters) {
+        os << "souffle::BloomFilter " << name << ";\n";
+    }
     os << "public:\n";
 
     // -- constructor --
@@ -2543,7 +3010,10 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     os << initCons.str() << '\n';
     os << "{\n";
     if (Global::config().has("profile")) {
-        os << "ProfileEventSingleton::instance().setOutputFile(profiling_fname);\n";
+        // Live profiling reads the events from the database, otherwise they are streamed to a binary
+        // log unless it is written as JSON
+        os << "ProfileEventSingleton::instance().setOutputFile(profiling_fname, "
+           << (Global::config().has("live-profile") ? "false" : "true") << ");\n";
     }
     os << registerRel.str();
     os << "}\n";
@@ -2565,6 +3035,8 @@ SignalHandler*          signalHandler {SignalHandler::instance()};
 std::atomic<RamDomain>  ctr {};
 std::atomic<std::size_t>     iter {};
 bool                    performIO = false;
+WriterPool              writers;
+std::atomic<std::size_t>     clearedMemory {};
 
 void runFunction(std::string  inputDirectoryArg   = "",
                  std::string  outputDirectoryArg  = "",
@@ -2578,6 +3050,7 @@ void runFunction(std::string  inputDirectoryArg   = "",
 #if defined(_OPENMP)
     if (0 < getNumThreads()) { omp_set_num_threads(getNumThreads()); }
 #endif
+    writers.setJobs(getNumThreads());
 
     signalHandler->set();
 )_";
@@ -2588,6 +3061,9 @@ void runFunction(std::string  inputDirectoryArg   = "",
     // add actual program body
     os << "// -- query evaluation --\n";
     if (Global::config().has("profile")) {
+        if (Global::config().has("profile-counters")) {
+            os << "profile::PerfCounters::instance().open();\n";
+        }
         os << "ProfileEventSingleton::instance().startTimer();\n";
         os << R"_(ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");)_" << '\n';
         os << "{\n"
@@ -2625,6 +3101,7 @@ void runFunction(std::string  inputDirectoryArg   = "",
         }
     }
 
+    os << "writers.waitAll();\n";
     os << "signalHandler->reset();\n";
 
     os << "}\n";  // end of runFunction() method
@@ -2660,28 +3137,39 @@ void runFunction(std::string  inputDirectoryArg   = "",
         os << '}';
     };
 
+    // the outputs are written in parallel
+    os << "writers.setJobs(getNumThreads());\n";
     for (auto store : storeIOs) {
         auto const& directive = store->getDirectives();
-        os << "try {";
+        os << "{\n";
         os << "std::map<std::string, std::string> directiveMap(";
         printDirectives(directive);
         os << ");\n";
         os << R"_(if (!outputDirectoryArg.empty()) {)_";
         os << R"_(directiveMap["output-dir"] = outputDirectoryArg;)_";
         os << "}\n";
+        os << R"_(directiveMap["jobs"] = std::to_string(writers.getNumThreads());)_";
+        os << "auto* relation = " << getRelationName(lookup(store->getRelation())) << ".get();\n";
+        os << "writers.write(relation, directiveMap, [this, directiveMap, relation](bool concurrent) {";
         os << "IOSystem::getInstance().getWriter(";
         os << "directiveMap, symTable, recordTable";
-        os << ")->writeAll(*" << getRelationName(lookup(store->getRelation())) << ");\n";
-
-        os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        os << ")->writeAll(*relation, concurrent);\n";
+        os << "});\n";
+        os << "}\n";
     }
+    os << "writers.waitAll();\n";
     os << "}\n";  // end of printAll() method
 
     // issue loadAll method
     os << "public:\n";
     os << "void loadAll(std::string inputDirectoryArg = \"\") override {\n";
+    os << "writers.setJobs(getNumThreads());\n";
 
     for (auto load : loadIOs) {
+        // embedded facts are loaded by the evaluation
+        if (load->get("IO") == "facts") {
+            continue;
+        }
         os << "try {";
         os << "std::map<std::string, std::string> directiveMap(";
         printDirectives(load->getDirectives());
@@ -2689,6 +3177,7 @@ void runFunction(std::string  inputDirectoryArg   = "",
         os << R"_(if (!inputDirectoryArg.empty()) {)_";
         os << R"_(directiveMap["fact-dir"] = inputDirectoryArg;)_";
         os << "}\n";
+        os << R"_(directiveMap["jobs"] = std::to_string(writers.getNumThreads());)_";
         os << "IOSystem::getInstance().getReader(";
         os << "directiveMap, symTable, recordTable";
         os << ")->readAll(*" << getRelationName(lookup(load->getRelation()));
@@ -2748,6 +3237,8 @@ void runFunction(std::string  inputDirectoryArg   = "",
     os << "return recordTable;\n";
     os << "}\n";  // end of getRecordTable() method
 
+    // code of the subroutines, which is emitted after the class declaration
+    std::vector<std::string> subroutines;
     if (!prog.getSubroutines().empty()) {
         // generate subroutine adapter
         os << "void executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
@@ -2765,37 +3256,48 @@ void runFunction(std::string  inputDirectoryArg   = "",
         os << "fatal(\"unknown subroutine\");\n";
         os << "}\n";  // end of executeSubroutine
 
+        // declare method for each subroutine; the methods are defined after the class declaration
+        for (std::size_t i = 0; i < prog.getSubroutines().size(); i++) {
+            os << "void "
+               << "subroutine_" << i
+               << "(const std::vector<RamDomain>& args, "
+                  "std::vector<RamDomain>& ret);\n";
+        }
+
         // generate method for each subroutine
         subroutineNum = 0;
         for (auto& sub : prog.getSubroutines()) {
+            std::stringstream out;
+
             // silence unused argument warnings on MSVC
-            os << "#ifdef _MSC_VER\n";
-            os << "#pragma warning(disable: 4100)\n";
-            os << "#endif // _MSC_VER\n";
+            out << "#ifdef _MSC_VER\n";
+            out << "#pragma warning(disable: 4100)\n";
+            out << "#endif // _MSC_VER\n";
 
             // issue method header
-            os << "void "
-               << "subroutine_" << subroutineNum
-               << "(const std::vector<RamDomain>& args, "
-                  "std::vector<RamDomain>& ret) {\n";
+            out << "void " << classname << "::"
+                << "subroutine_" << subroutineNum
+                << "(const std::vector<RamDomain>& args, "
+                   "std::vector<RamDomain>& ret) {\n";
 
             // issue lock variable for return statements
             bool needLock = false;
             visit(*sub.second, [&](const SubroutineReturn&) { needLock = true; });
             if (needLock) {
-                os << "std::mutex lock;\n";
+                out << "std::mutex lock;\n";
             }
 
             // emit code for subroutine
-            emitCode(os, *sub.second);
+            emitCode(out, *sub.second);
 
             // issue end of subroutine
-            os << "}\n";
+            out << "}\n";
 
             // restore unused argument warning
-            os << "#ifdef _MSC_VER\n";
-            os << "#pragma warning(default: 4100)\n";
-            os << "#endif // _MSC_VER\n";
+            out << "#ifdef _MSC_VER\n";
+            out << "#pragma warning(default: 4100)\n";
+            out << "#endif // _MSC_VER\n";
+            subroutines.push_back(out.str());
             subroutineNum++;
         }
     }
@@ -2816,80 +3318,117 @@ void runFunction(std::string  inputDirectoryArg   = "",
         os << "}\n";  // end of dumpFreqs() method
     }
     os << "};\n";  // end of class declaration
+    if (split) {
+        os << "}  // namespace souffle\n";
+    }
+
+    // distribute the subroutines over the translation units, each time assigning
+    // the largest remaining subroutine to the unit with the least code so far
+    std::vector<std::size_t> order(subroutines.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+            [&](std::size_t a, std::size_t b) { return subroutines[a].size() > subroutines[b].size(); });
+    std::vector<std::size_t> unitSizes(units.size(), 0);
+    std::vector<std::vector<std::size_t>> unitSubroutines(units.size());
+    for (std::size_t sub : order) {
+        std::size_t unit = std::min_element(unitSizes.begin(), unitSizes.end()) - unitSizes.begin();
+        unitSizes[unit] += subroutines[sub].size();
+        unitSubroutines[unit].push_back(sub);
+    }
+    for (std::size_t unit = 0; unit < units.size(); unit++) {
+        // keep the subroutines of a unit in their original order
+        std::sort(unitSubroutines[unit].begin(), unitSubroutines[unit].end());
+        std::ostream& out = *units[unit];
+        if (split) {
+            out << "#include \"" << headerName << "\"\n";
+            out << "namespace souffle {\n";
+        }
+        for (std::size_t sub : unitSubroutines[unit]) {
+            out << subroutines[sub];
+        }
+        if (split) {
+            out << "}  // namespace souffle\n";
+        }
+    }
+
+    if (split) {
+        driver << "#include \"" << headerName << "\"\n";
+        driver << "namespace souffle {\n";
+    }
 
     // hidden hooks
-    os << "SouffleProgram *newInstance_" << id << "(){return new " << classname << ";}\n";
-    os << "SymbolTable *getST_" << id << "(SouffleProgram *p){return &reinterpret_cast<" << classname
-       << "*>(p)->symTable;}\n";
-
-    os << "\n#ifdef __EMBEDDED_SOUFFLE__\n";
-    os << "class factory_" << classname << ": public souffle::ProgramFactory {\n";
-    os << "SouffleProgram *newInstance() {\n";
-    os << "return new " << classname << "();\n";
-    os << "};\n";
-    os << "public:\n";
-    os << "factory_" << classname << "() : ProgramFactory(\"" << id << "\"){}\n";
-    os << "};\n";
-    os << "extern \"C\" {\n";
-    os << "factory_" << classname << " __factory_" << classname << "_instance;\n";
-    os << "}\n";
-    os << "}\n";
-    os << "#else\n";
-    os << "}\n";
-    os << "int main(int argc, char** argv)\n{\n";
-    os << "try{\n";
+    driver << "SouffleProgram *newInstance_" << id << "(){return new " << classname << ";}\n";
+    driver << "SymbolTable *getST_" << id << "(SouffleProgram *p){return &reinterpret_cast<" << classname
+           << "*>(p)->symTable;}\n";
+
+    driver << "\n#ifdef __EMBEDDED_SOUFFLE__\n";
+    driver << "class factory_" << classname << ": public souffle::ProgramFactory {\n";
+    driver << "SouffleProgram *newInstance() {\n";
+    driver << "return new " << classname << "();\n";
+    driver << "};\n";
+    driver << "public:\n";
+    driver << "factory_" << classname << "() : ProgramFactory(\"" << id << "\"){}\n";
+    driver << "};\n";
+    driver << "extern \"C\" {\n";
+    driver << "factory_" << classname << " __factory_" << classname << "_instance;\n";
+    driver << "}\n";
+    driver << "}\n";
+    driver << "#else\n";
+    driver << "}\n";
+    driver << "int main(int argc, char** argv)\n{\n";
+    driver << "try{\n";
 
     // parse arguments
-    os << "souffle::CmdOptions opt(";
-    os << "R\"(" << Global::config().get("") << ")\",\n";
-    os << "R\"()\",\n";
-    os << "R\"()\",\n";
+    driver << "souffle::CmdOptions opt(";
+    driver << "R\"(" << Global::config().get("") << ")\",\n";
+    driver << "R\"()\",\n";
+    driver << "R\"()\",\n";
     if (Global::config().has("profile")) {
-        os << "true,\n";
-        os << "R\"(" << Global::config().get("profile") << ")\",\n";
+        driver << "true,\n";
+        driver << "R\"(" << Global::config().get("profile") << ")\",\n";
     } else {
-        os << "false,\n";
-        os << "R\"()\",\n";
+        driver << "false,\n";
+        driver << "R\"()\",\n";
     }
-    os << std::stoi(Global::config().get("jobs"));
-    os << ");\n";
+    driver << std::stoi(Global::config().get("jobs"));
+    driver << ");\n";
 
-    os << "if (!opt.parse(argc,argv)) return 1;\n";
+    driver << "if (!opt.parse(argc,argv)) return 1;\n";
 
-    os << "souffle::";
+    driver << "souffle::";
     if (Global::config().has("profile")) {
-        os << classname + " obj(opt.getProfileName());\n";
+        driver << classname + " obj(opt.getProfileName());\n";
     } else {
-        os << classname + " obj;\n";
+        driver << classname + " obj;\n";
     }
 
-    os << "#if defined(_OPENMP) \n";
-    os << "obj.setNumThreads(opt.getNumJobs());\n";
-    os << "\n#endif\n";
+    driver << "#if defined(_OPENMP) \n";
+    driver << "obj.setNumThreads(opt.getNumJobs());\n";
+    driver << "\n#endif\n";
 
     if (Global::config().has("profile")) {
-        os << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("", opt.getSourceFileName());)_"
-           << '\n';
-        os << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("fact-dir", opt.getInputFileDir());)_"
-           << '\n';
-        os << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("jobs", std::to_string(opt.getNumJobs()));)_"
-           << '\n';
-        os << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("output-dir", opt.getOutputFileDir());)_"
-           << '\n';
-        os << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("version", ")_"
-           << Global::config().get("version") << R"_(");)_" << '\n';
+        driver << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("", opt.getSourceFileName());)_"
+               << '\n';
+        driver << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("fact-dir", opt.getInputFileDir());)_"
+               << '\n';
+        driver << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("jobs", std::to_string(opt.getNumJobs()));)_"
+               << '\n';
+        driver << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("output-dir", opt.getOutputFileDir());)_"
+               << '\n';
+        driver << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("version", ")_"
+               << Global::config().get("version") << R"_(");)_" << '\n';
     }
-    os << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir());\n";
+    driver << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir());\n";
 
     if (Global::config().get("provenance") == "explain") {
-        os << "explain(obj, false);\n";
+        driver << "explain(obj, false);\n";
     } else if (Global::config().get("provenance") == "explore") {
-        os << "explain(obj, true);\n";
+        driver << "explain(obj, true);\n";
     }
-    os << "return 0;\n";
-    os << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
-    os << "}\n";
-    os << "\n#endif\n";
+    driver << "return 0;\n";
+    driver << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
+    driver << "}\n";
+    driver << "\n#endif\n";
 }
 
 }  // namespace souffle::synthesiser
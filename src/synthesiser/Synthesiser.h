@@ -30,6 +30,7 @@
 #include <ostream>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace souffle::synthesiser {
 
@@ -59,6 +60,9 @@ private:
     /** Relation map */
     std::map<std::string, const ram::Relation*> relationMap;
 
+    /** Synthesiser relations describing the data structure of each relation */
+    std::map<std::string, Own<Relation>> synthesiserRelations;
+
     /** Symbol map */
     mutable std::map<std::string, unsigned> symbolMap;
 
@@ -79,12 +83,21 @@ protected:
     /** Get context name */
     const std::string getOpContextName(const ram::Relation& rel);
 
+    /** Get insert buffer name */
+    const std::string getInsertBufferName(const ram::Relation& rel);
+
+    /** Get the name of the Bloom filter over the given columns of a relation */
+    const std::string getBloomFilterName(const ram::Relation& rel, const std::vector<std::size_t>& columns);
+
     /** Get relation struct definition */
     void generateRelationTypeStruct(std::ostream& out, Own<Relation> relationType);
 
     /** Get referenced relations */
     std::set<const ram::Relation*> getReferencedRelations(const ram::Operation& op);
 
+    /** Get the synthesiser relation describing the data structure of a relation */
+    Relation& getSynthesiserRelation(const ram::Relation& rel);
+
     /** Generate code */
     void emitCode(std::ostream& out, const ram::Statement& stmt);
 
@@ -129,5 +142,17 @@ public:
 
     /** Generate code */
     void generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary);
+
+    /**
+     * Generate code split into translation units
+     *
+     * The header declares the relations and the program class and is included
+     * as headerName by the driver, which defines the entry points of the
+     * program, and by the given units, over which the subroutines of the strata
+     * are distributed by the size of their code. The units can be compiled in
+     * parallel.
+     */
+    void generateCode(std::ostream& header, const std::string& headerName, std::ostream& driver,
+            const std::vector<std::ostream*>& units, const std::string& id, bool& withSharedLibrary);
 };
 }  // namespace souffle::synthesiser
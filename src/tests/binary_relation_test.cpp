@@ -346,6 +346,44 @@ TEST(EqRelTest, Merge) {
     EXPECT_EQ(count, br2.size());
 }
 
+TEST(EqRelTest, IncrementalSets) {
+    // test that the cached sets follow insertions made after iterating
+    EqRel br;
+    br.insert(0, 1);
+    br.insert(2, 3);
+    br.insert(4, 4);
+    EXPECT_EQ(br.size(), (2 * 2) + (2 * 2) + (1 * 1));
+
+    // join two cached sets, and a cached set with new nodes
+    br.insert(1, 3);
+    br.insert(5, 4);
+    br.insert(6, 5);
+    EXPECT_EQ(br.size(), (4 * 4) + (3 * 3));
+
+    // re-inserting implied pairs leaves the sets as they are
+    EXPECT_TRUE(br.insert(0, 2));
+    EXPECT_TRUE(br.insert(6, 4));
+    EXPECT_EQ(br.size(), (4 * 4) + (3 * 3));
+
+    // join all sets through a new node
+    br.insert(7, 0);
+    br.insert(7, 6);
+    EXPECT_EQ(br.size(), 8 * 8);
+
+    std::size_t count = 0;
+    for (auto x : br) {
+        EXPECT_TRUE(br.contains(x[0], x[1]));
+        ++count;
+    }
+    EXPECT_EQ(count, br.size());
+
+    count = 0;
+    for (auto it = br.closure(7); it != br.end(); ++it) {
+        ++count;
+    }
+    EXPECT_EQ(count, 8 * 8);
+}
+
 TEST(EqRelTest, IterEmpty) {
     // test iterating over an empty binrel fails
     EqRel br;
@@ -0,0 +1,138 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file bloom_filter_test.cpp
+ *
+ * A test case testing the Bloom filter and comparing the cost of index
+ * searches that mostly miss with and without the filter.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/BloomFilter.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace souffle::test {
+
+using Key = std::array<RamDomain, 2>;
+using Triple = std::array<RamDomain, 3>;
+using Entry = Tuple<RamDomain, 2>;
+
+TEST(BloomFilter, Basic) {
+    BloomFilter filter;
+
+    // a filter that has not been built may contain any key
+    EXPECT_TRUE(filter.mayContain(BloomFilter::hash(Key{{1, 2}})));
+
+    // an empty filter contains no key
+    filter.reset(0);
+    EXPECT_FALSE(filter.mayContain(BloomFilter::hash(Key{{1, 2}})));
+
+    filter.insert(BloomFilter::hash(Key{{1, 2}}));
+    EXPECT_TRUE(filter.mayContain(BloomFilter::hash(Key{{1, 2}})));
+
+    // the filter is cleared by resetting it
+    filter.reset(1);
+    EXPECT_FALSE(filter.mayContain(BloomFilter::hash(Key{{1, 2}})));
+}
+
+TEST(BloomFilter, Hash) {
+    // the hash of a key is the same whether it is computed at once or value by value
+    RamDomain key[] = {7, -3, 12};
+    uint64_t seed = BloomFilter::begin(3);
+    for (RamDomain value : key) {
+        seed = BloomFilter::combine(seed, value);
+    }
+    EXPECT_EQ(BloomFilter::hash(key, 3), BloomFilter::finish(seed));
+    EXPECT_EQ(BloomFilter::hash(key, 3), BloomFilter::hash(Triple{{7, -3, 12}}));
+
+    // the order and the number of values matter
+    EXPECT_NE(BloomFilter::hash(Key{{1, 2}}), BloomFilter::hash(Key{{2, 1}}));
+    EXPECT_NE(BloomFilter::hash(key, 2), BloomFilter::hash(key, 3));
+}
+
+TEST(BloomFilter, FalsePositives) {
+    const int N = 100000;
+    BloomFilter filter;
+    filter.reset(N);
+    for (int i = 0; i < N; i++) {
+        filter.insert(BloomFilter::hash(Key{{i, 2 * i}}));
+    }
+
+    // there are no false negatives
+    int found = 0;
+    for (int i = 0; i < N; i++) {
+        found += filter.mayContain(BloomFilter::hash(Key{{i, 2 * i}})) ? 1 : 0;
+    }
+    EXPECT_EQ(N, found);
+
+    // and less than one percent of false positives
+    int falsePositives = 0;
+    for (int i = 0; i < N; i++) {
+        falsePositives += filter.mayContain(BloomFilter::hash(Key{{i, 2 * i + 1}})) ? 1 : 0;
+    }
+    EXPECT_LT(falsePositives, N / 100);
+}
+
+TEST(Performance, FilteredSearches) {
+    const int N = 1 << 17;
+    const int probes = 1 << 22;
+
+    // every key is searched by its first column, of which only one in twenty is present
+    btree_set<Entry> set;
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<RamDomain> values(0, 20 * N);
+    for (int i = 0; i < N; i++) {
+        set.insert(Entry{{values(generator), i}});
+    }
+    std::vector<RamDomain> keys;
+    for (int i = 0; i < probes; i++) {
+        keys.push_back(values(generator));
+    }
+
+    auto search = [&](RamDomain key) {
+        auto pos = set.lower_bound(Entry{{key, MIN_RAM_SIGNED}});
+        return pos != set.end() && (*pos)[0] == key;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::size_t plain = 0;
+    for (RamDomain key : keys) {
+        plain += search(key) ? 1 : 0;
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+
+    BloomFilter filter;
+    filter.reset(set.size());
+    for (const auto& cur : set) {
+        filter.insert(BloomFilter::hash(&cur[0], 1));
+    }
+    std::size_t filtered = 0;
+    for (RamDomain key : keys) {
+        filtered += (filter.mayContain(BloomFilter::hash(&key, 1)) && search(key)) ? 1 : 0;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_EQ(plain, filtered);
+    std::cout << "searches: " << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+              << "ms, filtered searches including the filter: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << "ms\n";
+}
+
+}  // namespace souffle::test
@@ -576,6 +576,31 @@ TEST(BTreeSet, ChunkSplitStress) {
     }
 }
 
+TEST(BTreeSet, Prefetch) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    std::vector<int> keys = {5, 0, 99, 50, 7, 1000, -1};
+
+    // prefetching an empty tree has no effect
+    t.prefetch(keys.data(), keys.size());
+    EXPECT_TRUE(t.empty());
+
+    // small nodes make the tree deep enough for the paths to be prefetched
+    for (int i = 0; i < 10000; i += 2) {
+        t.insert(i);
+    }
+    for (int i = 0; i < 100; i++) {
+        keys.push_back(i * 97 % 10001);
+    }
+    t.prefetch(keys.data(), keys.size());
+
+    EXPECT_EQ(5000, t.size());
+    for (int key : keys) {
+        EXPECT_EQ(key >= 0 && key < 10000 && key % 2 == 0, t.contains(key));
+    }
+}
+
 using Entry = std::tuple<int, int>;
 
 std::vector<Entry> getData(unsigned numEntries) {
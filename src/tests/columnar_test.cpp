@@ -0,0 +1,281 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file columnar_test.cpp
+ *
+ * A test case testing the column store and comparing the performance of
+ * its filtered scans against scanning and filtering a B-tree set.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/ColumnStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle::test {
+
+using Entry = Tuple<RamDomain, 2>;
+using Store = ColumnStore<2, 4>;
+
+TEST(ColumnStore, Basic) {
+    Store store;
+
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(0, store.size());
+    EXPECT_FALSE(store.contains({1, 2}));
+
+    EXPECT_TRUE(store.insert({1, 2}));
+    EXPECT_FALSE(store.empty());
+    EXPECT_EQ(1, store.size());
+    EXPECT_TRUE(store.contains({1, 2}));
+    EXPECT_FALSE(store.contains({2, 1}));
+
+    EXPECT_TRUE(store.insert({2, 1}));
+    EXPECT_FALSE(store.insert({1, 2}));
+    EXPECT_EQ(2, store.size());
+    EXPECT_TRUE(store.contains({2, 1}));
+}
+
+TEST(ColumnStore, Iterator) {
+    Store store;
+    const int N = 1000;
+
+    EXPECT_TRUE(store.begin() == store.end());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(store.insert({i, N - i}));
+    }
+    for (int i = 0; i < N; i++) {
+        EXPECT_FALSE(store.insert({i, N - i}));
+    }
+    EXPECT_EQ(N, store.size());
+    EXPECT_EQ((N + Store::chunkSize - 1) / Store::chunkSize, store.getNumChunks());
+
+    // rows are enumerated in insertion order
+    int expected = 0;
+    for (const auto& cur : store) {
+        EXPECT_EQ(expected, cur[0]);
+        EXPECT_EQ(N - expected, cur[1]);
+        expected++;
+    }
+    EXPECT_EQ(N, expected);
+}
+
+TEST(ColumnStore, Boundaries) {
+    Store store;
+
+    for (int i = 0; i < 100; i += 2) {
+        store.insert({i, i});
+    }
+
+    for (int i = 0; i < 100; i++) {
+        auto a = store.lower_bound({i, i});
+        auto b = store.upper_bound({i, i});
+        if (i % 2 == 0) {
+            EXPECT_TRUE(a == store.find({i, i}));
+            EXPECT_EQ(i, (*a)[0]);
+            EXPECT_TRUE(++a == b);
+        } else {
+            EXPECT_TRUE(a == store.end());
+            EXPECT_TRUE(b == store.end());
+        }
+    }
+}
+
+TEST(ColumnStore, Clear) {
+    Store store;
+
+    for (int i = 0; i < 100; i++) {
+        store.insert({i, i});
+    }
+    store.clear();
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(0, store.getNumChunks());
+    EXPECT_FALSE(store.contains({10, 10}));
+
+    EXPECT_TRUE(store.insert({10, 10}));
+    EXPECT_EQ(1, store.size());
+    EXPECT_TRUE(store.contains({10, 10}));
+}
+
+TEST(ColumnStore, Filter) {
+    Store store;
+    const int N = 1000;
+
+    // the first attribute is clustered, the second is not
+    std::vector<Entry> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back({i, (i * 7919) % 13 - 6});
+        store.insert(data.back());
+    }
+
+    std::vector<std::vector<ColumnPredicate>> queries = {{},
+            {{0, BinaryConstraintOp::EQ, 500}},
+            {{0, BinaryConstraintOp::GE, 100}, {0, BinaryConstraintOp::LT, 200}},
+            {{0, BinaryConstraintOp::GT, 990}, {1, BinaryConstraintOp::NE, 0}},
+            {{1, BinaryConstraintOp::LE, -3}},
+            {{1, BinaryConstraintOp::ULT, 3}},
+            {{0, BinaryConstraintOp::LT, 0}},
+            {{0, BinaryConstraintOp::GT, 20}, {0, BinaryConstraintOp::LT, 10}}};
+
+    auto satisfies = [](const Entry& cur, const ColumnPredicate& pred) {
+        RamDomain x = cur[pred.column];
+        switch (pred.op) {
+            case BinaryConstraintOp::EQ: return x == pred.value;
+            case BinaryConstraintOp::NE: return x != pred.value;
+            case BinaryConstraintOp::LT: return x < pred.value;
+            case BinaryConstraintOp::LE: return x <= pred.value;
+            case BinaryConstraintOp::GT: return x > pred.value;
+            case BinaryConstraintOp::GE: return x >= pred.value;
+            case BinaryConstraintOp::ULT:
+                return ramBitCast<RamUnsigned>(x) < ramBitCast<RamUnsigned>(pred.value);
+            default: return false;
+        }
+    };
+
+    for (const auto& preds : queries) {
+        std::vector<Entry> expected;
+        for (const auto& cur : data) {
+            if (std::all_of(preds.begin(), preds.end(), [&](const auto& p) { return satisfies(cur, p); })) {
+                expected.push_back(cur);
+            }
+        }
+
+        std::vector<Entry> found;
+        for (const auto& cur : store.filter(preds)) {
+            found.push_back(cur);
+        }
+        EXPECT_EQ(expected, found);
+
+        // the partitions cover the same rows in the same order
+        for (std::size_t n : {1, 3, 7, 100}) {
+            std::vector<Entry> partitioned;
+            for (const auto& part : store.partition(preds, n)) {
+                for (const auto& cur : part) {
+                    partitioned.push_back(cur);
+                }
+            }
+            EXPECT_EQ(expected, partitioned);
+        }
+    }
+}
+
+TEST(ColumnStore, Parallel) {
+    const int N = 10000;
+
+    std::vector<Entry> full;
+    for (int dup = 0; dup < 3; dup++) {
+        for (int i = 0; i < N; i++) {
+            full.push_back({i, -i});
+        }
+    }
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(full.begin(), full.end(), generator);
+
+    Store store;
+#pragma omp parallel for
+    for (std::size_t i = 0; i < full.size(); i++) {
+        store.insert(full[i]);
+    }
+
+    EXPECT_EQ(N, store.size());
+    std::set<Entry> is(store.begin(), store.end());
+    EXPECT_EQ(N, is.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(store.contains({i, -i}));
+    }
+}
+
+using time_point = std::chrono::high_resolution_clock::time_point;
+
+time_point now() {
+    return std::chrono::high_resolution_clock::now();
+}
+
+long duration(const time_point& start, const time_point& end) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+template <typename Op>
+long time(const std::string& name, const Op& operation) {
+    std::cout << "\t" << std::setw(30) << std::setiosflags(std::ios::left) << name
+              << std::resetiosflags(std::ios::left) << " ... " << std::flush;
+    auto a = now();
+    operation();
+    auto b = now();
+    long time = duration(a, b);
+    std::cout << " done [" << std::setw(5) << time << "ms]\n";
+    return time;
+}
+
+TEST(Performance, ColumnStoreVsBTree) {
+    const int N = 1 << 20;
+    const int R = 20;
+
+    std::cout << "Generating Test-Data ...\n";
+    std::vector<Entry> in;
+    for (int i = 0; i < N; i++) {
+        in.push_back({i, i % 1000});
+    }
+
+    btree_set<Entry> tree(in.begin(), in.end());
+    ColumnStore<2> store;
+    for (const auto& cur : in) {
+        store.insert(cur);
+    }
+
+    // a selective filter on the clustered attribute and a non-selective one on the other
+    const std::vector<ColumnPredicate> preds = {
+            {0, BinaryConstraintOp::GE, N / 2}, {0, BinaryConstraintOp::LT, N / 2 + N / 100}};
+    const std::vector<ColumnPredicate> wide = {{1, BinaryConstraintOp::LT, 500}};
+
+    std::size_t a = 0;
+    std::size_t b = 0;
+    time("btree scan + filter", [&]() {
+        for (int r = 0; r < R; r++) {
+            for (const auto& cur : tree) {
+                a += (cur[0] >= N / 2 && cur[0] < N / 2 + N / 100) ? 1 : 0;
+                b += (cur[1] < 500) ? 1 : 0;
+            }
+        }
+    });
+
+    std::size_t c = 0;
+    std::size_t d = 0;
+    time("column store filter", [&]() {
+        for (int r = 0; r < R; r++) {
+            for (const auto& cur : store.filter(preds)) {
+                c += cur[0] >= 0 ? 1 : 0;
+            }
+            for (const auto& cur : store.filter(wide)) {
+                d += cur[1] >= 0 ? 1 : 0;
+            }
+        }
+    });
+
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(b, d);
+}
+
+}  // namespace souffle::test
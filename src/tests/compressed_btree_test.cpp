@@ -0,0 +1,349 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file compressed_btree_test.cpp
+ *
+ * A test case testing the compressed B-tree sets and multisets and
+ * comparing their memory usage and throughput against B-tree sets.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/CompressedBTree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle::test {
+
+using Entry = Tuple<RamDomain, 2>;
+using Set = compressed_btree_set<Entry, detail::comparator<Entry>, 16>;
+
+TEST(CompressedBTreeSet, Basic) {
+    Set set;
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0, set.size());
+    EXPECT_FALSE(set.contains({1, 2}));
+
+    EXPECT_TRUE(set.insert({1, 2}));
+    EXPECT_FALSE(set.empty());
+    EXPECT_EQ(1, set.size());
+    EXPECT_TRUE(set.contains({1, 2}));
+    EXPECT_FALSE(set.contains({2, 1}));
+
+    EXPECT_TRUE(set.insert({2, 1}));
+    EXPECT_TRUE(set.insert({0, 5}));
+    EXPECT_FALSE(set.insert({1, 2}));
+    EXPECT_EQ(3, set.size());
+    EXPECT_TRUE(set.contains({0, 5}));
+    EXPECT_TRUE(set.contains({2, 1}));
+    EXPECT_FALSE(set.contains({0, 4}));
+}
+
+TEST(CompressedBTreeSet, Extremes) {
+    Set set;
+
+    // differences overflowing the domain are encoded correctly
+    std::vector<Entry> data = {{MIN_RAM_SIGNED, MAX_RAM_SIGNED}, {MIN_RAM_SIGNED, MIN_RAM_SIGNED},
+            {-1, 0}, {0, -1}, {0, 0}, {MAX_RAM_SIGNED, MIN_RAM_SIGNED}, {MAX_RAM_SIGNED, MAX_RAM_SIGNED}};
+    for (const auto& cur : data) {
+        EXPECT_TRUE(set.insert(cur));
+    }
+
+    std::set<Entry> ordered(data.begin(), data.end());
+    std::vector<Entry> expected(ordered.begin(), ordered.end());
+    std::vector<Entry> found(set.begin(), set.end());
+    EXPECT_EQ(expected, found);
+}
+
+TEST(CompressedBTreeSet, Orders) {
+    const int N = 2000;
+
+    std::vector<Entry> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back({i / 37, (i * 7919) % 1013});
+    }
+
+    std::vector<Entry> sorted(data);
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<Entry> reversed(sorted.rbegin(), sorted.rend());
+
+    std::vector<Entry> shuffled(data);
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+
+    for (const auto& in : {sorted, reversed, shuffled}) {
+        Set set;
+        for (const auto& cur : in) {
+            EXPECT_TRUE(set.insert(cur));
+        }
+        for (const auto& cur : in) {
+            EXPECT_FALSE(set.insert(cur));
+        }
+        EXPECT_EQ(N, set.size());
+
+        std::vector<Entry> found(set.begin(), set.end());
+        EXPECT_EQ(sorted, found);
+        for (const auto& cur : in) {
+            EXPECT_TRUE(set.contains(cur));
+            EXPECT_FALSE(set.contains({cur[0], cur[1] + 1013}));
+        }
+    }
+}
+
+TEST(CompressedBTreeSet, Boundaries) {
+    Set set;
+
+    for (int i = 0; i < 100; i += 2) {
+        set.insert({i, i});
+    }
+
+    EXPECT_TRUE(set.lower_bound({-1, 0}) == set.begin());
+    EXPECT_TRUE(set.upper_bound({98, 98}) == set.end());
+
+    for (int i = 0; i < 100; i++) {
+        auto a = set.lower_bound({i, i});
+        auto b = set.upper_bound({i, i});
+        if (i % 2 == 0) {
+            EXPECT_TRUE(a == set.find({i, i}));
+            EXPECT_EQ(i, (*a)[0]);
+            EXPECT_TRUE(++a == b);
+        } else {
+            EXPECT_TRUE(a == b);
+            EXPECT_TRUE(set.find({i, i}) == set.end());
+            if (i < 99) {
+                EXPECT_EQ(i + 1, (*a)[0]);
+            }
+        }
+    }
+}
+
+TEST(CompressedBTreeSet, Clear) {
+    Set set;
+
+    for (int i = 0; i < 1000; i++) {
+        set.insert({i, i});
+    }
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.begin() == set.end());
+    EXPECT_FALSE(set.contains({10, 10}));
+
+    EXPECT_TRUE(set.insert({10, 10}));
+    EXPECT_EQ(1, set.size());
+    EXPECT_TRUE(set.contains({10, 10}));
+}
+
+TEST(CompressedBTreeSet, Chunks) {
+    Set set;
+    EXPECT_TRUE(set.getChunks(10).empty());
+
+    for (int i = 0; i < 1000; i++) {
+        set.insert({i, 0});
+    }
+
+    for (std::size_t n : {1, 3, 10, 999, 1000, 5000}) {
+        auto chunks = set.getChunks(n);
+        EXPECT_TRUE(chunks.size() <= n);
+
+        int last = -1;
+        for (const auto& chunk : chunks) {
+            for (const auto& cur : chunk) {
+                EXPECT_EQ(last + 1, cur[0]);
+                last = cur[0];
+            }
+        }
+        EXPECT_EQ(999, last);
+    }
+}
+
+/**
+ * A comparator only considering the first column, as used for partial indexes.
+ */
+struct first_column {
+    int operator()(const Entry& a, const Entry& b) const {
+        return (a[0] > b[0]) - (a[0] < b[0]);
+    }
+    bool less(const Entry& a, const Entry& b) const {
+        return a[0] < b[0];
+    }
+    bool equal(const Entry& a, const Entry& b) const {
+        return a[0] == b[0];
+    }
+};
+
+TEST(CompressedBTreeMultiset, Basic) {
+    compressed_btree_multiset<Entry, first_column, 8> set;
+    const int N = 50;
+    const int M = 20;
+
+    std::vector<Entry> data;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < M; j++) {
+            data.push_back({i, j});
+        }
+    }
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(data.begin(), data.end(), generator);
+
+    for (const auto& cur : data) {
+        EXPECT_TRUE(set.insert(cur));
+    }
+    EXPECT_EQ(N * M, set.size());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.contains({i, 0}));
+
+        // all tuples sharing the first column are covered by the range
+        std::set<int> seen;
+        for (auto it = set.lower_bound({i, 0}); it != set.upper_bound({i, 0}); ++it) {
+            EXPECT_EQ(i, (*it)[0]);
+            seen.insert((*it)[1]);
+        }
+        EXPECT_EQ(M, seen.size());
+    }
+    EXPECT_FALSE(set.contains({N, 0}));
+}
+
+TEST(CompressedBTreeSet, Parallel) {
+    const int N = 10000;
+
+    std::vector<Entry> full;
+    for (int dup = 0; dup < 3; dup++) {
+        for (int i = 0; i < N; i++) {
+            full.push_back({i, -i});
+        }
+    }
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(full.begin(), full.end(), generator);
+
+    Set set;
+#pragma omp parallel for
+    for (std::size_t i = 0; i < full.size(); i++) {
+        set.insert(full[i]);
+    }
+
+    EXPECT_EQ(N, set.size());
+    std::set<Entry> is(set.begin(), set.end());
+    EXPECT_EQ(N, is.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.contains({i, -i}));
+    }
+}
+
+using time_point = std::chrono::high_resolution_clock::time_point;
+
+time_point now() {
+    return std::chrono::high_resolution_clock::now();
+}
+
+long duration(const time_point& start, const time_point& end) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+template <typename Op>
+long time(const std::string& name, const Op& operation) {
+    std::cout << "\t" << std::setw(30) << std::setiosflags(std::ios::left) << name
+              << std::resetiosflags(std::ios::left) << " ... " << std::flush;
+    auto a = now();
+    operation();
+    auto b = now();
+    long time = duration(a, b);
+    std::cout << " done [" << std::setw(5) << time << "ms]\n";
+    return time;
+}
+
+#define checkPerformance(set_type, name, in, out)                                      \
+    {                                                                                  \
+        std::cout << "Testing: " << name << " ..\n";                                   \
+        set_type set;                                                                  \
+        time("filling set", [&]() {                                                    \
+            for (const auto& cur : in) {                                               \
+                set.insert(cur);                                                       \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_EQ(in.size(), set.size());                                              \
+        std::cout << "\tmemory usage: " << set.getMemoryUsage() << " bytes\n";         \
+        int counter = 0;                                                               \
+        time("full scan", [&]() {                                                      \
+            for (auto it = set.begin(); it != set.end(); ++it) {                       \
+                counter++;                                                             \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_EQ(in.size(), (std::size_t)counter);                                    \
+        bool allPresent = true;                                                        \
+        time("membership in", [&]() {                                                  \
+            for (const auto& cur : in) {                                               \
+                allPresent = set.contains(cur) && allPresent;                          \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allPresent);                                                       \
+        bool allMissing = true;                                                        \
+        time("membership out", [&]() {                                                 \
+            for (const auto& cur : out) {                                              \
+                allMissing = !set.contains(cur) && allMissing;                         \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allMissing);                                                       \
+        bool allFound = true;                                                          \
+        time("boundaries on missing elements", [&]() {                                 \
+            for (const auto& cur : out) {                                              \
+                allFound = (set.lower_bound(cur) == set.upper_bound(cur)) && allFound; \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allFound);                                                         \
+        std::cout << "\tDone!\n\n";                                                    \
+    }
+
+TEST(Performance, CompressedBTreeVsBTree) {
+    const int N = 1 << 18;
+
+    std::cout << "Generating Test-Data ...\n";
+    std::vector<Entry> in;
+    std::vector<Entry> out;
+    time("generating data", [&]() {
+        for (int i = 0; i < 2 * N; i++) {
+            Entry cur{i / 100, i % 100};
+            (i % 2 == 0 ? in : out).push_back(cur);
+        }
+        std::random_device rd;
+        std::mt19937 generator(rd());
+        std::shuffle(in.begin(), in.end(), generator);
+        std::shuffle(out.begin(), out.end(), generator);
+    });
+
+    using t1 = btree_set<Entry>;
+    checkPerformance(t1, "souffle btree_set", in, out);
+
+    using t2 = compressed_btree_set<Entry>;
+    checkPerformance(t2, "souffle compressed_btree_set", in, out);
+
+    // the compressed leaves need a fraction of the memory
+    btree_set<Entry> a(in.begin(), in.end());
+    compressed_btree_set<Entry> b(in.begin(), in.end());
+    EXPECT_LT(2 * b.getMemoryUsage(), a.getMemoryUsage());
+}
+
+}  // namespace souffle::test
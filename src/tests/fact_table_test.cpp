@@ -0,0 +1,78 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file fact_table_test.cpp
+ *
+ * Tests the table of embedded facts and the stream reading it.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/IOSystem.h"
+#include "souffle/io/ReadStreamFacts.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace souffle::test {
+
+/** Relation collecting the tuples that are read */
+struct Collector {
+    std::vector<std::vector<RamDomain>> tuples;
+    void insert(const RamDomain* tuple) {
+        tuples.push_back({tuple[0], tuple[1], tuple[2]});
+    }
+};
+
+TEST(FactTable, Encoding) {
+    FactTable table(2);
+    table.addRow({"a", "1"});
+    table.addRow({"b", "2"});
+    EXPECT_EQ("2:2:6:1:a1:b6:1:11:2", table.encode());
+
+    FactTable decoded = FactTable::decode(table.encode());
+    EXPECT_EQ(2, decoded.getArity());
+    EXPECT_EQ(2, decoded.size());
+    EXPECT_EQ(table.encode(), decoded.encode());
+
+    std::size_t pos = 0;
+    EXPECT_EQ("1", decoded.nextValue(1, pos));
+    EXPECT_EQ("2", decoded.nextValue(1, pos));
+}
+
+TEST(FactTable, Read) {
+    FactTable table(3);
+    table.addRow({"a b", "-1", "0x10"});
+    table.addRow({"", "2", "3"});
+
+    std::map<std::string, std::string> directives{{"IO", "facts"}, {"name", "r"}, {"auxArity", "0"},
+            {"facts", table.encode()},
+            {"types", R"({"relation":{"arity":3,"auxArity":0,)"
+                      R"("types":["s:symbol","i:number","u:unsigned"]}})"}};
+    SymbolTable symbolTable;
+    RecordTable recordTable;
+    Collector relation;
+    IOSystem::getInstance().getReader(directives, symbolTable, recordTable)->readAll(relation);
+
+    EXPECT_EQ(2, relation.tuples.size());
+    EXPECT_EQ("a b", symbolTable.resolve(relation.tuples[0][0]));
+    EXPECT_EQ(-1, relation.tuples[0][1]);
+    EXPECT_EQ(16, relation.tuples[0][2]);
+    EXPECT_EQ("", symbolTable.resolve(relation.tuples[1][0]));
+    EXPECT_EQ(2, relation.tuples[1][1]);
+    EXPECT_EQ(3, relation.tuples[1][2]);
+}
+
+}  // namespace souffle::test
@@ -0,0 +1,113 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file gzip_stream_test.cpp
+ *
+ * Tests the gzip file streams writing and reading blocks in parallel.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#ifdef USE_LIBZ
+#include "souffle/io/gzfstream.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <zlib.h>
+
+namespace souffle::test {
+
+const std::string fileName = "gzip_stream_test.tmp";
+
+/** Text of the given number of lines */
+std::string lines(std::size_t count) {
+    std::stringstream text;
+    for (std::size_t i = 0; i < count; ++i) {
+        text << "line " << i << "\t" << i * i << "\n";
+    }
+    return text.str();
+}
+
+void write(const std::string& text, std::size_t threads = 1) {
+    gzfstream::ogzfstream file(fileName);
+    file.setThreads(threads);
+    file << text;
+}
+
+/** Read the file with the gzip stream */
+std::string read(std::size_t threads = 1) {
+    gzfstream::igzfstream file(fileName);
+    file.setThreads(threads);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/** Read the file with zlib, as standard tools do */
+std::string readZlib() {
+    gzFile file = gzopen(fileName.c_str(), "rb");
+    std::string text;
+    char buffer[4096];
+    int charsRead;
+    while ((charsRead = gzread(file, buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, charsRead);
+    }
+    gzclose(file);
+    return text;
+}
+
+TEST(GZipStream, Blocks) {
+    const std::string text = lines(400000);
+    EXPECT_TRUE(text.size() > 3 * gzfstream::internal::gzipBlockSize);
+    write(text);
+    EXPECT_TRUE(text == read());
+    EXPECT_TRUE(text == readZlib());
+    std::remove(fileName.c_str());
+}
+
+TEST(GZipStream, Threads) {
+    // blocks are compressed and decompressed by several threads in the same format
+    const std::string text = lines(400000);
+    write(text, 4);
+    EXPECT_TRUE(text == read());
+    EXPECT_TRUE(text == read(4));
+    EXPECT_TRUE(text == readZlib());
+    write(text);
+    EXPECT_TRUE(text == read(4));
+    std::remove(fileName.c_str());
+}
+
+TEST(GZipStream, Empty) {
+    write("");
+    EXPECT_EQ("", read());
+    EXPECT_EQ("", readZlib());
+    std::remove(fileName.c_str());
+}
+
+TEST(GZipStream, Concatenated) {
+    // a member that does not record its size is read sequentially
+    const std::string text = lines(200000);
+    write(text);
+    gzFile file = gzopen(fileName.c_str(), "ab");
+    gzputs(file, "appended\n");
+    gzclose(file);
+    EXPECT_TRUE(text + "appended\n" == read());
+    std::remove(fileName.c_str());
+}
+
+TEST(GZipStream, Uncompressed) {
+    std::ofstream(fileName) << "a\tb\n";
+    EXPECT_EQ("a\tb\n", read());
+    std::remove(fileName.c_str());
+}
+
+}  // namespace souffle::test
+#endif
@@ -0,0 +1,324 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file hashset_test.cpp
+ *
+ * A test case testing the concurrent hash set and comparing its
+ * performance for equality lookups against the B-tree set.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/HashSet.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle::test {
+
+using Entry = Tuple<RamDomain, 2>;
+
+TEST(HashSet, Basic) {
+    HashSet<int> set;
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0, set.size());
+    EXPECT_FALSE(set.contains(12));
+
+    EXPECT_TRUE(set.insert(12));
+    EXPECT_FALSE(set.empty());
+    EXPECT_EQ(1, set.size());
+    EXPECT_TRUE(set.contains(12));
+    EXPECT_FALSE(set.contains(14));
+
+    EXPECT_TRUE(set.insert(14));
+    EXPECT_TRUE(set.insert(16));
+    EXPECT_EQ(3, set.size());
+    EXPECT_TRUE(set.contains(12));
+    EXPECT_TRUE(set.contains(14));
+    EXPECT_TRUE(set.contains(16));
+    EXPECT_FALSE(set.contains(15));
+}
+
+TEST(HashSet, Duplicates) {
+    HashSet<int> set;
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i == 0, set.insert(0));
+    }
+
+    EXPECT_EQ(1, set.size());
+    EXPECT_EQ(0, *set.begin());
+}
+
+TEST(HashSet, Tuples) {
+    HashSet<Entry> set;
+    const int N = 10000;
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.insert({i / 100, i % 100}));
+    }
+    for (int i = 0; i < N; i++) {
+        EXPECT_FALSE(set.insert({i / 100, i % 100}));
+    }
+
+    EXPECT_EQ(N, set.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.contains({i / 100, i % 100}));
+        EXPECT_FALSE(set.contains({i % 100, 100 + i / 100}));
+    }
+}
+
+TEST(HashSet, Iterator) {
+    HashSet<int> set;
+    const int N = 5000;
+
+    EXPECT_TRUE(set.begin() == set.end());
+
+    for (int i = N - 1; i >= 0; i--) {
+        set.insert(i);
+    }
+
+    // elements are enumerated in insertion order
+    int expected = N - 1;
+    for (int cur : set) {
+        EXPECT_EQ(expected, cur);
+        expected--;
+    }
+    EXPECT_EQ(-1, expected);
+}
+
+TEST(HashSet, Boundaries) {
+    HashSet<int> set;
+
+    for (int i = 0; i < 10; i += 2) {
+        set.insert(i);
+    }
+
+    for (int i = 0; i < 10; i++) {
+        auto a = set.lower_bound(i);
+        auto b = set.upper_bound(i);
+        if (i % 2 == 0) {
+            EXPECT_TRUE(a == set.find(i));
+            EXPECT_EQ(i, *a);
+            EXPECT_TRUE(++a == b);
+        } else {
+            EXPECT_TRUE(a == set.end());
+            EXPECT_TRUE(b == set.end());
+        }
+    }
+}
+
+TEST(HashSet, Clear) {
+    HashSet<int> set;
+
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i);
+    }
+    EXPECT_EQ(1000, set.size());
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(10));
+
+    EXPECT_TRUE(set.insert(10));
+    EXPECT_EQ(1, set.size());
+    EXPECT_TRUE(set.contains(10));
+}
+
+TEST(HashSet, Partition) {
+    HashSet<int> set;
+    EXPECT_TRUE(set.partition(10).empty());
+
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i);
+    }
+
+    for (std::size_t n : {1, 3, 10, 999, 1000, 5000}) {
+        auto chunks = set.partition(n);
+        EXPECT_TRUE(chunks.size() <= n);
+
+        int last = -1;
+        for (const auto& chunk : chunks) {
+            for (int cur : chunk) {
+                EXPECT_EQ(last + 1, cur);
+                last = cur;
+            }
+        }
+        EXPECT_EQ(999, last);
+    }
+}
+
+TEST(HashSet, Parallel) {
+    const int N = 10000;
+
+    std::vector<int> full;
+    for (int dup = 0; dup < 3; dup++) {
+        for (int i = 0; i < N; i++) {
+            full.push_back(i);
+        }
+    }
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(full.begin(), full.end(), generator);
+
+    HashSet<int> set;
+#pragma omp parallel for
+    for (std::size_t i = 0; i < full.size(); i++) {
+        set.insert(full[i]);
+    }
+
+    EXPECT_EQ(N, set.size());
+    std::set<int> is(set.begin(), set.end());
+    EXPECT_EQ(N, is.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(set.contains(i));
+    }
+}
+
+using time_point = std::chrono::high_resolution_clock::time_point;
+
+time_point now() {
+    return std::chrono::high_resolution_clock::now();
+}
+
+long duration(const time_point& start, const time_point& end) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+template <typename Op>
+long time(const std::string& name, const Op& operation) {
+    std::cout << "\t" << std::setw(30) << std::setiosflags(std::ios::left) << name
+              << std::resetiosflags(std::ios::left) << " ... " << std::flush;
+    auto a = now();
+    operation();
+    auto b = now();
+    long time = duration(a, b);
+    std::cout << " done [" << std::setw(5) << time << "ms]\n";
+    return time;
+}
+
+#define checkPerformance(set_type, name, in, out)                                      \
+    {                                                                                  \
+        std::cout << "Testing: " << name << " ..\n";                                   \
+        set_type set;                                                                  \
+        time("filling set", [&]() {                                                    \
+            for (const auto& cur : in) {                                               \
+                set.insert(cur);                                                       \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_EQ(in.size(), set.size());                                              \
+        int counter = 0;                                                               \
+        time("full scan", [&]() {                                                      \
+            for (auto it = set.begin(); it != set.end(); ++it) {                       \
+                counter++;                                                             \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_EQ(in.size(), (std::size_t)counter);                                    \
+        bool allPresent = true;                                                        \
+        time("membership in", [&]() {                                                  \
+            for (const auto& cur : in) {                                               \
+                allPresent = set.contains(cur) && allPresent;                          \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allPresent);                                                       \
+        bool allMissing = true;                                                        \
+        time("membership out", [&]() {                                                 \
+            for (const auto& cur : out) {                                              \
+                allMissing = !set.contains(cur) && allMissing;                         \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allMissing);                                                       \
+        bool allFound = true;                                                          \
+        time("equality ranges", [&]() {                                                \
+            for (const auto& cur : in) {                                               \
+                allFound = (set.lower_bound(cur) != set.upper_bound(cur)) && allFound; \
+            }                                                                          \
+        });                                                                            \
+        EXPECT_TRUE(allFound);                                                         \
+        std::cout << "\tDone!\n\n";                                                    \
+    }
+
+TEST(Performance, HashSetVsBTree) {
+    const int N = 1 << 18;
+
+    std::cout << "Generating Test-Data ...\n";
+    std::vector<Entry> in;
+    std::vector<Entry> out;
+    time("generating data", [&]() {
+        for (int i = 0; i < 2 * N; i++) {
+            Entry cur{i / 100, i % 100};
+            (i % 2 == 0 ? in : out).push_back(cur);
+        }
+        std::random_device rd;
+        std::mt19937 generator(rd());
+        std::shuffle(in.begin(), in.end(), generator);
+        std::shuffle(out.begin(), out.end(), generator);
+    });
+
+    using t1 = btree_set<Entry>;
+    checkPerformance(t1, "souffle btree_set", in, out);
+
+    using t2 = HashSet<Entry>;
+    checkPerformance(t2, "souffle hash set", in, out);
+}
+
+#ifdef _OPENMP
+
+TEST(HashSet, ParallelScaling) {
+    const int N = 1000;  // to not run to long for unit testing
+
+    std::vector<Entry> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back({i, N - i});
+    }
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::shuffle(data.begin(), data.end(), generator);
+
+    for (int i = 1; i <= 8; i++) {
+        HashSet<Entry> t;
+
+        omp_set_num_threads(i);
+
+        double start = omp_get_wtime();
+
+#pragma omp parallel for
+        for (int j = 0; j < N; j++) {
+            t.insert(data[j]);
+            t.insert(data[N - j - 1]);
+        }
+
+        double end = omp_get_wtime();
+
+        std::cout << "Number of threads: " << i << "[" << (end - start) << "ms]\n";
+
+        EXPECT_EQ(N, t.size());
+        for (const auto& cur : data) {
+            EXPECT_TRUE(t.contains(cur));
+        }
+    }
+}
+
+#endif
+}  // namespace souffle::test
@@ -0,0 +1,115 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file jsonl_reader_test.cpp
+ *
+ * Tests the stream reading JSON lines.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/ReadStreamJSONL.h"
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace souffle::test {
+
+/** Relation collecting the tuples that are read */
+struct Collector {
+    std::vector<std::vector<RamDomain>> tuples;
+    void insert(const RamDomain* tuple) {
+        tuples.push_back({tuple[0], tuple[1], tuple[2]});
+    }
+};
+
+/** IO directives of a relation r(x: symbol, y: Pair, z: List) */
+const std::map<std::string, std::string> directives{{"IO", "jsonl"}, {"name", "r"}, {"auxArity", "0"},
+        {"types", R"({"relation":{"arity":3,"auxArity":0,"types":["s:symbol","r:Pair","+:List"]},)"
+                  R"("records":{"r:Pair":{"arity":2,"types":["i:number","f:float"]}},)"
+                  R"("ADTs":{"+:List":{"arity":2,"enum":false,"branches":[)"
+                  R"({"name":"Cons","types":["u:unsigned","+:List"]},{"name":"Nil","types":[]}]}}})"},
+        {"params", R"({"relation":{"arity":3,"params":["x","y","z"]},)"
+                   R"("records":{"Pair":{"arity":2,"params":["a","b"]}}})"}};
+
+/** Read the tuples from the given text */
+Collector read(const std::string& text, SymbolTable& symbolTable, RecordTable& recordTable) {
+    std::stringstream in(text);
+    Collector relation;
+    ReadStreamJSONL(in, directives, symbolTable, recordTable).readAll(relation);
+    return relation;
+}
+
+/** Check that reading the given text fails */
+bool isMalformed(const std::string& text) {
+    SymbolTable symbolTable;
+    RecordTable recordTable;
+    try {
+        read(text, symbolTable, recordTable);
+    } catch (std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+TEST(JSONLines, Read) {
+    SymbolTable symbolTable;
+    RecordTable recordTable;
+    Collector relation = read(
+            "[\"a\\\"b\\u00e9\\ud83d\\ude00\", [-1, 2.5], {\"Cons\": [3, \"Nil\"]}]\n"
+            "\r\n"
+            "{\"z\": \"Nil\", \"x\": \"\", \"y\": {\"b\": 0.5, \"a\": 7}}\r\n"
+            "  [\"c\", null, {\"Nil\": []}]  \n",
+            symbolTable, recordTable);
+
+    EXPECT_EQ(3, relation.tuples.size());
+    EXPECT_EQ("a\"b\xc3\xa9\xf0\x9f\x98\x80", symbolTable.resolve(relation.tuples[0][0]));
+    const RamDomain* pair = recordTable.unpack(relation.tuples[0][1], 2);
+    EXPECT_EQ(-1, pair[0]);
+    EXPECT_EQ(2.5, ramBitCast<RamFloat>(pair[1]));
+    const RamDomain* cons = recordTable.unpack(relation.tuples[0][2], 2);
+    EXPECT_EQ(0, cons[0]);
+    const RamDomain* args = recordTable.unpack(cons[1], 2);
+    EXPECT_EQ(3, args[0]);
+    EXPECT_EQ(relation.tuples[1][2], args[1]);
+    EXPECT_EQ(1, recordTable.unpack(args[1], 2)[0]);
+
+    EXPECT_EQ("", symbolTable.resolve(relation.tuples[1][0]));
+    pair = recordTable.unpack(relation.tuples[1][1], 2);
+    EXPECT_EQ(7, pair[0]);
+    EXPECT_EQ(0.5, ramBitCast<RamFloat>(pair[1]));
+
+    EXPECT_EQ("c", symbolTable.resolve(relation.tuples[2][0]));
+    EXPECT_EQ(0, relation.tuples[2][1]);
+    EXPECT_EQ(relation.tuples[1][2], relation.tuples[2][2]);
+}
+
+TEST(JSONLines, Malformed) {
+    EXPECT_FALSE(isMalformed("[\"a\", null, \"Nil\"]"));
+    EXPECT_TRUE(isMalformed("[\"a\", null]"));
+    EXPECT_TRUE(isMalformed("[\"a\", null, \"Nil\"] x"));
+    EXPECT_TRUE(isMalformed("[\"a\", [1], \"Nil\"]"));
+    EXPECT_TRUE(isMalformed("[\"a\", [1, x], \"Nil\"]"));
+    EXPECT_TRUE(isMalformed("[\"a\", [1.5, 2], \"Nil\"]"));
+    EXPECT_TRUE(isMalformed("[\"a\", null, \"Cons\"]"));
+    EXPECT_TRUE(isMalformed("[\"a\", null, {\"Cons\": [-1, \"Nil\"]}]"));
+    EXPECT_TRUE(isMalformed("[\"a\\x\", null, \"Nil\"]"));
+    EXPECT_TRUE(isMalformed("{\"x\": \"a\", \"y\": null}"));
+    EXPECT_TRUE(isMalformed("{\"x\": \"a\", \"x\": \"a\", \"z\": \"Nil\"}"));
+    EXPECT_TRUE(isMalformed("{\"x\": \"a\", \"y\": null, \"w\": \"Nil\"}"));
+}
+
+}  // namespace souffle::test
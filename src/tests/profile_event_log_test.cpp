@@ -0,0 +1,179 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file profile_event_log_test.cpp
+ *
+ * Test cases for the binary profile event log.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/profile/EventLog.h"
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/utility/json11.h"
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace souffle::profile {
+
+namespace test {
+
+const std::string LOG_FILE = "profile_event_log_test.log";
+
+/** Return the number of tuples recorded for a relation, or -1 if there is none */
+long getNumTuples(const ProfileDatabase& db, const std::string& relation) {
+    const auto* entry = as<SizeEntry>(db.lookupEntry({"program", "relation", relation, "num-tuples"}));
+    return entry == nullptr ? -1 : static_cast<long>(entry->getSize());
+}
+
+TEST(EventLog, Replay) {
+    const std::size_t numThreads = 4;
+    // more events per thread than fit into its ring buffer
+    const std::size_t numEvents = 10000;
+
+    EventLog log;
+    EXPECT_TRUE(log.open(LOG_FILE));
+    log.record(EventLog::Kind::Config, "@config", {log.intern("key"), log.intern("value")});
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (std::size_t i = 0; i < numEvents; i++) {
+                std::string txt = "@n-nonrecursive-relation;r" + std::to_string(t) + "_" + std::to_string(i) +
+                                  ";loc;";
+                log.record(EventLog::Kind::Quantity, txt, {i, 0});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    log.close();
+    EXPECT_FALSE(log.isOpen());
+
+    EXPECT_TRUE(EventLog::isEventLog(LOG_FILE));
+    ProfileDatabase db;
+    EventLog::replay(LOG_FILE, db);
+
+    auto config = db.getStringMap({"program", "configuration"});
+    EXPECT_EQ(1, config.size());
+    EXPECT_EQ("value", config["key"]);
+    for (std::size_t t = 0; t < numThreads; t++) {
+        for (std::size_t i = 0; i < numEvents; i++) {
+            EXPECT_EQ(i, getNumTuples(db, "r" + std::to_string(t) + "_" + std::to_string(i)));
+        }
+    }
+
+    std::remove(LOG_FILE.c_str());
+}
+
+TEST(EventLog, TruncatedLog) {
+    EventLog log;
+    EXPECT_TRUE(log.open(LOG_FILE));
+    log.record(EventLog::Kind::Quantity, "@n-nonrecursive-relation;A;loc;", {1, 0});
+    log.record(EventLog::Kind::Quantity, "@n-nonrecursive-relation;B;loc;", {2, 0});
+    log.close();
+
+    // cut off the last record, as a crashed program would
+    std::string content;
+    {
+        std::ifstream in(LOG_FILE, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(LOG_FILE, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), content.size() - sizeof(EventLog::Event) / 2);
+    }
+
+    ProfileDatabase db;
+    EventLog::replay(LOG_FILE, db);
+    EXPECT_EQ(1, getNumTuples(db, "A"));
+    EXPECT_EQ(-1, getNumTuples(db, "B"));
+
+    std::remove(LOG_FILE.c_str());
+}
+
+TEST(EventLog, Counters) {
+    EventLog log;
+    EXPECT_TRUE(log.open(LOG_FILE));
+    const uint64_t names = log.intern("cycles,instructions,llc-misses,branch-misses");
+    log.record(EventLog::Kind::Counters, "@counters;@t-recursive-rule;A;0;loc;A(x) :- B(x).",
+            {10, 20, 3, 4, names});
+    log.record(EventLog::Kind::Counters, "@counters;@t-recursive-rule;A;1;loc;A(x) :- B(x).",
+            {5, 6, 7, 8, names});
+    log.record(EventLog::Kind::Counters, "@counters;@t-recursive-relation;A;loc", {100, 200, 30, 40, names});
+    log.close();
+
+    ProfileDatabase db;
+    EventLog::replay(LOG_FILE, db);
+
+    // counters of the versions of a rule are summed up
+    auto getCounter = [&](const std::vector<std::string>& path) {
+        const auto* entry = as<SizeEntry>(db.lookupEntry(path));
+        return entry == nullptr ? -1 : static_cast<long>(entry->getSize());
+    };
+    EXPECT_EQ(15, getCounter({"program", "relation", "A", "rule-counters", "A(x) :- B(x).", "cycles"}));
+    EXPECT_EQ(
+            12, getCounter({"program", "relation", "A", "rule-counters", "A(x) :- B(x).", "branch-misses"}));
+    EXPECT_EQ(200, getCounter({"program", "relation", "A", "counters", "instructions"}));
+    EXPECT_EQ(30, getCounter({"program", "relation", "A", "counters", "llc-misses"}));
+
+    std::remove(LOG_FILE.c_str());
+}
+
+TEST(EventLog, ExportTrace) {
+    EventLog log;
+    EXPECT_TRUE(log.open(LOG_FILE));
+    log.record(EventLog::Kind::Span, "@stratum;stratum_0", {100, 250, log.getThreadIndex()});
+    std::thread([&]() {
+        log.record(EventLog::Kind::Span, "@parallel", {120, 200, log.getThreadIndex()});
+    }).join();
+    log.record(EventLog::Kind::Quantity, "@n-nonrecursive-relation;A;loc;", {1, 0});
+    log.close();
+
+    std::stringstream trace;
+    EventLog::exportTrace(LOG_FILE, trace);
+    std::string err;
+    auto json = json11::Json::parse(trace.str(), err);
+    EXPECT_TRUE(err.empty());
+
+    // spans of two threads, each preceded by the name of its thread
+    const auto& events = json["traceEvents"].array_items();
+    EXPECT_EQ(4, events.size());
+    EXPECT_EQ("M", events[0]["ph"].string_value());
+    EXPECT_EQ("main", events[0]["args"]["name"].string_value());
+    EXPECT_EQ("stratum_0", events[1]["name"].string_value());
+    EXPECT_EQ("stratum", events[1]["cat"].string_value());
+    EXPECT_EQ(100, events[1]["ts"].int_value());
+    EXPECT_EQ(150, events[1]["dur"].int_value());
+    EXPECT_EQ(0, events[1]["tid"].int_value());
+    EXPECT_EQ("parallel", events[3]["name"].string_value());
+    EXPECT_EQ(80, events[3]["dur"].int_value());
+    EXPECT_EQ(1, events[3]["tid"].int_value());
+
+    std::remove(LOG_FILE.c_str());
+}
+
+TEST(EventLog, NotAnEventLog) {
+    {
+        std::ofstream out(LOG_FILE);
+        out << "{\n}\n";
+    }
+    EXPECT_FALSE(EventLog::isEventLog(LOG_FILE));
+    std::remove(LOG_FILE.c_str());
+}
+
+}  // end namespace test
+}  // namespace souffle::profile
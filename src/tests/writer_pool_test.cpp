@@ -0,0 +1,119 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2021, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file writer_pool_test.cpp
+ *
+ * Tests writing output relations in the background.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/io/WriterPool.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+
+namespace souffle::test {
+
+TEST(WriterPool, Wait) {
+    std::atomic<int> a(0);
+    std::atomic<int> b(0);
+    WriterPool writers(2);
+    std::map<std::string, std::string> directive{{"IO", "file"}};
+    writers.write(&a, directive, [&](bool) { a++; });
+    writers.write(&a, directive, [&](bool) { a++; });
+    writers.write(&b, directive, [&](bool) { b++; });
+
+    // waiting for a relation finishes all of its outputs
+    writers.wait(&a);
+    EXPECT_EQ(2, a);
+
+    writers.waitAll();
+    EXPECT_EQ(1, b);
+
+    // nothing is left to wait for
+    writers.wait(&a);
+    writers.waitAll();
+    EXPECT_EQ(2, a);
+}
+
+TEST(WriterPool, SameTarget) {
+    // outputs to the same database are written one after another
+    std::atomic<int> active(0);
+    std::atomic<bool> overlap(false);
+    int relations[4];
+    WriterPool writers(4);
+    for (int& relation : relations) {
+        writers.write(&relation, {{"IO", "sqlite"}, {"dbname", "shared.db"}}, [&](bool) {
+            if (active++ > 0) {
+                overlap = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            active--;
+        });
+    }
+    writers.waitAll();
+    EXPECT_FALSE(overlap);
+}
+
+TEST(WriterPool, Bounded) {
+    // no more outputs are written at the same time than there are jobs
+    std::atomic<int> active(0);
+    std::atomic<int> most(0);
+    int relations[16];
+    WriterPool writers(3);
+    for (int& relation : relations) {
+        writers.write(&relation, {{"IO", "file"}}, [&](bool) {
+            int now = ++active;
+            int seen = most;
+            while (now > seen && !most.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            active--;
+        });
+    }
+    writers.waitAll();
+    EXPECT_TRUE(most <= 3);
+    EXPECT_TRUE(most > 1);
+}
+
+TEST(WriterPool, SingleJob) {
+    // with a single job outputs are written immediately
+    int value = 0;
+    bool concurrent = true;
+    WriterPool writers(1);
+    EXPECT_EQ(1, writers.getNumThreads());
+    writers.write(&value, {{"IO", "file"}}, [&](bool c) {
+        value = 1;
+        concurrent = c;
+    });
+    EXPECT_EQ(1, value);
+    EXPECT_FALSE(concurrent);
+}
+
+TEST(WriterPool, Terminal) {
+    // outputs to the terminal are written immediately and keep their order
+    int value = 0;
+    bool concurrent = true;
+    WriterPool writers(4);
+    writers.write(&value, {{"IO", "stdout"}}, [&](bool c) {
+        value = 1;
+        concurrent = c;
+    });
+    EXPECT_EQ(1, value);
+    EXPECT_FALSE(concurrent);
+    writers.write(&value, {{"IO", "stdoutprintsize"}}, [&](bool) { value = 2; });
+    EXPECT_EQ(2, value);
+}
+
+}  // namespace souffle::test